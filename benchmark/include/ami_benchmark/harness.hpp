@@ -0,0 +1,203 @@
+#pragma once
+
+#include <chrono>
+#include <concepts>
+#include <cstddef>
+#include <cstdio>
+#include <ctime>
+#include <execution>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "ami/concepts/execution_policy.hpp"
+
+// Minimal harness shared by the benchmark executables. Every case is run
+// until min_time has elapsed and reported as time per iteration, GFLOP/s and
+// bytes/s, either as a console table or, with --json, in the layout of
+// Google Benchmark's JSON reporter so existing tooling can track it.
+//
+// Options: --json, --filter=<substring>, --min-time-ms=<n>
+
+namespace ami::benchmark {
+
+  // Sizes swept by every layer benchmark.
+  inline constexpr std::tuple sizes{
+      std::integral_constant<std::size_t, 8>{},
+      std::integral_constant<std::size_t, 64>{},
+      std::integral_constant<std::size_t, 512>{},
+      std::integral_constant<std::size_t, 4096>{}};
+
+  inline constexpr std::tuple policies{
+      std::execution::seq, std::execution::par, std::execution::par_unseq,
+      execution::adaptive, execution::pool};
+
+  inline constexpr std::tuple<float, double> real_types{};
+
+  // Calls f(x) for every element x of the tuple t.
+  template <class Tuple, class F>
+  constexpr void sweep(const Tuple& t, F&& f) {
+    std::apply([&](const auto&... x) { (f(x), ...); }, t);
+  }
+
+  template <std::floating_point RealType>
+  constexpr std::string_view type_name() noexcept {
+    if constexpr (std::same_as<RealType, float>) {
+      return "float";
+    } else if constexpr (std::same_as<RealType, double>) {
+      return "double";
+    } else {
+      return "long double";
+    }
+  }
+
+  template <execution_policy auto P>
+  constexpr std::string_view policy_name() noexcept {
+    using policy_type = std::remove_cvref_t<decltype(P)>;
+    if constexpr (std::same_as<policy_type, std::execution::sequenced_policy>) {
+      return "seq";
+    } else if constexpr (
+        std::same_as<policy_type, std::execution::parallel_policy>) {
+      return "par";
+    } else if constexpr (std::same_as<
+        policy_type, std::execution::parallel_unsequenced_policy>) {
+      return "par_unseq";
+    } else if constexpr (adaptive_policy<P>) {
+      return "adaptive";
+    } else if constexpr (pool_policy<P>) {
+      return "pool";
+    } else {
+      return "unseq";
+    }
+  }
+
+  // Keeps the compiler from discarding a result nobody reads.
+  template <class T>
+  inline void do_not_optimize(const T& value) noexcept {
+    asm volatile("" : : "r"(&value) : "memory");
+  }
+
+  struct case_type final {
+    std::string_view family;
+    std::string_view real_type;
+    std::string_view policy;
+    std::size_t      size;
+    double           flops;  // floating point operations per iteration
+    double           bytes;  // bytes read plus written per iteration
+  };
+
+  class harness final {
+  public:
+    using clock = std::chrono::steady_clock;
+
+    // Constructor
+    harness(int argc, char** argv) {
+      for (int i = 1; i < argc; ++i) {
+        const std::string_view arg{argv[i]};
+        if (arg == "--json") {
+          json_ = true;
+        } else if (arg.starts_with("--filter=")) {
+          filter_ = arg.substr(9);
+        } else if (arg.starts_with("--min-time-ms=")) {
+          min_time_ = std::chrono::milliseconds{
+              std::stoll(std::string{arg.substr(14)})};
+        } else {
+          std::fprintf(stderr, "unknown option: %s\n", argv[i]);
+        }
+      }
+    }
+
+    harness(const harness&) = delete;
+    harness& operator=(const harness&) = delete;
+
+    ~harness() {
+      if (json_) {
+        print_json();
+      }
+    }
+
+    // Public Methods
+    template <class F>
+    void run(const case_type& c, F&& f) {
+      auto name = std::string{c.family} + '/' + std::string{c.real_type} +
+          '/' + std::string{c.policy} + '/' + std::to_string(c.size);
+      if (name.find(filter_) == std::string::npos) {
+        return;
+      }
+
+      f();
+      std::size_t iterations = 0;
+      const auto start = clock::now();
+      auto elapsed = clock::duration{};
+      do {
+        f();
+        ++iterations;
+        elapsed = clock::now() - start;
+      } while (elapsed < min_time_);
+
+      const auto seconds = std::chrono::duration<double>(elapsed).count() /
+          static_cast<double>(iterations);
+      result_type result{std::move(name), c, iterations, seconds};
+      if (!json_) {
+        std::printf("%-48s %12.1f ns %10.3f GFLOP/s %10.3f GB/s\n",
+            result.name.c_str(), seconds * 1e9, c.flops / seconds * 1e-9,
+            c.bytes / seconds * 1e-9);
+        std::fflush(stdout);
+      }
+      results_.push_back(std::move(result));
+    }
+
+  private:
+    struct result_type final {
+      std::string name;
+      case_type   c;
+      std::size_t iterations;
+      double      seconds;
+    };
+
+    // Private Methods
+    void print_json() const {
+      char date[32]{};
+      const auto now = std::time(nullptr);
+      std::strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%S",
+          std::localtime(&now));
+
+      std::printf("{\n  \"context\": {\n    \"date\": \"%s\",\n"
+                  "    \"num_cpus\": %u,\n    \"library\": \"ami\"\n  },\n"
+                  "  \"benchmarks\": [", date,
+                  std::thread::hardware_concurrency());
+      for (std::size_t i = 0; i < results_.size(); ++i) {
+        const auto& [name, c, iterations, seconds] = results_[i];
+        std::printf("%s\n    {\n"
+                    "      \"name\": \"%s\",\n"
+                    "      \"family\": \"%.*s\",\n"
+                    "      \"real_type\": \"%.*s\",\n"
+                    "      \"policy\": \"%.*s\",\n"
+                    "      \"size\": %zu,\n"
+                    "      \"iterations\": %zu,\n"
+                    "      \"real_time\": %.6g,\n"
+                    "      \"time_unit\": \"ns\",\n"
+                    "      \"flops_per_second\": %.6g,\n"
+                    "      \"bytes_per_second\": %.6g\n"
+                    "    }",
+                    (i == 0) ? "" : ",", name.c_str(),
+                    static_cast<int>(c.family.size()), c.family.data(),
+                    static_cast<int>(c.real_type.size()), c.real_type.data(),
+                    static_cast<int>(c.policy.size()), c.policy.data(),
+                    c.size, iterations, seconds * 1e9, c.flops / seconds,
+                    c.bytes / seconds);
+      }
+      std::printf("\n  ]\n}\n");
+    }
+
+    // Private Members
+    bool                      json_{false};
+    std::string               filter_{};
+    clock::duration           min_time_{std::chrono::milliseconds{200}};
+    std::vector<result_type>  results_{};
+  };
+}
@@ -0,0 +1,68 @@
+#include "ami/kernel/gemm.hpp"
+
+#include <cstddef>
+#include <numeric>
+#include <vector>
+
+#include "ami_benchmark/harness.hpp"
+
+using namespace ami::benchmark;
+
+// Compares the blocked kernels with the per-node transform_reduce path that
+// dense_layer used before they existed. Batch 1 runs gemv, larger batches
+// gemm.
+
+template <std::floating_point RealType, ami::execution_policy auto P>
+void run(harness& h, std::size_t size, std::size_t batch) {
+  const auto type = type_name<RealType>();
+  const auto policy = policy_name<P>();
+  const auto family = (batch == 1) ? "gemv" : "gemm_batch64";
+  const auto reference_family =
+      (batch == 1) ? "gemv_reference" : "gemm_batch64_reference";
+
+  std::vector<RealType> w(size * size, RealType{0.5});
+  std::vector<RealType> x(batch * size, RealType{0.25});
+  std::vector<RealType> y(batch * size);
+
+  const auto flops = 2.0 * static_cast<double>(batch * size * size);
+  const auto bytes = static_cast<double>(
+      (size * size + 2 * batch * size) * sizeof(RealType));
+
+  if constexpr (ami::sequenced_policy<P>) {
+    h.run({reference_family, type, policy, size, flops, bytes}, [&] {
+      for (std::size_t b = 0; b < batch; ++b) {
+        for (std::size_t i = 0; i < size; ++i) {
+          y[b * size + i] = std::transform_reduce(
+              w.begin() + i * size, w.begin() + (i + 1) * size,
+              x.begin() + b * size, RealType{});
+        }
+      }
+      do_not_optimize(y);
+    });
+  }
+
+  h.run({family, type, policy, size, flops, bytes}, [&] {
+    if (batch == 1) {
+      ami::kernel::gemv<P>(size, size, w.data(), size, x.data(), y.data());
+    } else {
+      ami::kernel::gemm<P>(batch, size, size,
+          ami::kernel::row_major(x.data(), size),
+          ami::kernel::col_major(w.data(), size),
+          ami::kernel::row_major(y.data(), size));
+    }
+    do_not_optimize(y);
+  });
+}
+
+int main(int argc, char** argv) {
+  harness h{argc, argv};
+  sweep(real_types, [&]<class RealType>(RealType) {
+    sweep(policies, [&]<class Policy>(Policy) {
+      for (std::size_t batch : {1, 64}) {
+        for (std::size_t size : {64, 256, 1024, 2048}) {
+          run<RealType, Policy{}>(h, size, batch);
+        }
+      }
+    });
+  });
+}
@@ -0,0 +1,57 @@
+#include "ami/layer/activation_layer.hpp"
+
+#include "ami/activation/relu.hpp"
+#include "ami/activation/sigmoid.hpp"
+
+#include <cstddef>
+#include <memory>
+#include <string_view>
+
+#include "ami_benchmark/harness.hpp"
+
+using namespace ami::benchmark;
+
+// Families are named after the activation; exp counts as one operation.
+template <class F, std::floating_point RealType, std::size_t Size,
+          ami::execution_policy auto P>
+void run(harness& h, std::string_view forward, std::string_view backward) {
+  using layer_t = ami::activation_layer_t<RealType, Size, F>;
+  constexpr auto n = static_cast<double>(Size);
+  constexpr auto word = static_cast<double>(sizeof(RealType));
+  const auto type = type_name<RealType>();
+  const auto policy = policy_name<P>();
+
+  auto input = std::make_unique<typename layer_t::input_type>();
+  input->fill(RealType{0.25});
+  auto delta = std::make_unique<typename layer_t::delta_type>();
+  delta->fill(RealType{0.5});
+  auto output = std::make_unique<typename layer_t::forward_type>();
+
+  h.run({forward, type, policy, Size, 3 * n,
+         2 * n * word}, [&] {
+    layer_t::template forward<P>(*input, *output);
+    do_not_optimize(*output);
+  });
+  h.run({backward, type, policy, Size, 6 * n,
+         3 * n * word}, [&] {
+    layer_t::template backward<P>(*input, *delta, *output);
+    do_not_optimize(*output);
+  });
+}
+
+int main(int argc, char** argv) {
+  harness h{argc, argv};
+  sweep(real_types, [&]<class RealType>(RealType) {
+    sweep(sizes, [&](auto size) {
+      sweep(policies, [&]<class Policy>(Policy) {
+        run<ami::sigmoid<>, RealType, size(), Policy{}>(h,
+            "activation_layer/forward", "activation_layer/backward");
+        run<ami::sigmoid<ami::precision::fast>, RealType, size(), Policy{}>(
+            h, "activation_layer/fast_sigmoid/forward",
+            "activation_layer/fast_sigmoid/backward");
+        run<ami::relu, RealType, size(), Policy{}>(h,
+            "activation_layer/relu/forward", "activation_layer/relu/backward");
+      });
+    });
+  });
+}
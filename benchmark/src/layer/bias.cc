@@ -0,0 +1,58 @@
+#include "ami/layer/component/bias.hpp"
+
+#include <array>
+#include <cstddef>
+#include <memory>
+#include <ranges>
+
+#include "ami/optimizer/adam.hpp"
+#include "ami/utility/parallel_algorithm.hpp"
+#include "ami_benchmark/harness.hpp"
+
+using namespace ami::benchmark;
+
+// A bias is a single scalar, so each case drives Size of them the way
+// dense_layer does, through for_each over the outputs.
+template <std::floating_point RealType, std::size_t Size,
+          ami::execution_policy auto P>
+void run(harness& h) {
+  using bias_t = ami::bias<RealType>;
+  constexpr auto n = static_cast<double>(Size);
+  constexpr auto word = static_cast<double>(sizeof(RealType));
+  const auto type = type_name<RealType>();
+  const auto policy = policy_name<P>();
+  const auto indices = std::views::iota(std::size_t{}, Size);
+
+  std::array<bias_t, Size> biases{};
+  std::array<RealType, Size> delta{};
+  delta.fill(RealType{0.5});
+  std::array<RealType, Size> gradient{};
+  auto optimizer = std::make_unique<std::array<
+      typename bias_t::template optimizer_type<ami::adam_t<RealType>>,
+      Size>>();
+
+  h.run({"bias/calc_gradient", type, policy, Size, n, 3 * n * word}, [&] {
+    ami::utility::for_each<P>(indices, [&](auto i) {
+          bias_t::template calc_gradient<P>(delta[i], gradient[i]);
+        });
+    do_not_optimize(gradient);
+  });
+  h.run({"bias/update_adam", type, policy, Size, 12 * n, 8 * n * word},
+      [&] {
+        ami::utility::for_each<P>(indices, [&](auto i) {
+              biases[i].update((*optimizer)[i], gradient[i]);
+            });
+        do_not_optimize(biases);
+      });
+}
+
+int main(int argc, char** argv) {
+  harness h{argc, argv};
+  sweep(real_types, [&]<class RealType>(RealType) {
+    sweep(sizes, [&](auto size) {
+      sweep(policies, [&]<class Policy>(Policy) {
+        run<RealType, size(), Policy{}>(h);
+      });
+    });
+  });
+}
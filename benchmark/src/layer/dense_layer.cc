@@ -0,0 +1,143 @@
+#include "ami/layer/dense_layer.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <vector>
+
+#include "ami/optimizer/adam.hpp"
+#include "ami/optimizer/fused_adam.hpp"
+#include "ami_benchmark/harness.hpp"
+
+using namespace ami::benchmark;
+
+// Square Size x Size layers.
+template <std::floating_point RealType, std::size_t Size,
+          ami::execution_policy auto P>
+void run(harness& h) {
+  using layer_t = ami::dense_layer_t<RealType, Size, Size>;
+  constexpr auto n = static_cast<double>(Size);
+  constexpr auto word = static_cast<double>(sizeof(RealType));
+  constexpr auto parameters = n * n + n;
+  const auto type = type_name<RealType>();
+  const auto policy = policy_name<P>();
+
+  auto layer = std::make_unique<layer_t>();
+  auto input = std::make_unique<typename layer_t::input_type>();
+  input->fill(RealType{0.25});
+  auto delta = std::make_unique<typename layer_t::delta_type>();
+  delta->fill(RealType{0.5});
+  auto output = std::make_unique<typename layer_t::forward_type>();
+  auto backward = std::make_unique<typename layer_t::backward_type>();
+  auto gradient = std::make_unique<typename layer_t::gradient_type>();
+
+  h.run({"dense_layer/forward", type, policy, Size, 2 * n * n,
+         (n * n + 3 * n) * word}, [&] {
+    layer->template forward<P>(*input, *output);
+    do_not_optimize(*output);
+  });
+  h.run({"dense_layer/backward", type, policy, Size, 2 * n * n,
+         (n * n + 2 * n) * word}, [&] {
+    layer->template backward<P>(*delta, *backward);
+    do_not_optimize(*backward);
+  });
+  h.run({"dense_layer/calc_gradient", type, policy, Size, 2 * n * n,
+         (2 * n * n + 4 * n) * word}, [&] {
+    layer_t::template calc_gradient<P>(*input, *delta, *gradient);
+    do_not_optimize(*gradient);
+  });
+
+  auto fused = std::make_unique<
+      typename layer_t::template optimizer_type<ami::fused_adam<>>>();
+  h.run({"dense_layer/update_fused_adam", type, policy, Size,
+         12 * parameters, 7 * parameters * word}, [&] {
+    layer->template update<P>(*fused, *gradient);
+    do_not_optimize(*layer);
+  });
+
+  // Four scalars of state per weight; skipped where that no longer fits
+  // comfortably in memory.
+  if constexpr (Size <= 1024) {
+    auto adam = std::make_unique<typename layer_t::template
+        optimizer_type<ami::adam_t<RealType>>>();
+    h.run({"dense_layer/update_adam", type, policy, Size, 12 * parameters,
+           11 * parameters * word}, [&] {
+      layer->template update<P>(*adam, *gradient);
+      do_not_optimize(*layer);
+    });
+  }
+}
+
+// A wide layer over sparse inputs, Active of its Inputs features set, as a
+// ranking model's feature crosses; the dense forward is the baseline.
+template <std::floating_point RealType, ami::execution_policy auto P>
+void run_sparse(harness& h) {
+  constexpr std::size_t inputs = 65536;
+  constexpr std::size_t outputs = 64;
+  constexpr std::size_t active = 256;
+  using layer_t = ami::dense_layer_t<RealType, inputs, outputs>;
+  using feature_t = typename layer_t::feature_type;
+  constexpr auto n = static_cast<double>(outputs);
+  constexpr auto k = static_cast<double>(active);
+  constexpr auto word = static_cast<double>(sizeof(RealType));
+  const auto type = type_name<RealType>();
+  const auto policy = policy_name<P>();
+
+  auto layer = std::make_unique<layer_t>();
+  std::vector<feature_t> features(active);
+  auto input = std::make_unique<typename layer_t::input_type>();
+  for (std::size_t k = 0; k < active; ++k) {
+    features[k] = {static_cast<std::uint32_t>(k * 251 % inputs), 1};
+    (*input)[features[k].index] = 1;
+  }
+  auto delta = std::make_unique<typename layer_t::delta_type>();
+  delta->fill(RealType{0.5});
+  auto output = std::make_unique<typename layer_t::forward_type>();
+
+  h.run({"dense_layer/forward_wide", type, policy, inputs,
+         2 * n * inputs, (n * inputs + inputs + 2 * n) * word}, [&] {
+    layer->template forward<P>(*input, *output);
+    do_not_optimize(*output);
+  });
+  h.run({"dense_layer/forward_sparse", type, policy, inputs, 2 * n * k,
+         (n * k + k + 2 * n) * word}, [&] {
+    layer->template forward<P>(std::span<const feature_t>{features},
+        *output);
+    do_not_optimize(*output);
+  });
+
+  typename layer_t::sparse_gradient_type gradient{};
+  h.run({"dense_layer/calc_gradient_sparse", type, policy, inputs,
+         2 * n * k, (n * k + k + n) * word}, [&] {
+    gradient = {};
+    layer_t::template calc_gradient<P>(
+        std::span<const feature_t>{features}, *delta, gradient);
+    do_not_optimize(gradient);
+  });
+
+  gradient = {};
+  layer_t::calc_gradient(std::span<const feature_t>{features}, *delta,
+      gradient);
+  auto fused = std::make_unique<
+      typename layer_t::template optimizer_type<ami::fused_adam<>>>();
+  h.run({"dense_layer/update_lazy_adam", type, policy, inputs,
+         12 * (n * k + n), 7 * (n * k + n) * word}, [&] {
+    layer->template update<P>(*fused, gradient);
+    do_not_optimize(*layer);
+  });
+}
+
+int main(int argc, char** argv) {
+  harness h{argc, argv};
+  sweep(real_types, [&]<class RealType>(RealType) {
+    sweep(sizes, [&](auto size) {
+      sweep(policies, [&]<class Policy>(Policy) {
+        run<RealType, size(), Policy{}>(h);
+      });
+    });
+    sweep(policies, [&]<class Policy>(Policy) {
+      run_sparse<RealType, Policy{}>(h);
+    });
+  });
+}
@@ -0,0 +1,63 @@
+#include "ami/layer/dropout_layer.hpp"
+
+#include <cstddef>
+#include <memory>
+#include <random>
+
+#include "ami_benchmark/harness.hpp"
+
+using namespace ami::benchmark;
+
+template <std::floating_point RealType, std::size_t Size,
+          ami::execution_policy auto P>
+void run(harness& h) {
+  using layer_t = ami::dropout_layer_t<RealType, Size, 0.5>;
+  constexpr auto n = static_cast<double>(Size);
+  constexpr auto word = static_cast<double>(sizeof(RealType));
+  const auto type = type_name<RealType>();
+  const auto policy = policy_name<P>();
+
+  std::mt19937 engine{42};
+  ami::utility::philox philox{42};
+  auto input = std::make_unique<typename layer_t::input_type>();
+  input->fill(RealType{0.25});
+  auto delta = std::make_unique<typename layer_t::delta_type>();
+  delta->fill(RealType{0.5});
+  auto output = std::make_unique<typename layer_t::forward_type>();
+  auto backward = std::make_unique<typename layer_t::backward_type>();
+  auto mask = std::make_unique<typename layer_t::mask_type>(
+      layer_t::template make_mask<P>(philox));
+
+  // One bernoulli draw per unit, counted as an operation.
+  h.run({"dropout_layer/make_mask/mt19937", type, policy, Size, n, n / 8},
+      [&] {
+        *mask = layer_t::template make_mask<P>(engine);
+        do_not_optimize(*mask);
+      });
+  h.run({"dropout_layer/make_mask/philox", type, policy, Size, n, n / 8},
+      [&] {
+        *mask = layer_t::template make_mask<P>(philox);
+        do_not_optimize(*mask);
+      });
+  h.run({"dropout_layer/forward", type, policy, Size, n,
+         2 * n * word + n / 8}, [&] {
+    layer_t::template forward<P>(*input, *output, *mask);
+    do_not_optimize(*output);
+  });
+  h.run({"dropout_layer/backward", type, policy, Size, n,
+         2 * n * word + n / 8}, [&] {
+    layer_t::template backward<P>(*mask, *delta, *backward);
+    do_not_optimize(*backward);
+  });
+}
+
+int main(int argc, char** argv) {
+  harness h{argc, argv};
+  sweep(real_types, [&]<class RealType>(RealType) {
+    sweep(sizes, [&](auto size) {
+      sweep(policies, [&]<class Policy>(Policy) {
+        run<RealType, size(), Policy{}>(h);
+      });
+    });
+  });
+}
@@ -0,0 +1,53 @@
+#include "ami/layer/dynamic_dense_layer.hpp"
+
+#include <cstddef>
+#include <vector>
+
+#include "ami_benchmark/harness.hpp"
+
+using namespace ami::benchmark;
+
+// Square size x size layers with the shape chosen at run time; the families
+// match dense_layer so the two can be compared directly.
+template <std::floating_point RealType, ami::execution_policy auto P>
+void run(harness& h, std::size_t size) {
+  using layer_t = ami::dynamic_dense_layer<RealType>;
+  const auto n = static_cast<double>(size);
+  constexpr auto word = static_cast<double>(sizeof(RealType));
+  const auto type = type_name<RealType>();
+  const auto policy = policy_name<P>();
+
+  layer_t layer{size, size};
+  const std::vector<RealType> input(size, RealType{0.25});
+  const std::vector<RealType> delta(size, RealType{0.5});
+  std::vector<RealType> output(size);
+  std::vector<RealType> backward(size);
+  auto gradient = layer.make_gradient();
+
+  h.run({"dynamic_dense_layer/forward", type, policy, size, 2 * n * n,
+         (n * n + 3 * n) * word}, [&] {
+    layer.template forward<P>(input, output);
+    do_not_optimize(output);
+  });
+  h.run({"dynamic_dense_layer/backward", type, policy, size, 2 * n * n,
+         (n * n + 2 * n) * word}, [&] {
+    layer.template backward<P>(delta, backward);
+    do_not_optimize(backward);
+  });
+  h.run({"dynamic_dense_layer/calc_gradient", type, policy, size, 2 * n * n,
+         (2 * n * n + 4 * n) * word}, [&] {
+    layer.template calc_gradient<P>(input, delta, gradient);
+    do_not_optimize(gradient);
+  });
+}
+
+int main(int argc, char** argv) {
+  harness h{argc, argv};
+  sweep(real_types, [&]<class RealType>(RealType) {
+    sweep(sizes, [&](auto size) {
+      sweep(policies, [&]<class Policy>(Policy) {
+        run<RealType, Policy{}>(h, size());
+      });
+    });
+  });
+}
@@ -0,0 +1,88 @@
+#include "ami/layer/embedding_layer.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <span>
+#include <vector>
+
+#include "ami/optimizer/fused_adam.hpp"
+#include "ami_benchmark/harness.hpp"
+
+using namespace ami::benchmark;
+
+constexpr auto sgd = [](auto& x, auto y) {
+  x -= decltype(y){0.01} * y;
+};
+
+// A table of a million rows of 64 values and batches of 256 samples of 26
+// ids, half of them drawn from a few hundred popular rows, so rows repeat
+// within a batch as in click logs.
+template <std::floating_point RealType>
+void run(harness& h) {
+  constexpr std::size_t vocabulary = std::size_t{1} << 20;
+  constexpr std::size_t features = 26;
+  constexpr std::size_t dimension = 64;
+  constexpr std::size_t batch = 256;
+  using layer_t = ami::embedding_layer_t<RealType, features, dimension>;
+  constexpr auto lookups = static_cast<double>(batch * features);
+  constexpr auto row = static_cast<double>(dimension * sizeof(RealType));
+  const auto type = type_name<RealType>();
+
+  layer_t layer{vocabulary};
+  std::mt19937 engine{42};
+  std::uniform_int_distribution<std::uint32_t> any{0, vocabulary - 1};
+  std::uniform_int_distribution<std::uint32_t> popular{0, 511};
+  std::vector<typename layer_t::input_type> input(batch);
+  for (auto& x : input) {
+    for (std::size_t k = 0; k < features; ++k) {
+      x[k] = k % 2 == 0 ? any(engine) : popular(engine);
+    }
+  }
+  std::vector<typename layer_t::delta_type> delta(batch);
+  for (auto& d : delta) {
+    d.fill(RealType{0.5});
+  }
+  std::vector<typename layer_t::forward_type> output(batch);
+
+  typename layer_t::gradient_type gradient{};
+  layer_t::calc_gradient(std::span{input}, std::span{delta}, gradient);
+  auto scalar = layer.template make_optimizer<
+      std::remove_const_t<decltype(sgd)>>();
+  auto adam = layer.template make_optimizer<ami::fused_adam<>>();
+
+  sweep(policies, [&]<class Policy>(Policy) {
+    constexpr Policy P{};
+    const auto policy = policy_name<P>();
+
+    h.run({"embedding_layer/forward", type, policy, vocabulary, 0,
+           2 * lookups * row}, [&] {
+      layer.template forward<P>(std::span{input}, std::span{output});
+      do_not_optimize(output);
+    });
+    h.run({"embedding_layer/calc_gradient", type, policy, vocabulary, 0,
+           2 * lookups * row}, [&] {
+      typename layer_t::gradient_type result{};
+      layer_t::template calc_gradient<P>(
+          std::span{input}, std::span{delta}, result);
+      do_not_optimize(result);
+    });
+    h.run({"embedding_layer/update_sgd", type, policy, vocabulary,
+           3 * lookups * dimension, 3 * lookups * row}, [&] {
+      layer.template update<P>(scalar, gradient);
+      do_not_optimize(layer);
+    });
+    h.run({"embedding_layer/update_lazy_adam", type, policy, vocabulary,
+           13 * lookups * dimension, 7 * lookups * row}, [&] {
+      layer.template update<P>(adam, gradient);
+      do_not_optimize(layer);
+    });
+  });
+}
+
+int main(int argc, char** argv) {
+  harness h{argc, argv};
+  sweep(real_types, [&]<class RealType>(RealType) {
+    run<RealType>(h);
+  });
+}
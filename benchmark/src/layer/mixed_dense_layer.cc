@@ -0,0 +1,73 @@
+#include "ami/layer/mixed_dense_layer.hpp"
+
+#include <cstddef>
+#include <memory>
+#include <string_view>
+#include <tuple>
+
+#include "ami/optimizer/fused_adam.hpp"
+#include "ami/utility/half_precision.hpp"
+#include "ami_benchmark/harness.hpp"
+
+using namespace ami::benchmark;
+
+template <ami::half_precision Storage>
+constexpr std::string_view storage_name() noexcept {
+  return std::same_as<Storage, ami::bfloat16> ? "bfloat16" : "float16";
+}
+
+// Square Size x Size float layers with 16 bit working weights; compare with
+// dense_layer/forward and dense_layer/backward on float.
+template <ami::half_precision Storage, std::size_t Size,
+          ami::execution_policy auto P>
+void run(harness& h) {
+  using layer_t = ami::mixed_dense_layer_t<float, Size, Size, Storage>;
+  constexpr auto n = static_cast<double>(Size);
+  constexpr auto word = static_cast<double>(sizeof(float));
+  constexpr auto half = static_cast<double>(sizeof(Storage));
+  constexpr auto parameters = n * n + n;
+  const auto type = storage_name<Storage>();
+  const auto policy = policy_name<P>();
+
+  auto layer = std::make_unique<layer_t>();
+  auto input = std::make_unique<typename layer_t::input_type>();
+  input->fill(0.25f);
+  auto delta = std::make_unique<typename layer_t::delta_type>();
+  delta->fill(0.5f);
+  auto output = std::make_unique<typename layer_t::forward_type>();
+  auto backward = std::make_unique<typename layer_t::backward_type>();
+  auto gradient = std::make_unique<typename layer_t::gradient_type>();
+
+  h.run({"mixed_dense_layer/forward", type, policy, Size, 2 * n * n,
+         n * n * half + 3 * n * word}, [&] {
+    layer->template forward<P>(*input, *output);
+    do_not_optimize(*output);
+  });
+  h.run({"mixed_dense_layer/backward", type, policy, Size, 2 * n * n,
+         n * n * half + 2 * n * word}, [&] {
+    layer->template backward<P>(*delta, *backward);
+    do_not_optimize(*backward);
+  });
+
+  // The master update plus rounding into the working copy.
+  auto fused = std::make_unique<
+      typename layer_t::template optimizer_type<ami::fused_adam<>>>();
+  h.run({"mixed_dense_layer/update_fused_adam", type, policy, Size,
+         12 * parameters, 7 * parameters * word + n * n * (word + half)},
+      [&] {
+        layer->template update<P>(*fused, *gradient);
+        do_not_optimize(*layer);
+      });
+}
+
+int main(int argc, char** argv) {
+  harness h{argc, argv};
+  sweep(std::tuple<ami::bfloat16, ami::float16>{},
+      [&]<class Storage>(Storage) {
+        sweep(sizes, [&](auto size) {
+          sweep(policies, [&]<class Policy>(Policy) {
+            run<Storage, size(), Policy{}>(h);
+          });
+        });
+      });
+}
@@ -0,0 +1,57 @@
+#include "ami/layer/component/node.hpp"
+
+#include <array>
+#include <cstddef>
+#include <memory>
+
+#include "ami/optimizer/adam.hpp"
+#include "ami_benchmark/harness.hpp"
+
+using namespace ami::benchmark;
+
+template <std::floating_point RealType, std::size_t Size,
+          ami::execution_policy auto P>
+void run(harness& h) {
+  using node_t = ami::node<RealType, Size>;
+  constexpr auto n = static_cast<double>(Size);
+  constexpr auto word = static_cast<double>(sizeof(RealType));
+  const auto type = type_name<RealType>();
+  const auto policy = policy_name<P>();
+
+  const node_t node{[] { return RealType{0.5}; }};
+  auto target = node;
+  typename node_t::input_type input{};
+  input.fill(RealType{0.25});
+  typename node_t::backward_type result{};
+  auto optimizer = std::make_unique<
+      typename node_t::template optimizer_type<ami::adam_t<RealType>>>();
+
+  h.run({"node/forward", type, policy, Size, 2 * n, 2 * n * word}, [&] {
+    do_not_optimize(node.template forward<P>(input));
+  });
+  h.run({"node/backward", type, policy, Size, 2 * n, 3 * n * word}, [&] {
+    node.template backward<P>(RealType{0.5}, result);
+    do_not_optimize(result);
+  });
+  h.run({"node/calc_gradient", type, policy, Size, 2 * n, 3 * n * word},
+      [&] {
+        node_t::template calc_gradient<P>(input, RealType{0.5}, result);
+        do_not_optimize(result);
+      });
+  h.run({"node/update_adam", type, policy, Size, 12 * n, 8 * n * word},
+      [&] {
+        target.template update<P>(*optimizer, input);
+        do_not_optimize(target);
+      });
+}
+
+int main(int argc, char** argv) {
+  harness h{argc, argv};
+  sweep(real_types, [&]<class RealType>(RealType) {
+    sweep(sizes, [&](auto size) {
+      sweep(policies, [&]<class Policy>(Policy) {
+        run<RealType, size(), Policy{}>(h);
+      });
+    });
+  });
+}
@@ -0,0 +1,64 @@
+#include "ami/layer/quantized_dense_layer.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <tuple>
+
+#include "ami/utility/quantization.hpp"
+#include "ami_benchmark/harness.hpp"
+
+using namespace ami::benchmark;
+
+// Square Size x Size float layers with int8 weights; compare with
+// dense_layer/forward on float.
+template <std::size_t Size, ami::execution_policy auto P>
+void run(harness& h) {
+  using layer_t = ami::quantized_dense_layer_t<float, Size, Size>;
+  constexpr auto n = static_cast<double>(Size);
+  constexpr auto word = static_cast<double>(sizeof(float));
+  const auto policy = policy_name<P>();
+
+  auto value = std::make_unique<typename layer_t::value_type>();
+  for (std::size_t i = 0; i < Size; ++i) {
+    for (std::size_t j = 0; j < Size; ++j) {
+      value->first[i][j] = static_cast<float>((i + 3 * j) % 17) / 8 - 1;
+    }
+  }
+  const auto input_q = ami::quantization<float>::from_range<std::uint8_t>(
+      -1.0f, 1.0f);
+  auto layer = std::make_unique<layer_t>(*value, input_q);
+  value.reset();
+
+  auto input = std::make_unique<typename layer_t::input_type>();
+  input->fill(0.25f);
+  auto quantized_input = std::make_unique<
+      typename layer_t::quantized_input_type>(layer->quantize(*input));
+  auto output = std::make_unique<typename layer_t::forward_type>();
+  auto quantized_output = std::make_unique<
+      typename layer_t::quantized_forward_type>();
+
+  h.run({"quantized_dense_layer/forward", "float", policy, Size, 2 * n * n,
+         n * n + 2 * n * word}, [&] {
+    layer->template forward<P>(*input, *output);
+    do_not_optimize(*output);
+  });
+
+  // Between two quantized layers: uint8 in, activation and quantization
+  // fused into the output.
+  h.run({"quantized_dense_layer/forward_quantized", "float", policy, Size,
+         2 * n * n, n * n + 2 * n}, [&] {
+    layer->template forward<P>(*quantized_input, *quantized_output, input_q,
+        [](std::size_t, float z) { return z > 0.0f ? z : 0.0f; });
+    do_not_optimize(*quantized_output);
+  });
+}
+
+int main(int argc, char** argv) {
+  harness h{argc, argv};
+  sweep(sizes, [&](auto size) {
+    sweep(policies, [&]<class Policy>(Policy) {
+      run<size(), Policy{}>(h);
+    });
+  });
+}
@@ -0,0 +1,68 @@
+#include "ami/layer/sparse_dense_layer.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+#include "ami/layer/dense_layer.hpp"
+#include "ami_benchmark/harness.hpp"
+
+using namespace ami::benchmark;
+
+// Square Size x Size float layers pruned to 10% of their weights; compare
+// with dense_layer on float.
+template <std::size_t Size, ami::execution_policy auto P>
+void run(harness& h) {
+  constexpr auto nonzeros = Size * Size / 10;
+  using dense_t = ami::dense_layer_t<float, Size, Size>;
+  using layer_t = ami::sparse_dense_layer_t<float, Size, Size, nonzeros>;
+  constexpr auto n = static_cast<double>(Size);
+  constexpr auto nnz = static_cast<double>(nonzeros);
+  constexpr auto word = static_cast<double>(sizeof(float));
+  constexpr auto index = static_cast<double>(sizeof(std::uint32_t));
+  const auto policy = policy_name<P>();
+
+  auto layer = std::make_unique<layer_t>();
+  {
+    auto dense = std::make_unique<dense_t>();
+    for (std::size_t i = 0; i < Size; ++i) {
+      for (std::size_t j = 0; j < Size; ++j) {
+        dense->weights(i)[j] =
+            static_cast<float>((i * 7 + j * 13) % 101) / 50 - 1;
+      }
+    }
+    layer->assign(*dense);
+  }
+  auto input = std::make_unique<typename layer_t::input_type>();
+  input->fill(0.25f);
+  auto delta = std::make_unique<typename layer_t::delta_type>();
+  delta->fill(0.5f);
+  auto output = std::make_unique<typename layer_t::forward_type>();
+  auto backward = std::make_unique<typename layer_t::backward_type>();
+  auto gradient = std::make_unique<typename layer_t::gradient_type>();
+
+  h.run({"sparse_dense_layer/forward", "float", policy, Size, 2 * nnz,
+         nnz * (word + index) + 3 * n * word}, [&] {
+    layer->template forward<P>(*input, *output);
+    do_not_optimize(*output);
+  });
+  h.run({"sparse_dense_layer/backward", "float", policy, Size, 2 * nnz,
+         nnz * (word + index) + 2 * n * word}, [&] {
+    layer->template backward<P>(*delta, *backward);
+    do_not_optimize(*backward);
+  });
+  h.run({"sparse_dense_layer/calc_gradient", "float", policy, Size, 2 * nnz,
+         nnz * (2 * word + index) + 2 * n * word}, [&] {
+    layer->template calc_gradient<P>(*input, *delta, *gradient);
+    do_not_optimize(*gradient);
+  });
+}
+
+int main(int argc, char** argv) {
+  harness h{argc, argv};
+  sweep(sizes, [&](auto size) {
+    sweep(policies, [&]<class Policy>(Policy) {
+      run<size(), Policy{}>(h);
+    });
+  });
+}
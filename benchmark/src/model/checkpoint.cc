@@ -0,0 +1,53 @@
+#include "ami/model/checkpoint.hpp"
+
+#include <cstddef>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+
+#include "ami/layer/dense_layer.hpp"
+#include "ami/model/mapped.hpp"
+#include "ami/model/sequential.hpp"
+#include "ami_benchmark/harness.hpp"
+
+using namespace ami::benchmark;
+
+// Opening a Size x Size model from a checkpoint: mapping it for inference
+// against copying it into a sequential.
+template <std::floating_point RealType, std::size_t Size>
+void run(harness& h) {
+  using model_type = ami::sequential_t<RealType, Size,
+      ami::dense_layer<Size>, ami::dense_layer<Size>>;
+  constexpr auto n = static_cast<double>(Size);
+  constexpr auto bytes = 2 * (n * n + n) * sizeof(RealType);
+  const auto type = type_name<RealType>();
+  const auto path = std::filesystem::temp_directory_path() /
+      "ami_checkpoint_benchmark.bin";
+
+  auto model = std::make_unique<model_type>();
+  {
+    std::ofstream os{path, std::ios::binary};
+    ami::save_checkpoint(os, *model);
+  }
+
+  h.run({"checkpoint/open_mapped", type, "seq", Size, 0, bytes}, [&] {
+    const ami::checkpoint source{path};
+    const ami::mapped<model_type> inference{source};
+    do_not_optimize(inference);
+  });
+  h.run({"checkpoint/load", type, "seq", Size, 0, bytes}, [&] {
+    const ami::checkpoint source{path};
+    ami::load_checkpoint(source, *model);
+    do_not_optimize(*model);
+  });
+  std::filesystem::remove(path);
+}
+
+int main(int argc, char** argv) {
+  harness h{argc, argv};
+  sweep(real_types, [&]<class RealType>(RealType) {
+    sweep(sizes, [&](auto size) {
+      run<RealType, size()>(h);
+    });
+  });
+}
@@ -0,0 +1,64 @@
+#include "ami/model/frozen.hpp"
+
+#include <array>
+#include <cstddef>
+
+#include "ami/activation/relu.hpp"
+#include "ami/layer/activation_layer.hpp"
+#include "ami/layer/dense_layer.hpp"
+#include "ami/model/sequential.hpp"
+#include "ami_benchmark/harness.hpp"
+
+using namespace ami::benchmark;
+
+// A scoring model of a few hundred weights: Size inputs, two hidden layers
+// of 16 and one output.
+template <std::floating_point RealType, std::size_t Size>
+using model_t = ami::sequential_t<RealType, Size, ami::dense_layer<16>,
+    ami::activation_layer<ami::relu>, ami::dense_layer<16>,
+    ami::activation_layer<ami::relu>, ami::dense_layer<1>>;
+
+template <class Model>
+constexpr auto make_parameters() {
+  using real_t = typename Model::real_type;
+  std::array<real_t, ami::parameter_size<Model>> result{};
+  for (std::size_t i = 0; i < result.size(); ++i) {
+    result[i] = static_cast<real_t>(static_cast<int>(i % 7) - 3) / 16;
+  }
+  return result;
+}
+
+template <std::floating_point RealType, std::size_t Size>
+constexpr auto parameters = make_parameters<model_t<RealType, Size>>();
+
+template <std::floating_point RealType, std::size_t Size>
+void run(harness& h) {
+  using model_type = model_t<RealType, Size>;
+  using frozen_type = ami::frozen<model_type, parameters<RealType, Size>>;
+  constexpr auto n = static_cast<double>(Size);
+  constexpr auto word = static_cast<double>(sizeof(RealType));
+  constexpr auto weights = static_cast<double>(16 * Size + 16 * 16 + 16);
+  const auto type = type_name<RealType>();
+
+  model_type model{};
+  typename model_type::input_type input{};
+  input.fill(RealType{0.25});
+
+  h.run({"frozen/sequential", type, "seq", Size, 2 * weights,
+         (weights + n) * word}, [&] {
+    do_not_optimize(model.forward(input));
+  });
+  h.run({"frozen/forward", type, "seq", Size, 2 * weights,
+         (weights + n) * word}, [&] {
+    do_not_optimize(input);
+    do_not_optimize(frozen_type::forward(input));
+  });
+}
+
+int main(int argc, char** argv) {
+  harness h{argc, argv};
+  sweep(real_types, [&]<class RealType>(RealType) {
+    run<RealType, 4>(h);
+    run<RealType, 16>(h);
+  });
+}
@@ -0,0 +1,56 @@
+#include "ami/optimizer/adam.hpp"
+
+#include <cstddef>
+#include <memory>
+#include <ranges>
+#include <vector>
+
+#include "ami/optimizer/fused_adam.hpp"
+#include "ami/utility/parallel_algorithm.hpp"
+#include "ami_benchmark/harness.hpp"
+
+using namespace ami::benchmark;
+
+// Per scalar adam (as node and bias use it) against fused_adam, over
+// Size x Size parameters.
+template <std::floating_point RealType, std::size_t Size,
+          ami::execution_policy auto P>
+void run(harness& h) {
+  constexpr auto count = Size * Size;
+  constexpr auto n = static_cast<double>(count);
+  constexpr auto word = static_cast<double>(sizeof(RealType));
+  const auto type = type_name<RealType>();
+  const auto policy = policy_name<P>();
+
+  std::vector<RealType> weight(count);
+  std::vector<RealType> gradient(count, RealType{0.5});
+
+  if constexpr (Size <= 1024) {
+    std::vector<ami::adam_t<RealType>> optimizer(count);
+    h.run({"adam/per_scalar", type, policy, Size, 12 * n, 11 * n * word},
+        [&] {
+          ami::utility::for_each<P>(std::views::iota(std::size_t{}, count),
+              [&](auto i) { optimizer[i](weight[i], gradient[i]); });
+          do_not_optimize(weight);
+        });
+  }
+
+  auto optimizer = std::make_unique<ami::fused_adam_t<RealType, count>>();
+  h.run({"adam/fused", type, policy, Size, 12 * n, 7 * n * word}, [&] {
+    optimizer->template operator()<P>(
+        std::span<RealType, count>{weight.data(), count},
+        std::span<const RealType, count>{gradient.data(), count});
+    do_not_optimize(weight);
+  });
+}
+
+int main(int argc, char** argv) {
+  harness h{argc, argv};
+  sweep(real_types, [&]<class RealType>(RealType) {
+    sweep(sizes, [&](auto size) {
+      sweep(policies, [&]<class Policy>(Policy) {
+        run<RealType, size(), Policy{}>(h);
+      });
+    });
+  });
+}
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <cmath>
+#include <concepts>
+#include <span>
+
+#include "ami/kernel/activation.hpp"
+
+namespace ami {
+
+  // x / 2 (1 + tanh(k (x + c x^3))) with k = sqrt(2 / pi), c = 0.044715,
+  // the tanh form of GELU. The batch forms exist for precision::fast only.
+  template <precision Precision = precision::exact>
+  struct gelu final {
+    template <std::floating_point RealType>
+    static constexpr RealType f(RealType x) noexcept {
+      if constexpr (Precision == precision::fast) {
+        using scalar = kernel::detail::simd<kernel::isa::scalar, RealType>;
+        return kernel::gelu::f<scalar>(x);
+      } else {
+        return RealType{0.5} * x * (RealType{1} + std::tanh(inner(x)));
+      }
+    }
+
+    template <std::floating_point RealType>
+    static constexpr RealType df(RealType x) noexcept {
+      if constexpr (Precision == precision::fast) {
+        using scalar = kernel::detail::simd<kernel::isa::scalar, RealType>;
+        return kernel::gelu::df<scalar>(x, RealType{1});
+      } else {
+        constexpr auto k = static_cast<RealType>(kernel::gelu::k);
+        constexpr auto c = static_cast<RealType>(kernel::gelu::c);
+        const auto t = std::tanh(inner(x));
+        return RealType{0.5} * (RealType{1} + t) + RealType{0.5} * x *
+            (RealType{1} - t * t) * k * (RealType{1} + 3 * c * x * x);
+      }
+    }
+
+    template <std::floating_point RealType>
+    requires (Precision == precision::fast)
+    static constexpr void f_batch(
+        std::span<const RealType> x, std::span<RealType> y) noexcept {
+      kernel::activate<kernel::gelu>(x.size(), x.data(), y.data());
+    }
+
+    template <std::floating_point RealType>
+    requires (Precision == precision::fast)
+    static constexpr void df_batch(
+        std::span<const RealType> x, std::span<const RealType> delta,
+        std::span<RealType> y) noexcept {
+      kernel::activate_gradient<kernel::gelu>(
+          x.size(), x.data(), delta.data(), y.data());
+    }
+
+  private:
+    template <std::floating_point RealType>
+    static constexpr RealType inner(RealType x) noexcept {
+      constexpr auto k = static_cast<RealType>(kernel::gelu::k);
+      constexpr auto c = static_cast<RealType>(kernel::gelu::c);
+      return k * (x + c * x * x * x);
+    }
+  };
+}
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <concepts>
+#include <span>
+
+#include "ami/kernel/activation.hpp"
+
+namespace ami {
+
+  // x for x > 0, Slope x otherwise
+  template <double Slope = 0.01>
+  struct leaky_relu final {
+    template <std::floating_point RealType>
+    static constexpr RealType f(RealType x) noexcept {
+      return x > RealType{} ? x : x * static_cast<RealType>(Slope);
+    }
+
+    template <std::floating_point RealType>
+    static constexpr RealType df(RealType x) noexcept {
+      return x > RealType{} ? RealType{1} : static_cast<RealType>(Slope);
+    }
+
+    // A positive slope keeps the sign, so the output tells the branch.
+    template <std::floating_point RealType>
+    requires (Slope > 0)
+    static constexpr RealType df_from_output(RealType y) noexcept {
+      return df(y);
+    }
+
+    template <std::floating_point RealType>
+    static constexpr void f_batch(
+        std::span<const RealType> x, std::span<RealType> y) noexcept {
+      kernel::activate<kernel::leaky_relu<Slope>>(
+          x.size(), x.data(), y.data());
+    }
+
+    template <std::floating_point RealType>
+    static constexpr void df_batch(
+        std::span<const RealType> x, std::span<const RealType> delta,
+        std::span<RealType> y) noexcept {
+      kernel::activate_gradient<kernel::leaky_relu<Slope>>(
+          x.size(), x.data(), delta.data(), y.data());
+    }
+  };
+}
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <concepts>
+#include <span>
+
+#include "ami/kernel/activation.hpp"
+
+namespace ami {
+
+  // max(x, 0)
+  struct relu final {
+    template <std::floating_point RealType>
+    static constexpr RealType f(RealType x) noexcept {
+      return x > RealType{} ? x : RealType{};
+    }
+
+    template <std::floating_point RealType>
+    static constexpr RealType df(RealType x) noexcept {
+      return x > RealType{} ? RealType{1} : RealType{};
+    }
+
+    template <std::floating_point RealType>
+    static constexpr RealType df_from_output(RealType y) noexcept {
+      return df(y);
+    }
+
+    template <std::floating_point RealType>
+    static constexpr void f_batch(
+        std::span<const RealType> x, std::span<RealType> y) noexcept {
+      kernel::activate<kernel::relu>(x.size(), x.data(), y.data());
+    }
+
+    template <std::floating_point RealType>
+    static constexpr void df_batch(
+        std::span<const RealType> x, std::span<const RealType> delta,
+        std::span<RealType> y) noexcept {
+      kernel::activate_gradient<kernel::relu>(
+          x.size(), x.data(), delta.data(), y.data());
+    }
+  };
+}
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <cmath>
+#include <concepts>
+#include <span>
+
+#include "ami/kernel/activation.hpp"
+
+namespace ami {
+
+  // 1 / (1 + e^-x). The batch forms exist for precision::fast only, since
+  // the standard exp is not vectorized.
+  template <precision Precision = precision::exact>
+  struct sigmoid final {
+    template <std::floating_point RealType>
+    static constexpr RealType f(RealType x) noexcept {
+      if constexpr (Precision == precision::fast) {
+        return kernel::fast_sigmoid(x);
+      } else {
+        return RealType{1} / (RealType{1} + std::exp(-x));
+      }
+    }
+
+    template <std::floating_point RealType>
+    static constexpr RealType df(RealType x) noexcept {
+      return df_from_output(f(x));
+    }
+
+    template <std::floating_point RealType>
+    static constexpr RealType df_from_output(RealType y) noexcept {
+      return y * (RealType{1} - y);
+    }
+
+    template <std::floating_point RealType>
+    requires (Precision == precision::fast)
+    static constexpr void f_batch(
+        std::span<const RealType> x, std::span<RealType> y) noexcept {
+      kernel::activate<kernel::sigmoid>(x.size(), x.data(), y.data());
+    }
+
+    template <std::floating_point RealType>
+    requires (Precision == precision::fast)
+    static constexpr void df_batch(
+        std::span<const RealType> x, std::span<const RealType> delta,
+        std::span<RealType> y) noexcept {
+      kernel::activate_gradient<kernel::sigmoid>(
+          x.size(), x.data(), delta.data(), y.data());
+    }
+  };
+}
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <cmath>
+#include <concepts>
+#include <span>
+
+#include "ami/kernel/activation.hpp"
+
+namespace ami {
+
+  // x sigmoid(x), also known as swish. The batch forms exist for
+  // precision::fast only.
+  template <precision Precision = precision::exact>
+  struct silu final {
+    template <std::floating_point RealType>
+    static constexpr RealType f(RealType x) noexcept {
+      return x * sigmoid(x);
+    }
+
+    template <std::floating_point RealType>
+    static constexpr RealType df(RealType x) noexcept {
+      const auto s = sigmoid(x);
+      return s * (RealType{1} + x * (RealType{1} - s));
+    }
+
+    template <std::floating_point RealType>
+    requires (Precision == precision::fast)
+    static constexpr void f_batch(
+        std::span<const RealType> x, std::span<RealType> y) noexcept {
+      kernel::activate<kernel::silu>(x.size(), x.data(), y.data());
+    }
+
+    template <std::floating_point RealType>
+    requires (Precision == precision::fast)
+    static constexpr void df_batch(
+        std::span<const RealType> x, std::span<const RealType> delta,
+        std::span<RealType> y) noexcept {
+      kernel::activate_gradient<kernel::silu>(
+          x.size(), x.data(), delta.data(), y.data());
+    }
+
+  private:
+    template <std::floating_point RealType>
+    static constexpr RealType sigmoid(RealType x) noexcept {
+      if constexpr (Precision == precision::fast) {
+        return kernel::fast_sigmoid(x);
+      } else {
+        return RealType{1} / (RealType{1} + std::exp(-x));
+      }
+    }
+  };
+}
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <cmath>
+#include <concepts>
+#include <span>
+
+#include "ami/kernel/activation.hpp"
+
+namespace ami {
+
+  // The batch forms exist for precision::fast only, since the standard
+  // tanh is not vectorized.
+  template <precision Precision = precision::exact>
+  struct tanh final {
+    template <std::floating_point RealType>
+    static constexpr RealType f(RealType x) noexcept {
+      if constexpr (Precision == precision::fast) {
+        return kernel::fast_tanh(x);
+      } else {
+        return std::tanh(x);
+      }
+    }
+
+    template <std::floating_point RealType>
+    static constexpr RealType df(RealType x) noexcept {
+      return df_from_output(f(x));
+    }
+
+    template <std::floating_point RealType>
+    static constexpr RealType df_from_output(RealType y) noexcept {
+      return RealType{1} - y * y;
+    }
+
+    template <std::floating_point RealType>
+    requires (Precision == precision::fast)
+    static constexpr void f_batch(
+        std::span<const RealType> x, std::span<RealType> y) noexcept {
+      kernel::activate<kernel::tanh>(x.size(), x.data(), y.data());
+    }
+
+    template <std::floating_point RealType>
+    requires (Precision == precision::fast)
+    static constexpr void df_batch(
+        std::span<const RealType> x, std::span<const RealType> delta,
+        std::span<RealType> y) noexcept {
+      kernel::activate_gradient<kernel::tanh>(
+          x.size(), x.data(), delta.data(), y.data());
+    }
+  };
+}
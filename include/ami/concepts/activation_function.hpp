@@ -1,6 +1,7 @@
 #pragma once
 
 #include <concepts>
+#include <span>
 #include <type_traits>
 
 namespace ami {
@@ -15,4 +16,25 @@ namespace ami {
           decltype(&T::template df<float>), float>, float> &&
       std::same_as<std::invoke_result_t<
           decltype(&T::template df<double>), double>, double>;
+
+  // Optional span-wide forms, preferred by activation_layer:
+  //   f_batch(x, y)         y[i] = f(x[i])
+  //   df_batch(x, delta, y) y[i] = df(x[i]) * delta[i]
+  template <class T, class RealType>
+  concept batch_activation_function =
+      activation_function<T> && std::floating_point<RealType> &&
+      requires (std::span<const RealType> x, std::span<RealType> y) {
+        T::f_batch(x, y);
+        T::df_batch(x, x, y);
+      };
+
+  // Activations whose derivative follows from the output y = f(x) alone,
+  // df_from_output(y) == df(x), so the input need not be kept.
+  template <class T>
+  concept output_activation_function =
+      activation_function<T> &&
+      std::same_as<std::invoke_result_t<
+          decltype(&T::template df_from_output<float>), float>, float> &&
+      std::same_as<std::invoke_result_t<
+          decltype(&T::template df_from_output<double>), double>, double>;
 }
@@ -1,15 +1,66 @@
 #pragma once
 
 #include <concepts>
+#include <cstddef>
 #include <execution>
 #include <type_traits>
 
+namespace ami::utility {
+
+  class thread_pool;
+}
+
+namespace ami::execution {
+
+  // Picks sequential, vectorized or parallel execution per call from the
+  // amount of work; see ami/utility/adaptive_policy.hpp.
+  struct adaptive_policy final {};
+
+  inline constexpr adaptive_policy adaptive{};
+
+  // Runs on pool, or on the process wide default pool when null, in chunks
+  // of at most grain elements (0 picks one from the size of the work); see
+  // ami/utility/thread_pool.hpp.
+  struct pool_policy final {
+    utility::thread_pool* pool = nullptr;
+    std::size_t grain = 0;
+  };
+
+  inline constexpr pool_policy pool{};
+}
+
 namespace ami {
 
+  // std::is_execution_policy may not be specialized, so the policies of
+  // this library are registered here instead.
   template <class T>
-  concept execution_policy = std::is_execution_policy_v<T>;
+  struct is_execution_policy : std::is_execution_policy<T> {};
+
+  template <>
+  struct is_execution_policy<execution::adaptive_policy> : std::true_type {};
+
+  template <>
+  struct is_execution_policy<execution::pool_policy> : std::true_type {};
+
+  template <class T>
+  inline constexpr bool is_execution_policy_v = is_execution_policy<T>::value;
+
+  template <class T>
+  concept execution_policy = is_execution_policy_v<T>;
 
   template <auto X>
   concept sequenced_policy = std::same_as<std::remove_cvref_t<decltype(X)>,
           std::execution::sequenced_policy>;
+
+  template <auto X>
+  concept unsequenced_policy = std::same_as<std::remove_cvref_t<decltype(X)>,
+          std::execution::unsequenced_policy>;
+
+  template <auto X>
+  concept adaptive_policy = std::same_as<std::remove_cvref_t<decltype(X)>,
+          execution::adaptive_policy>;
+
+  template <auto X>
+  concept pool_policy = std::same_as<std::remove_cvref_t<decltype(X)>,
+          execution::pool_policy>;
 }
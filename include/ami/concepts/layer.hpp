@@ -0,0 +1,23 @@
+#pragma once
+
+#include <concepts>
+#include <cstddef>
+
+namespace ami {
+
+  template <class T>
+  concept layer = requires {
+    typename T::real_type;
+    typename T::input_type;
+    typename T::forward_type;
+    typename T::backward_type;
+    typename T::delta_type;
+    { T::input_size } -> std::convertible_to<std::size_t>;
+    { T::output_size } -> std::convertible_to<std::size_t>;
+  };
+
+  template <class T>
+  concept trainable_layer = layer<T> && requires {
+    typename T::gradient_type;
+  };
+}
@@ -1,10 +1,35 @@
 #pragma once
 
 #include <concepts>
+#include <cstddef>
+#include <span>
 
 namespace ami {
 
   template <class T>
   concept optimizer =
       std::invocable<T, float&, float> || std::invocable<T, double&, double>;
+
+  // Updates a flat buffer of size parameters in one call.
+  template <class T>
+  concept buffer_optimizer = requires(
+      T& optimizer, std::span<const typename T::tensor_type> tensors) {
+    typename T::real_type;
+    { T::size } -> std::convertible_to<std::size_t>;
+    optimizer(tensors);
+  };
+
+  // A buffer optimizer before it is bound to a real type and a size, e.g.
+  // fused_adam<>. Layers bind it to their own parameter count.
+  template <class T>
+  concept buffer_optimizer_family =
+      buffer_optimizer<typename T::template type<float, 1>>;
+
+  // A buffer optimizer that can also take a step over only the parameters a
+  // sparse gradient touches, leaving the state of the others as it was.
+  template <class T>
+  concept lazy_optimizer = buffer_optimizer<T> && requires(
+      T& optimizer, void (&f)(const typename T::lazy_update_type&)) {
+    optimizer.step(f);
+  };
 }
@@ -0,0 +1,275 @@
+#pragma once
+
+#include <array>
+#include <concepts>
+#include <cstddef>
+#include <type_traits>
+
+#include "ami/kernel/simd.hpp"
+
+namespace ami {
+
+  // How activations evaluate exp and tanh: exact calls the standard
+  // library, fast the polynomial approximations of kernel::fast_exp and
+  // kernel::fast_tanh, which the batch kernels evaluate in SIMD registers.
+  enum class precision { exact, fast };
+}
+
+namespace ami::kernel::detail {
+
+  // exp(x) = 2^n exp(r) with n = round(x / ln 2) and |r| <= ln(2) / 2, and
+  // exp(r) by its Taylor polynomial of degree 6 (float) or 13 (double),
+  // whose truncation error is below half an ulp. The argument is clamped
+  // to the range where 2^n is a normal number.
+  template <class Simd>
+  constexpr typename Simd::reg exp(typename Simd::reg x) noexcept {
+    using T = typename Simd::value_type;
+    constexpr bool single = std::same_as<T, float>;
+    constexpr std::size_t degree = single ? 6 : 13;
+    constexpr auto coefficients = [] {
+      std::array<T, degree + 1> c{};
+      long double factorial = 1;
+      for (std::size_t k = 0; k <= degree; ++k) {
+        factorial *= k == 0 ? 1 : k;
+        c[k] = static_cast<T>(1 / factorial);
+      }
+      return c;
+    }();
+    // ln 2 = ln2_hi + ln2_lo, with n * ln2_hi exact
+    constexpr T ln2_hi = single ? T(0.693359375) : T(6.93145751953125e-1);
+    constexpr T ln2_lo =
+        single ? T(-2.12194440e-4) : T(1.42860682030941723212e-6);
+
+    x = Simd::min(Simd::max(x, Simd::set1(single ? T(-87.3) : T(-708))),
+        Simd::set1(single ? T(88) : T(709)));
+    const auto n = Simd::round(
+        Simd::mul(x, Simd::set1(T(1.44269504088896340736))));
+    const auto r = Simd::sub(Simd::sub(x, Simd::mul(n, Simd::set1(ln2_hi))),
+        Simd::mul(n, Simd::set1(ln2_lo)));
+
+    auto p = Simd::set1(coefficients[degree]);
+    for (auto k = degree; k-- > 0;) {
+      p = Simd::fmadd(p, r, Simd::set1(coefficients[k]));
+    }
+    return Simd::mul(p, Simd::pow2(n));
+  }
+
+  // tanh(x) = (e^2x - 1) / (e^2x + 1). The difference cancels near 0, so
+  // the error is a few ulp of 1 rather than of the result.
+  template <class Simd>
+  constexpr typename Simd::reg tanh(typename Simd::reg x) noexcept {
+    const auto one = Simd::set1(1);
+    const auto e = exp<Simd>(Simd::add(x, x));
+    return Simd::div(Simd::sub(e, one), Simd::add(e, one));
+  }
+
+  template <class Simd>
+  constexpr typename Simd::reg sigmoid(typename Simd::reg x) noexcept {
+    const auto one = Simd::set1(1);
+    return Simd::div(
+        one, Simd::add(one, exp<Simd>(Simd::sub(Simd::zero(), x))));
+  }
+
+  template <class Op, isa Isa, std::floating_point T>
+  inline void activate(std::size_t n, const T* x, T* y) noexcept {
+    using simd = detail::simd<Isa, T>;
+    using scalar = detail::simd<isa::scalar, T>;
+    constexpr auto width = simd::width;
+
+    const auto body = n - n % width;
+    for (std::size_t i = 0; i < body; i += width) {
+      simd::store(y + i, Op::template f<simd>(simd::load(x + i)));
+    }
+    for (auto i = body; i < n; ++i) {
+      y[i] = Op::template f<scalar>(x[i]);
+    }
+  }
+
+  template <class Op, isa Isa, std::floating_point T>
+  inline void activate_gradient(
+      std::size_t n, const T* x, const T* delta, T* y) noexcept {
+    using simd = detail::simd<Isa, T>;
+    using scalar = detail::simd<isa::scalar, T>;
+    constexpr auto width = simd::width;
+
+    const auto body = n - n % width;
+    for (std::size_t i = 0; i < body; i += width) {
+      simd::store(y + i, Op::template df<simd>(
+          simd::load(x + i), simd::load(delta + i)));
+    }
+    for (auto i = body; i < n; ++i) {
+      y[i] = Op::template df<scalar>(x[i], delta[i]);
+    }
+  }
+}
+
+namespace ami::kernel {
+
+  // Relative error within 3 ulp for x in [-87, 88].
+  template <std::floating_point T>
+  constexpr T fast_exp(T x) noexcept {
+    return detail::exp<detail::simd<isa::scalar, T>>(x);
+  }
+
+  // Absolute error within 2 ulp of 1.
+  template <std::floating_point T>
+  constexpr T fast_tanh(T x) noexcept {
+    return detail::tanh<detail::simd<isa::scalar, T>>(x);
+  }
+
+  // Relative error within 3 ulp for x in [-87, 87].
+  template <std::floating_point T>
+  constexpr T fast_sigmoid(T x) noexcept {
+    return detail::sigmoid<detail::simd<isa::scalar, T>>(x);
+  }
+
+  // Activation kernels for activate and activate_gradient. f<Simd>(x) is
+  // the activation and df<Simd>(x, delta) its derivative times delta, both
+  // written against the SIMD traits so the scalar tail shares the code.
+  // The transcendental ones use the fast approximations.
+
+  // max(x, 0)
+  struct relu final {
+    template <class Simd>
+    static constexpr typename Simd::reg f(typename Simd::reg x) noexcept {
+      return Simd::max(x, Simd::zero());
+    }
+
+    template <class Simd>
+    static constexpr typename Simd::reg df(
+        typename Simd::reg x, typename Simd::reg delta) noexcept {
+      return Simd::select_positive(x, delta, Simd::zero());
+    }
+  };
+
+  // x for x > 0, Slope x otherwise
+  template <double Slope>
+  struct leaky_relu final {
+    template <class Simd>
+    static constexpr typename Simd::reg f(typename Simd::reg x) noexcept {
+      return Simd::select_positive(x, x, Simd::mul(x, Simd::set1(Slope)));
+    }
+
+    template <class Simd>
+    static constexpr typename Simd::reg df(
+        typename Simd::reg x, typename Simd::reg delta) noexcept {
+      return Simd::select_positive(
+          x, delta, Simd::mul(delta, Simd::set1(Slope)));
+    }
+  };
+
+  // 1 / (1 + e^-x)
+  struct sigmoid final {
+    template <class Simd>
+    static constexpr typename Simd::reg f(typename Simd::reg x) noexcept {
+      return detail::sigmoid<Simd>(x);
+    }
+
+    template <class Simd>
+    static constexpr typename Simd::reg df(
+        typename Simd::reg x, typename Simd::reg delta) noexcept {
+      const auto s = detail::sigmoid<Simd>(x);
+      return Simd::mul(Simd::mul(s, Simd::sub(Simd::set1(1), s)), delta);
+    }
+  };
+
+  struct tanh final {
+    template <class Simd>
+    static constexpr typename Simd::reg f(typename Simd::reg x) noexcept {
+      return detail::tanh<Simd>(x);
+    }
+
+    template <class Simd>
+    static constexpr typename Simd::reg df(
+        typename Simd::reg x, typename Simd::reg delta) noexcept {
+      const auto t = detail::tanh<Simd>(x);
+      return Simd::mul(Simd::sub(Simd::set1(1), Simd::mul(t, t)), delta);
+    }
+  };
+
+  // x / 2 (1 + tanh(k (x + c x^3))), the tanh form of GELU
+  struct gelu final {
+    static constexpr double k = 0.79788456080286535588; // sqrt(2 / pi)
+    static constexpr double c = 0.044715;
+
+    template <class Simd>
+    static constexpr typename Simd::reg f(typename Simd::reg x) noexcept {
+      const auto t = detail::tanh<Simd>(inner<Simd>(x));
+      return Simd::mul(Simd::mul(Simd::set1(0.5), x),
+          Simd::add(Simd::set1(1), t));
+    }
+
+    // (1 + t) / 2 + x / 2 (1 - t^2) k (1 + 3 c x^2)
+    template <class Simd>
+    static constexpr typename Simd::reg df(
+        typename Simd::reg x, typename Simd::reg delta) noexcept {
+      const auto one = Simd::set1(1);
+      const auto t = detail::tanh<Simd>(inner<Simd>(x));
+      const auto slope = Simd::fmadd(
+          Simd::set1(3 * k * c), Simd::mul(x, x), Simd::set1(k));
+      const auto d = Simd::add(Simd::add(one, t), Simd::mul(
+          Simd::mul(x, Simd::sub(one, Simd::mul(t, t))), slope));
+      return Simd::mul(Simd::mul(Simd::set1(0.5), d), delta);
+    }
+
+  private:
+    template <class Simd>
+    static constexpr typename Simd::reg inner(typename Simd::reg x) noexcept {
+      return Simd::mul(x,
+          Simd::fmadd(Simd::set1(k * c), Simd::mul(x, x), Simd::set1(k)));
+    }
+  };
+
+  // x sigmoid(x)
+  struct silu final {
+    template <class Simd>
+    static constexpr typename Simd::reg f(typename Simd::reg x) noexcept {
+      return Simd::mul(x, detail::sigmoid<Simd>(x));
+    }
+
+    // s (1 + x (1 - s))
+    template <class Simd>
+    static constexpr typename Simd::reg df(
+        typename Simd::reg x, typename Simd::reg delta) noexcept {
+      const auto one = Simd::set1(1);
+      const auto s = detail::sigmoid<Simd>(x);
+      return Simd::mul(Simd::mul(s,
+          Simd::fmadd(x, Simd::sub(one, s), one)), delta);
+    }
+  };
+
+  // y = Op(x)
+  template <class Op, isa Isa = native_isa, std::floating_point T>
+  requires is_available_v<Isa>
+  constexpr void activate(std::size_t n, const T* x, T* y) noexcept {
+    if constexpr (Isa != isa::scalar) {
+      if (!std::is_constant_evaluated()) {
+        detail::activate<Op, Isa>(n, x, y);
+        return;
+      }
+    }
+
+    using scalar = detail::simd<isa::scalar, T>;
+    for (std::size_t i = 0; i < n; ++i) {
+      y[i] = Op::template f<scalar>(x[i]);
+    }
+  }
+
+  // y = Op'(x) delta
+  template <class Op, isa Isa = native_isa, std::floating_point T>
+  requires is_available_v<Isa>
+  constexpr void activate_gradient(
+      std::size_t n, const T* x, const T* delta, T* y) noexcept {
+    if constexpr (Isa != isa::scalar) {
+      if (!std::is_constant_evaluated()) {
+        detail::activate_gradient<Op, Isa>(n, x, delta, y);
+        return;
+      }
+    }
+
+    using scalar = detail::simd<isa::scalar, T>;
+    for (std::size_t i = 0; i < n; ++i) {
+      y[i] = Op::template df<scalar>(x[i], delta[i]);
+    }
+  }
+}
@@ -0,0 +1,93 @@
+#pragma once
+
+#include <cmath>
+#include <concepts>
+#include <cstddef>
+#include <type_traits>
+
+#include "ami/kernel/simd.hpp"
+
+namespace ami::kernel {
+
+  // correction1 and correction2 are 1 - beta1^t and 1 - beta2^t.
+  template <std::floating_point RealType>
+  struct adam_coefficients final {
+    RealType learning_rate;
+    RealType beta1;
+    RealType beta2;
+    RealType eps;
+    RealType correction1;
+    RealType correction2;
+  };
+}
+
+namespace ami::kernel::detail {
+
+  template <std::floating_point T>
+  constexpr void adam_scalar(
+      std::size_t begin, std::size_t end, T* w, const T* g, T* m, T* v,
+      const adam_coefficients<T>& c) noexcept {
+    for (auto i = begin; i < end; ++i) {
+      m[i] = multiply_add(m[i], c.beta1, (T{1} - c.beta1) * g[i]);
+      v[i] = multiply_add(v[i], c.beta2, (T{1} - c.beta2) * g[i] * g[i]);
+      w[i] -= c.learning_rate * (m[i] / c.correction1) /
+          (std::sqrt(v[i] / c.correction2) + c.eps);
+    }
+  }
+
+  // Explicit SIMD since std::sqrt is not vectorized while it may set errno.
+  // The moments take the same fused or unfused multiply-adds as the scalar
+  // loop, so outside constant evaluation the two match bit for bit.
+  template <isa Isa, std::floating_point T>
+  inline void adam(
+      std::size_t n, T* w, const T* g, T* m, T* v,
+      const adam_coefficients<T>& c) noexcept {
+    using simd = detail::simd<Isa, T>;
+    constexpr auto width = simd::width;
+
+    const auto beta1 = simd::set1(c.beta1);
+    const auto beta2 = simd::set1(c.beta2);
+    const auto one_minus_beta1 = simd::set1(T{1} - c.beta1);
+    const auto one_minus_beta2 = simd::set1(T{1} - c.beta2);
+    const auto learning_rate = simd::set1(c.learning_rate);
+    const auto eps = simd::set1(c.eps);
+    const auto correction1 = simd::set1(c.correction1);
+    const auto correction2 = simd::set1(c.correction2);
+
+    std::size_t i = 0;
+    for (const auto end = n - n % width; i < end; i += width) {
+      const auto gi = simd::load(g + i);
+      const auto mi = simd::fmadd(simd::load(m + i), beta1,
+          simd::mul(one_minus_beta1, gi));
+      const auto vi = simd::fmadd(simd::load(v + i), beta2,
+          simd::mul(simd::mul(one_minus_beta2, gi), gi));
+      const auto step = simd::div(
+          simd::mul(learning_rate, simd::div(mi, correction1)),
+          simd::add(simd::sqrt(simd::div(vi, correction2)), eps));
+      simd::store(m + i, mi);
+      simd::store(v + i, vi);
+      simd::store(w + i, simd::sub(simd::load(w + i), step));
+    }
+    adam_scalar(i, n, w, g, m, v, c);
+  }
+}
+
+namespace ami::kernel {
+
+  // One Adam step over n parameters:
+  //   m = beta1 m + (1 - beta1) g,  v = beta2 v + (1 - beta2) g^2,
+  //   w -= learning_rate (m / correction1) / (sqrt(v / correction2) + eps)
+  template <isa Isa = native_isa, std::floating_point T>
+  requires is_available_v<Isa>
+  constexpr void adam(
+      std::size_t n, T* w, const T* g, T* m, T* v,
+      const adam_coefficients<T>& c) noexcept {
+    if constexpr (Isa != isa::scalar) {
+      if (!std::is_constant_evaluated()) {
+        detail::adam<Isa>(n, w, g, m, v, c);
+        return;
+      }
+    }
+    detail::adam_scalar(std::size_t{}, n, w, g, m, v, c);
+  }
+}
@@ -0,0 +1,149 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <concepts>
+#include <cstddef>
+#include <type_traits>
+
+#include "ami/kernel/simd.hpp"
+#include "ami/utility/half_precision.hpp"
+
+namespace ami::kernel::detail {
+
+  template <real_storage From, real_storage To>
+  constexpr void convert_scalar(
+      std::size_t begin, std::size_t end, const From* x, To* y) noexcept {
+    for (auto i = begin; i < end; ++i) {
+      if constexpr (half_precision<To>) {
+        y[i] = To{static_cast<float>(x[i])};
+      } else if constexpr (half_precision<From>) {
+        y[i] = static_cast<To>(static_cast<float>(x[i]));
+      } else {
+        y[i] = static_cast<To>(x[i]);
+      }
+    }
+  }
+
+#if defined(__AVX2__)
+  // The vector paths take a multiple of 8 values. bfloat16 is the upper
+  // half of a float, so widening is a shift and narrowing rounds the lower
+  // half away to nearest even, as bfloat16's constructor does.
+  inline void convert_avx2(
+      std::size_t n, const bfloat16* x, float* y) noexcept {
+    for (std::size_t i = 0; i < n; i += 8) {
+      const auto bits = _mm256_cvtepu16_epi32(
+          _mm_loadu_si128(reinterpret_cast<const __m128i*>(x + i)));
+      _mm256_storeu_ps(y + i, _mm256_castsi256_ps(
+          _mm256_slli_epi32(bits, 16)));
+    }
+  }
+
+  inline void convert_avx2(
+      std::size_t n, const float* x, bfloat16* y) noexcept {
+    const auto one = _mm256_set1_epi32(1);
+    const auto half = _mm256_set1_epi32(0x7fff);
+    const auto abs_mask = _mm256_set1_epi32(0x7fffffff);
+    const auto infinity = _mm256_set1_epi32(0x7f800000);
+    const auto quiet = _mm256_set1_epi32(0x40);
+
+    for (std::size_t i = 0; i < n; i += 8) {
+      const auto bits = _mm256_castps_si256(_mm256_loadu_ps(x + i));
+      const auto upper = _mm256_srli_epi32(bits, 16);
+      const auto rounded = _mm256_srli_epi32(_mm256_add_epi32(bits,
+          _mm256_add_epi32(half, _mm256_and_si256(upper, one))), 16);
+      const auto nan = _mm256_cmpgt_epi32(
+          _mm256_and_si256(bits, abs_mask), infinity);
+      const auto result = _mm256_blendv_epi8(
+          rounded, _mm256_or_si256(upper, quiet), nan);
+      // packus interleaves the two 128 bit lanes; gather the low halves.
+      const auto packed = _mm256_permute4x64_epi64(
+          _mm256_packus_epi32(result, result), 0b1000);
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(y + i),
+          _mm256_castsi256_si128(packed));
+    }
+  }
+#endif
+
+#if defined(__F16C__)
+  inline void convert_avx2(
+      std::size_t n, const float16* x, float* y) noexcept {
+    for (std::size_t i = 0; i < n; i += 8) {
+      _mm256_storeu_ps(y + i, _mm256_cvtph_ps(
+          _mm_loadu_si128(reinterpret_cast<const __m128i*>(x + i))));
+    }
+  }
+
+  inline void convert_avx2(
+      std::size_t n, const float* x, float16* y) noexcept {
+    for (std::size_t i = 0; i < n; i += 8) {
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(y + i), _mm256_cvtps_ph(
+          _mm256_loadu_ps(x + i), _MM_FROUND_TO_NEAREST_INT));
+    }
+  }
+#endif
+
+#if defined(__AVX2__)
+  // Conversions with a vector path; the rest run the scalar loop only.
+  template <class From, class To>
+  concept vector_convertible = requires(
+      std::size_t n, const From* x, To* y) {
+    convert_avx2(n, x, y);
+  };
+#endif
+}
+
+namespace ami::kernel {
+
+  // y = x element by element, rounding to nearest even when narrowing.
+  // Conversions between float and a 16 bit format are vectorized.
+  template <isa Isa = native_isa, real_storage From, real_storage To>
+  requires is_available_v<Isa>
+  constexpr void convert(std::size_t n, const From* x, To* y) noexcept {
+#if defined(__AVX2__)
+    if constexpr ((Isa == isa::avx2 || Isa == isa::avx512) &&
+                  detail::vector_convertible<From, To>) {
+      if (!std::is_constant_evaluated()) {
+        const auto body = n - n % 8;
+        detail::convert_avx2(body, x, y);
+        detail::convert_scalar(body, n, x, y);
+        return;
+      }
+    }
+#endif
+    detail::convert_scalar(std::size_t{}, n, x, y);
+  }
+
+  // Values converted per step by the mixed precision kernels, which widen
+  // a block of 16 bit operands into a stack buffer and run the float
+  // kernel over it. The operands are read once at half the width, and the
+  // buffer stays in L1.
+  inline constexpr std::size_t convert_block = 256;
+
+  // x . y with x stored in 16 bits, accumulated in T.
+  template <isa Isa = native_isa, half_precision S, std::floating_point T>
+  requires is_available_v<Isa>
+  constexpr T dot(std::size_t n, const S* x, const T* y) noexcept {
+    std::array<T, convert_block> buffer;
+    T result{};
+    for (std::size_t i = 0; i < n; i += convert_block) {
+      const auto size = std::min(convert_block, n - i);
+      convert<Isa>(size, x + i, buffer.data());
+      result += dot<Isa>(size, buffer.data(), y + i);
+    }
+    return result;
+  }
+
+  // y += alpha * x with x stored in 16 bits.
+  template <isa Isa = native_isa, half_precision S, std::floating_point T>
+  requires is_available_v<Isa>
+  constexpr void axpy(std::size_t n, std::type_identity_t<T> alpha,
+                      const S* x, T* y) noexcept {
+    std::array<T, convert_block> buffer;
+    for (std::size_t i = 0; i < n; i += convert_block) {
+      const auto size = std::min(convert_block, n - i);
+      convert<Isa>(size, x + i, buffer.data());
+      axpy<Isa>(size, alpha, buffer.data(), y + i);
+    }
+  }
+}
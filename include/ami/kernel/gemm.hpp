@@ -0,0 +1,507 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <concepts>
+#include <cstddef>
+#include <execution>
+#include <ranges>
+#include <type_traits>
+
+#include "ami/concepts/execution_policy.hpp"
+#include "ami/kernel/convert.hpp"
+#include "ami/kernel/simd.hpp"
+#include "ami/memory/scratch.hpp"
+#include "ami/utility/half_precision.hpp"
+#include "ami/utility/parallel_algorithm.hpp"
+
+namespace ami::kernel {
+
+  // Strided 2D view; element (i, j) is data[i * row_stride + j * col_stride].
+  template <class T>
+  struct matrix_ref final {
+    T*          data;
+    std::size_t row_stride;
+    std::size_t col_stride;
+
+    constexpr T& operator()(std::size_t i, std::size_t j) const noexcept {
+      return data[i * row_stride + j * col_stride];
+    }
+
+    constexpr operator matrix_ref<const T>() const noexcept
+    requires (!std::is_const_v<T>) {
+      return {data, row_stride, col_stride};
+    }
+  };
+
+  template <class T>
+  constexpr matrix_ref<T> row_major(T* data, std::size_t ld) noexcept {
+    return {data, ld, 1};
+  }
+
+  template <class T>
+  constexpr matrix_ref<T> col_major(T* data, std::size_t ld) noexcept {
+    return {data, 1, ld};
+  }
+
+  // Blocking parameters. mr x nr is the register tile, mc x kc the packed
+  // block of A kept in L2, kc x nc the packed panel of B. line is the cache
+  // line size in bytes.
+  //
+  // The register tile is mr rows of two vectors of the target: sixteen
+  // registers of accumulators, leaving the rest for the operands.
+  template <std::floating_point RealType>
+  struct gemm_config final {
+    static constexpr std::size_t mr = 8;
+    static constexpr std::size_t nr =
+        2 * detail::simd<native_isa, RealType>::width;
+    static constexpr std::size_t mc = 96;
+    static constexpr std::size_t kc = 256;
+    static constexpr std::size_t nc = 2048;
+    static constexpr std::size_t line = 64;
+
+    // Below this many multiply-adds packing costs more than it saves.
+    static constexpr std::size_t small_size = 32 * 32 * 32;
+  };
+
+  // mc x kc block of a matrix, the unit of work of the elementwise matrix
+  // updates.
+  template <std::floating_point RealType>
+  inline constexpr utility::tile gemm_tile{
+      gemm_config<RealType>::mc, gemm_config<RealType>::kc};
+
+  // Default gemv epilogue; leaves every output as computed.
+  struct identity_epilogue final {
+    template <std::floating_point T>
+    constexpr T operator()(std::size_t, T value) const noexcept {
+      return value;
+    }
+  };
+}
+
+namespace ami::kernel::detail {
+
+  // Operands stored in 16 bits are widened to T as they are packed.
+  template <std::floating_point T, real_storage S>
+  constexpr void pack_a(
+      std::size_t mc, std::size_t kc, matrix_ref<const S> a, T* result) {
+    constexpr auto mr = gemm_config<T>::mr;
+    for (std::size_t ir = 0; ir < mc; ir += mr) {
+      const auto rows = std::min(mr, mc - ir);
+      for (std::size_t p = 0; p < kc; ++p) {
+        for (std::size_t i = 0; i < mr; ++i) {
+          *result++ = (i < rows) ? static_cast<T>(a(ir + i, p)) : T{};
+        }
+      }
+    }
+  }
+
+  template <std::floating_point T, real_storage S>
+  constexpr void pack_b(
+      std::size_t kc, std::size_t nc, matrix_ref<const S> b, T* result) {
+    constexpr auto nr = gemm_config<T>::nr;
+    for (std::size_t jr = 0; jr < nc; jr += nr) {
+      const auto cols = std::min(nr, nc - jr);
+      for (std::size_t p = 0; p < kc; ++p) {
+        for (std::size_t j = 0; j < nr; ++j) {
+          *result++ = (j < cols) ? static_cast<T>(b(p, jr + j)) : T{};
+        }
+      }
+    }
+  }
+
+  // Written against the simd traits rather than left to the vectorizer,
+  // which keeps the tile in registers for float but for double vectorizes
+  // along the rows of A and reshuffles the tile every step.
+  template <std::floating_point T>
+  void micro_kernel(
+      std::size_t kc, const T* a, const T* b, matrix_ref<T> c,
+      std::size_t rows, std::size_t cols) {
+    using simd = simd<native_isa, T>;
+    constexpr auto mr = gemm_config<T>::mr;
+    constexpr auto nr = gemm_config<T>::nr;
+    constexpr auto vectors = nr / simd::width;
+
+    // Plain arrays, as std::array would drop the attributes of the vector
+    // types.
+    typename simd::reg acc[mr][vectors];
+    for (auto& row : acc) {
+      std::ranges::fill(row, simd::zero());
+    }
+    for (std::size_t p = 0; p < kc; ++p, a += mr, b += nr) {
+      typename simd::reg bp[vectors];
+      for (std::size_t v = 0; v < vectors; ++v) {
+        bp[v] = simd::load(b + v * simd::width);
+      }
+      for (std::size_t i = 0; i < mr; ++i) {
+        const auto ai = simd::set1(a[i]);
+        for (std::size_t v = 0; v < vectors; ++v) {
+          acc[i][v] = simd::fmadd(ai, bp[v], acc[i][v]);
+        }
+      }
+    }
+
+    std::array<T, nr> tile;
+    for (std::size_t i = 0; i < rows; ++i) {
+      for (std::size_t v = 0; v < vectors; ++v) {
+        simd::store(tile.data() + v * simd::width, acc[i][v]);
+      }
+      for (std::size_t j = 0; j < cols; ++j) {
+        c(i, j) += tile[j];
+      }
+    }
+  }
+
+  template <std::floating_point T, real_storage A, real_storage B>
+  constexpr void gemm_small(
+      std::size_t m, std::size_t n, std::size_t k,
+      matrix_ref<const A> a, matrix_ref<const B> b, matrix_ref<T> c) {
+    for (std::size_t i = 0; i < m; ++i) {
+      for (std::size_t j = 0; j < n; ++j) {
+        T sum{};
+        for (std::size_t p = 0; p < k; ++p) {
+          sum += static_cast<T>(a(i, p)) * static_cast<T>(b(p, j));
+        }
+        c(i, j) += sum;
+      }
+    }
+  }
+
+  // Whether the matrix-vector kernels read S directly, widening each value
+  // to T as they multiply. bfloat16 widens with a shift, which vectorizes;
+  // float16 is widened into a stack tile first.
+  template <std::floating_point T, real_storage S>
+  inline constexpr bool widens_inline =
+      std::same_as<S, T> || std::same_as<S, bfloat16>;
+
+  // Columns in a block of the matrix-vector kernels, spanning as many bytes
+  // of a row whatever S is.
+  template <std::floating_point T, real_storage S>
+  inline constexpr std::size_t gemv_block =
+      gemm_config<T>::kc * sizeof(T) / sizeof(S);
+
+  template <std::floating_point T, real_storage S>
+  constexpr void gemv_t_block(
+      std::size_t m, std::size_t n, const S* a, std::size_t lda,
+      const T* x, T* y) {
+    constexpr std::size_t mr = 4;
+
+    if constexpr (!widens_inline<T, S>) {
+      // Widen mr rows at a time and run the T block.
+      constexpr auto kc = gemv_block<T, S>;
+      std::array<T, mr * kc> widened;
+      for (std::size_t jc = 0; jc < n; jc += kc) {
+        const auto nc = std::min(kc, n - jc);
+        for (std::size_t i = 0; i < m; i += mr) {
+          const auto rows = std::min(mr, m - i);
+          for (std::size_t r = 0; r < rows; ++r) {
+            convert(nc, a + (i + r) * lda + jc, widened.data() + r * kc);
+          }
+          gemv_t_block<T, T>(rows, nc, widened.data(), kc, x + i, y + jc);
+        }
+      }
+      return;
+    }
+
+    const auto body = m - m % mr;
+    const auto at = [a](std::size_t i) { return static_cast<T>(a[i]); };
+
+    for (std::size_t i = 0; i < body; i += mr) {
+      const auto offset = i * lda;
+      for (std::size_t j = 0; j < n; ++j) {
+        y[j] += (x[i] * at(offset + j) + x[i + 1] * at(offset + lda + j)) +
+            (x[i + 2] * at(offset + 2 * lda + j) +
+             x[i + 3] * at(offset + 3 * lda + j));
+      }
+    }
+    for (auto i = body; i < m; ++i) {
+      const auto offset = i * lda;
+      for (std::size_t j = 0; j < n; ++j) {
+        y[j] += x[i] * at(offset + j);
+      }
+    }
+  }
+
+  constexpr std::size_t ceil_div(std::size_t x, std::size_t y) noexcept {
+    return (x + y - 1) / y;
+  }
+
+  // Runs body(block, partial) for every block in parallel, each block
+  // summing into its own cache line aligned partial buffer of n values, and
+  // adds the partials to y(n) by a pairwise tree reduction; no two tasks
+  // ever write the same line.
+  template <execution_policy auto P, std::floating_point T, class Body>
+  void reduce_blocks(std::size_t blocks, std::size_t n, T* y, Body body) {
+    constexpr auto per_line = gemm_config<T>::line / sizeof(T);
+    const auto stride = ceil_div(n, per_line) * per_line;
+
+    memory::scratch workspace{};
+    auto* partial = workspace.allocate<T>(blocks * stride).data();
+    std::fill_n(partial, blocks * stride, T{});
+
+    utility::for_each<P>(std::views::iota(std::size_t{}, blocks),
+        [&](auto block) { body(block, partial + block * stride); });
+
+    for (std::size_t step = 1; step < blocks; step *= 2) {
+      utility::for_each<P>(std::views::iota(std::size_t{},
+              ceil_div(blocks - step, 2 * step)),
+          [&](auto pair) {
+            auto* dst = partial + pair * 2 * step * stride;
+            const auto* src = dst + step * stride;
+            for (std::size_t j = 0; j < n; ++j) {
+              dst[j] += src[j];
+            }
+          });
+    }
+
+    for (std::size_t j = 0; j < n; ++j) {
+      y[j] += partial[j];
+    }
+  }
+
+  // The cache blocked path of gemm over packed panels of A and B.
+  template <execution_policy auto P, std::floating_point T, real_storage A,
+            real_storage B>
+  inline void gemm_packed(
+      std::size_t m, std::size_t n, std::size_t k, matrix_ref<const A> a,
+      matrix_ref<const B> b, matrix_ref<T> c) {
+    using config = gemm_config<T>;
+
+    memory::scratch workspace{};
+    const auto packed_b = workspace.allocate<T>(config::kc * ceil_div(
+        std::min(n, config::nc), config::nr) * config::nr);
+
+    for (std::size_t jc = 0; jc < n; jc += config::nc) {
+      const auto nc = std::min(config::nc, n - jc);
+
+      for (std::size_t pc = 0; pc < k; pc += config::kc) {
+        const auto kc = std::min(config::kc, k - pc);
+        pack_b<T, B>(kc, nc, {&b(pc, jc), b.row_stride, b.col_stride},
+            packed_b.data());
+
+        utility::for_each<P>(
+            std::views::iota(std::size_t{}, ceil_div(m, config::mc)),
+            [&](auto block) {
+              const auto ic = block * config::mc;
+              const auto mc = std::min(config::mc, m - ic);
+
+              memory::scratch task_workspace{};
+              const auto packed_a = task_workspace.allocate<T>(
+                  kc * ceil_div(mc, config::mr) * config::mr);
+              pack_a<T, A>(mc, kc,
+                  {&a(ic, pc), a.row_stride, a.col_stride}, packed_a.data());
+
+              for (std::size_t jr = 0; jr < nc; jr += config::nr) {
+                for (std::size_t ir = 0; ir < mc; ir += config::mr) {
+                  micro_kernel<T>(kc,
+                      packed_a.data() + ir * kc, packed_b.data() + jr * kc,
+                      {&c(ic + ir, jc + jr), c.row_stride, c.col_stride},
+                      std::min(config::mr, mc - ir),
+                      std::min(config::nr, nc - jr));
+                }
+              }
+            });
+      }
+    }
+  }
+
+  template <execution_policy auto P, std::floating_point T, real_storage A,
+            real_storage B>
+  constexpr void gemm_dispatch(
+      std::size_t m, std::size_t n, std::size_t k, matrix_ref<const A> a,
+      matrix_ref<const B> b, matrix_ref<T> c) {
+    if constexpr (adaptive_policy<P>) {
+      return utility::resolve<P>(m * n * k, [&]<execution_policy auto Q> {
+            gemm_dispatch<Q>(m, n, k, a, b, c);
+          });
+    }
+
+    using config = gemm_config<T>;
+
+    // Packing buffers come from the thread's scratch arena, so constant
+    // evaluation takes the unpacked path whatever the size.
+    if (std::is_constant_evaluated() || m * n * k <= config::small_size) {
+      utility::for_each<P>(std::views::iota(std::size_t{}, m), [&](auto i) {
+            gemm_small<T, A, B>(1, n, k,
+                {&a(i, 0), a.row_stride, a.col_stride}, b,
+                {&c(i, 0), c.row_stride, c.col_stride});
+          });
+      return;
+    }
+
+    gemm_packed<P, T, A, B>(m, n, k, a, b, c);
+  }
+}
+
+namespace ami::kernel {
+
+  // C(m x n) += A(m x k) * B(k x n)
+  template <execution_policy auto P = std::execution::seq,
+            std::floating_point T>
+  constexpr void gemm(
+      std::size_t m, std::size_t n, std::size_t k,
+      std::type_identity_t<matrix_ref<const T>> a,
+      std::type_identity_t<matrix_ref<const T>> b, matrix_ref<T> c) {
+    detail::gemm_dispatch<P>(m, n, k, a, b, c);
+  }
+
+  // C(m x n) += A(m x k) * B(k x n) with A or B stored in 16 bits; the
+  // products are accumulated in T.
+  template <execution_policy auto P = std::execution::seq, real_storage A,
+            real_storage B, std::floating_point T>
+  requires (half_precision<A> || half_precision<B>)
+  constexpr void gemm(
+      std::size_t m, std::size_t n, std::size_t k, matrix_ref<const A> a,
+      matrix_ref<const B> b, matrix_ref<T> c) {
+    detail::gemm_dispatch<P>(m, n, k, a, b, c);
+  }
+
+  // y(m) += A(m x n) * x(n), A row major with leading dimension lda. Each
+  // finished y_i is replaced by epilogue(i, y_i) before it is stored. A may
+  // be stored in 16 bits and is widened to T as it is read.
+  template <execution_policy auto P = std::execution::seq, real_storage S,
+            std::floating_point T, class Epilogue = identity_epilogue>
+  requires (std::same_as<S, T> || half_precision<S>) &&
+           std::is_invocable_r_v<T, Epilogue&, std::size_t, T>
+  constexpr void gemv(
+      std::size_t m, std::size_t n, const S* a, std::size_t lda,
+      const T* x, T* y, Epilogue epilogue = {}) {
+    if constexpr (adaptive_policy<P>) {
+      return utility::resolve<P>(m * n, [&]<execution_policy auto Q> {
+            gemv<Q>(m, n, a, lda, x, y, epilogue);
+          });
+    }
+
+    using config = gemm_config<T>;
+    constexpr auto mr = config::mr;
+    constexpr auto lanes = config::nr;
+
+    utility::for_each<P>(
+        std::views::iota(std::size_t{}, detail::ceil_div(m, config::mc)),
+        [&](auto block) {
+          const auto ic = block * config::mc;
+          const auto mc = std::min(config::mc, m - ic);
+          constexpr auto block_cols = detail::gemv_block<T, S>;
+          constexpr auto inline_widen = detail::widens_inline<T, S>;
+          [[maybe_unused]] std::array<T,
+              inline_widen ? 0 : mr * block_cols> widened;
+
+          for (std::size_t pc = 0; pc < n; pc += block_cols) {
+            const auto kc = std::min(block_cols, n - pc);
+            const auto body = kc - kc % lanes;
+
+            for (std::size_t ir = 0; ir < mc; ir += mr) {
+              const auto rows = std::min(mr, mc - ir);
+              const auto* xs = x + pc;
+              std::conditional_t<inline_widen, const S*, const T*> row;
+              std::size_t ld;
+              if constexpr (inline_widen) {
+                row = a + (ic + ir) * lda + pc;
+                ld = lda;
+              } else {
+                for (std::size_t i = 0; i < rows; ++i) {
+                  convert(kc, a + (ic + ir + i) * lda + pc,
+                      widened.data() + i * block_cols);
+                }
+                row = widened.data();
+                ld = block_cols;
+              }
+
+              std::array<std::array<T, lanes>, mr> acc{};
+              for (std::size_t j = 0; j < body; j += lanes) {
+                for (std::size_t i = 0; i < rows; ++i) {
+                  for (std::size_t l = 0; l < lanes; ++l) {
+                    acc[i][l] +=
+                        static_cast<T>(row[i * ld + j + l]) * xs[j + l];
+                  }
+                }
+              }
+              for (std::size_t j = body; j < kc; ++j) {
+                for (std::size_t i = 0; i < rows; ++i) {
+                  acc[i][0] += static_cast<T>(row[i * ld + j]) * xs[j];
+                }
+              }
+
+              const auto last = pc + kc == n;
+              for (std::size_t i = 0; i < rows; ++i) {
+                T sum{};
+                for (auto v : acc[i]) {
+                  sum += v;
+                }
+                auto& out = y[ic + ir + i];
+                out += sum;
+                if (last) {
+                  out = epilogue(ic + ir + i, out);
+                }
+              }
+            }
+          }
+        });
+  }
+
+  // y(n) += A(m x n)^T * x(m), A row major with leading dimension lda,
+  // stored as T or in 16 bits.
+  template <execution_policy auto P = std::execution::seq, real_storage S,
+            std::floating_point T>
+  requires std::same_as<S, T> || half_precision<S>
+  constexpr void gemv_t(
+      std::size_t m, std::size_t n, const S* a, std::size_t lda,
+      const T* x, T* y) {
+    if constexpr (adaptive_policy<P>) {
+      return utility::resolve<P>(m * n, [&]<execution_policy auto Q> {
+            gemv_t<Q>(m, n, a, lda, x, y);
+          });
+    }
+
+    using config = gemm_config<T>;
+
+    constexpr auto block_cols = detail::gemv_block<T, S>;
+    const auto column_blocks = detail::ceil_div(n, block_cols);
+    const auto row_blocks = detail::ceil_div(m, config::mc);
+
+    if constexpr (!sequenced_policy<P> && !unsequenced_policy<P>) {
+      if (row_blocks > column_blocks && !utility::in_parallel_region()) {
+        // Too few column blocks to keep the workers busy, so split the rows
+        // instead, each row block summing into a partial of its own.
+        detail::reduce_blocks<P>(row_blocks, n, y,
+            [&](std::size_t block, T* partial) {
+              const auto ic = block * config::mc;
+              detail::gemv_t_block(std::min(config::mc, m - ic), n,
+                  a + ic * lda, lda, x + ic, partial);
+            });
+        return;
+      }
+    }
+
+    utility::for_each<P>(std::views::iota(std::size_t{}, column_blocks),
+        [&](auto block) {
+          const auto jc = block * block_cols;
+          detail::gemv_t_block(m, std::min(block_cols, n - jc),
+              a + jc, lda, x, y + jc);
+        });
+  }
+
+  // A(m x n) += x(m) * y(n)^T, A row major with leading dimension lda
+  template <execution_policy auto P = std::execution::seq,
+            std::floating_point T>
+  constexpr void ger(
+      std::size_t m, std::size_t n, const T* x, const T* y,
+      T* a, std::size_t lda) {
+    if constexpr (adaptive_policy<P>) {
+      return utility::resolve<P>(m * n, [&]<execution_policy auto Q> {
+            ger<Q>(m, n, x, y, a, lda);
+          });
+    }
+
+    utility::for_each_tile<P>(m, n, gemm_tile<T>,
+        [&](auto row_begin, auto row_end, auto col_begin, auto col_end) {
+          for (auto i = row_begin; i < row_end; ++i) {
+            auto* row = a + i * lda;
+            const auto xi = x[i];
+            for (auto j = col_begin; j < col_end; ++j) {
+              row[j] += xi * y[j];
+            }
+          }
+        });
+  }
+}
@@ -0,0 +1,138 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <execution>
+#include <limits>
+#include <ranges>
+#include <type_traits>
+
+#include "ami/concepts/execution_policy.hpp"
+#include "ami/kernel/simd.hpp"
+#include "ami/utility/parallel_algorithm.hpp"
+
+namespace ami::kernel {
+
+  // Longest uint8 x int8 dot product whose int32 sum cannot overflow.
+  inline constexpr std::size_t quantized_dot_limit =
+      std::numeric_limits<std::int32_t>::max() / (255 * 128);
+}
+
+namespace ami::kernel::detail {
+
+#if defined(__AVX2__)
+  inline std::int32_t reduce_epi32(__m256i v) noexcept {
+    const auto h = _mm_add_epi32(
+        _mm256_castsi256_si128(v), _mm256_extracti128_si256(v, 1));
+    const auto q = _mm_add_epi32(h, _mm_shuffle_epi32(h, 0b01001110));
+    return _mm_cvtsi128_si32(_mm_add_epi32(q, _mm_shuffle_epi32(q, 1)));
+  }
+
+  // VNNI multiplies four uint8 x int8 pairs and adds them to an int32 lane
+  // in one instruction. Without it the bytes are widened to 16 bits for
+  // madd; maddubs would be shorter, but it saturates the sum of two
+  // products to int16, and 255 * 127 * 2 does not fit.
+  template <isa Isa>
+  inline std::int32_t dot_u8s8(
+      std::size_t n, const std::uint8_t* x, const std::int8_t* y) noexcept {
+    std::size_t i = 0;
+    std::int32_t result = 0;
+
+#if defined(__AVX512VNNI__)
+    if constexpr (Isa == isa::avx512) {
+      auto acc0 = _mm512_setzero_si512();
+      auto acc1 = _mm512_setzero_si512();
+      for (; i + 128 <= n; i += 128) {
+        acc0 = _mm512_dpbusd_epi32(acc0,
+            _mm512_loadu_si512(x + i), _mm512_loadu_si512(y + i));
+        acc1 = _mm512_dpbusd_epi32(acc1,
+            _mm512_loadu_si512(x + i + 64), _mm512_loadu_si512(y + i + 64));
+      }
+      // Spilled instead of _mm512_reduce_add_epi32, which trips
+      // -Wuninitialized in GCC 12's headers.
+      alignas(64) std::int32_t lanes[16];
+      _mm512_store_si512(lanes, _mm512_add_epi32(acc0, acc1));
+      result = reduce_epi32(_mm256_add_epi32(
+          _mm256_load_si256(reinterpret_cast<const __m256i*>(lanes)),
+          _mm256_load_si256(reinterpret_cast<const __m256i*>(lanes + 8))));
+    }
+#endif
+
+    auto acc = _mm256_setzero_si256();
+    for (; i + 32 <= n; i += 32) {
+      const auto xs = _mm256_loadu_si256(
+          reinterpret_cast<const __m256i*>(x + i));
+      const auto ys = _mm256_loadu_si256(
+          reinterpret_cast<const __m256i*>(y + i));
+#if defined(__AVXVNNI__)
+      acc = _mm256_dpbusd_avx_epi32(acc, xs, ys);
+#else
+      const auto lo = _mm256_madd_epi16(
+          _mm256_cvtepu8_epi16(_mm256_castsi256_si128(xs)),
+          _mm256_cvtepi8_epi16(_mm256_castsi256_si128(ys)));
+      const auto hi = _mm256_madd_epi16(
+          _mm256_cvtepu8_epi16(_mm256_extracti128_si256(xs, 1)),
+          _mm256_cvtepi8_epi16(_mm256_extracti128_si256(ys, 1)));
+      acc = _mm256_add_epi32(acc, _mm256_add_epi32(lo, hi));
+#endif
+    }
+    result += reduce_epi32(acc);
+
+    for (; i < n; ++i) {
+      result += std::int32_t{x[i]} * std::int32_t{y[i]};
+    }
+    return result;
+  }
+#endif
+}
+
+namespace ami::kernel {
+
+  // x . y with uint8 x and int8 y, exact in int32 for n up to
+  // quantized_dot_limit.
+  template <isa Isa = native_isa>
+  requires is_available_v<Isa>
+  constexpr std::int32_t dot(
+      std::size_t n, const std::uint8_t* x, const std::int8_t* y) noexcept {
+#if defined(__AVX2__)
+    if constexpr (Isa == isa::avx2 || Isa == isa::avx512) {
+      if (!std::is_constant_evaluated()) {
+        return detail::dot_u8s8<Isa>(n, x, y);
+      }
+    }
+#endif
+    std::int32_t result = 0;
+    for (std::size_t i = 0; i < n; ++i) {
+      result += std::int32_t{x[i]} * std::int32_t{y[i]};
+    }
+    return result;
+  }
+
+  // Rows of A per task of the quantized gemv.
+  inline constexpr std::size_t quantized_gemv_rows = 64;
+
+  // y(m) += A(m x n) * x(n) with A int8, row major with leading dimension
+  // lda, and x uint8; exact in int32 for n up to quantized_dot_limit. Each
+  // row is one dot product: x stays in L1 while the weights stream past.
+  template <execution_policy auto P = std::execution::seq>
+  constexpr void gemv(
+      std::size_t m, std::size_t n, const std::int8_t* a, std::size_t lda,
+      const std::uint8_t* x, std::int32_t* y) {
+    if constexpr (adaptive_policy<P>) {
+      return utility::resolve<P>(m * n, [&]<execution_policy auto Q> {
+            gemv<Q>(m, n, a, lda, x, y);
+          });
+    }
+
+    constexpr auto rows = quantized_gemv_rows;
+    utility::for_each<P>(
+        std::views::iota(std::size_t{}, (m + rows - 1) / rows),
+        [&](auto block) {
+          const auto end = std::min(m, (block + 1) * rows);
+          for (auto i = block * rows; i < end; ++i) {
+            y[i] += dot(n, x, a + i * lda);
+          }
+        });
+  }
+}
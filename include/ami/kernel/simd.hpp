@@ -0,0 +1,449 @@
+#pragma once
+
+#include <bit>
+#include <cmath>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+
+#if defined(__SSE2__) || defined(__AVX2__) || defined(__AVX512F__)
+#include <immintrin.h>
+#endif
+
+namespace ami::kernel {
+
+  enum class isa { scalar, sse2, avx2, avx512 };
+
+  // Instruction sets enabled by the compiler flags (e.g. -march=native).
+  template <isa Isa>
+  inline constexpr bool is_available_v =
+      Isa == isa::scalar
+#if defined(__SSE2__)
+      || Isa == isa::sse2
+#endif
+#if defined(__AVX2__) && defined(__FMA__)
+      || Isa == isa::avx2
+#endif
+#if defined(__AVX512F__)
+      || Isa == isa::avx512
+#endif
+      ;
+
+  inline constexpr isa native_isa =
+      is_available_v<isa::avx512> ? isa::avx512 :
+      is_available_v<isa::avx2>   ? isa::avx2   :
+      is_available_v<isa::sse2>   ? isa::sse2   : isa::scalar;
+}
+
+namespace ami::kernel::detail {
+
+  // a * b + c, fused where the target has FMA, as simd::fmadd is there, so
+  // scalar loop tails round as the vector body does. Unfused in constant
+  // evaluation.
+  template <std::floating_point T>
+  constexpr T multiply_add(T a, T b, T c) noexcept {
+#if defined(__FMA__) || defined(__AVX512F__)
+    if (!std::is_constant_evaluated()) {
+      return std::fma(a, b, c);
+    }
+#endif
+    return a * b + c;
+  }
+
+  template <isa Isa, std::floating_point T>
+  struct simd;
+
+  // One lane, for loop tails and constant evaluation, so that kernels
+  // written against the traits also describe their scalar fallback.
+  template <std::floating_point T>
+  struct simd<isa::scalar, T> final {
+    using value_type = T;
+    using reg = T;
+    static constexpr std::size_t width = 1;
+
+    using bits_type =
+        std::conditional_t<sizeof(T) == 4, std::uint32_t, std::uint64_t>;
+    static constexpr int mantissa = std::numeric_limits<T>::digits - 1;
+    static constexpr T magic = T(3) * T(bits_type{1} << (mantissa - 1));
+
+    static constexpr reg zero() noexcept { return T{}; }
+    static constexpr reg set1(T v) noexcept { return v; }
+    static constexpr reg load(const T* p) noexcept { return *p; }
+    static constexpr void store(T* p, reg v) noexcept { *p = v; }
+    static constexpr reg add(reg a, reg b) noexcept { return a + b; }
+    static constexpr reg sub(reg a, reg b) noexcept { return a - b; }
+    static constexpr reg mul(reg a, reg b) noexcept { return a * b; }
+    static constexpr reg div(reg a, reg b) noexcept { return a / b; }
+    static reg sqrt(reg a) noexcept { return std::sqrt(a); }
+    static constexpr reg fmadd(reg a, reg b, reg c) noexcept {
+      return a * b + c;
+    }
+    static constexpr reg max(reg a, reg b) noexcept { return a > b ? a : b; }
+    static constexpr reg min(reg a, reg b) noexcept { return a < b ? a : b; }
+    static constexpr reg round(reg a) noexcept { return a + magic - magic; }
+    static constexpr reg pow2(reg n) noexcept {
+      constexpr auto bias = bits_type{std::numeric_limits<T>::max_exponent - 1};
+      return std::bit_cast<T>(
+          (std::bit_cast<bits_type>(T(n + magic)) -
+           std::bit_cast<bits_type>(magic) + bias) << mantissa);
+    }
+    static constexpr reg select_positive(reg x, reg a, reg b) noexcept {
+      return x > T{} ? a : b;
+    }
+    static constexpr T reduce(reg v) noexcept { return v; }
+  };
+
+#if defined(__SSE2__)
+  template <>
+  struct simd<isa::sse2, float> final {
+    using value_type = float;
+    using reg = __m128;
+    static constexpr std::size_t width = 4;
+
+    static reg zero() noexcept { return _mm_setzero_ps(); }
+    static reg set1(float v) noexcept { return _mm_set1_ps(v); }
+    static reg load(const float* p) noexcept { return _mm_loadu_ps(p); }
+    static void store(float* p, reg v) noexcept { _mm_storeu_ps(p, v); }
+    static reg add(reg a, reg b) noexcept { return _mm_add_ps(a, b); }
+    static reg sub(reg a, reg b) noexcept { return _mm_sub_ps(a, b); }
+    static reg mul(reg a, reg b) noexcept { return _mm_mul_ps(a, b); }
+    static reg div(reg a, reg b) noexcept { return _mm_div_ps(a, b); }
+    static reg sqrt(reg a) noexcept { return _mm_sqrt_ps(a); }
+    static reg fmadd(reg a, reg b, reg c) noexcept {
+      return _mm_add_ps(_mm_mul_ps(a, b), c);
+    }
+    static reg max(reg a, reg b) noexcept { return _mm_max_ps(a, b); }
+    static reg min(reg a, reg b) noexcept { return _mm_min_ps(a, b); }
+    static reg round(reg a) noexcept {
+      const auto magic = set1(0x1.8p23f);
+      return _mm_sub_ps(_mm_add_ps(a, magic), magic);
+    }
+    static reg pow2(reg n) noexcept {
+      const auto bits = _mm_castps_si128(_mm_add_ps(n, set1(0x1.8p23f)));
+      return _mm_castsi128_ps(_mm_slli_epi32(
+          _mm_add_epi32(bits, _mm_set1_epi32(127 - 0x4b400000)), 23));
+    }
+    static reg select_positive(reg x, reg a, reg b) noexcept {
+      const auto mask = _mm_cmpgt_ps(x, zero());
+      return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b));
+    }
+    static float reduce(reg v) noexcept {
+      const auto h = _mm_add_ps(v, _mm_movehl_ps(v, v));
+      return _mm_cvtss_f32(_mm_add_ss(h, _mm_shuffle_ps(h, h, 1)));
+    }
+  };
+
+  template <>
+  struct simd<isa::sse2, double> final {
+    using value_type = double;
+    using reg = __m128d;
+    static constexpr std::size_t width = 2;
+
+    static reg zero() noexcept { return _mm_setzero_pd(); }
+    static reg set1(double v) noexcept { return _mm_set1_pd(v); }
+    static reg load(const double* p) noexcept { return _mm_loadu_pd(p); }
+    static void store(double* p, reg v) noexcept { _mm_storeu_pd(p, v); }
+    static reg add(reg a, reg b) noexcept { return _mm_add_pd(a, b); }
+    static reg sub(reg a, reg b) noexcept { return _mm_sub_pd(a, b); }
+    static reg mul(reg a, reg b) noexcept { return _mm_mul_pd(a, b); }
+    static reg div(reg a, reg b) noexcept { return _mm_div_pd(a, b); }
+    static reg sqrt(reg a) noexcept { return _mm_sqrt_pd(a); }
+    static reg fmadd(reg a, reg b, reg c) noexcept {
+      return _mm_add_pd(_mm_mul_pd(a, b), c);
+    }
+    static reg max(reg a, reg b) noexcept { return _mm_max_pd(a, b); }
+    static reg min(reg a, reg b) noexcept { return _mm_min_pd(a, b); }
+    static reg round(reg a) noexcept {
+      const auto magic = set1(0x1.8p52);
+      return _mm_sub_pd(_mm_add_pd(a, magic), magic);
+    }
+    static reg pow2(reg n) noexcept {
+      const auto bits = _mm_castpd_si128(_mm_add_pd(n, set1(0x1.8p52)));
+      return _mm_castsi128_pd(_mm_slli_epi64(_mm_add_epi64(bits,
+          _mm_set1_epi64x(1023 - 0x4338000000000000)), 52));
+    }
+    static reg select_positive(reg x, reg a, reg b) noexcept {
+      const auto mask = _mm_cmpgt_pd(x, zero());
+      return _mm_or_pd(_mm_and_pd(mask, a), _mm_andnot_pd(mask, b));
+    }
+    static double reduce(reg v) noexcept {
+      return _mm_cvtsd_f64(_mm_add_sd(v, _mm_unpackhi_pd(v, v)));
+    }
+  };
+#endif
+
+#if defined(__AVX2__) && defined(__FMA__)
+  template <>
+  struct simd<isa::avx2, float> final {
+    using value_type = float;
+    using reg = __m256;
+    static constexpr std::size_t width = 8;
+
+    static reg zero() noexcept { return _mm256_setzero_ps(); }
+    static reg set1(float v) noexcept { return _mm256_set1_ps(v); }
+    static reg load(const float* p) noexcept { return _mm256_loadu_ps(p); }
+    static void store(float* p, reg v) noexcept { _mm256_storeu_ps(p, v); }
+    static reg add(reg a, reg b) noexcept { return _mm256_add_ps(a, b); }
+    static reg sub(reg a, reg b) noexcept { return _mm256_sub_ps(a, b); }
+    static reg mul(reg a, reg b) noexcept { return _mm256_mul_ps(a, b); }
+    static reg div(reg a, reg b) noexcept { return _mm256_div_ps(a, b); }
+    static reg sqrt(reg a) noexcept { return _mm256_sqrt_ps(a); }
+    static reg fmadd(reg a, reg b, reg c) noexcept {
+      return _mm256_fmadd_ps(a, b, c);
+    }
+    static reg max(reg a, reg b) noexcept { return _mm256_max_ps(a, b); }
+    static reg min(reg a, reg b) noexcept { return _mm256_min_ps(a, b); }
+    static reg round(reg a) noexcept {
+      const auto magic = set1(0x1.8p23f);
+      return _mm256_sub_ps(_mm256_add_ps(a, magic), magic);
+    }
+    static reg pow2(reg n) noexcept {
+      const auto bits =
+          _mm256_castps_si256(_mm256_add_ps(n, set1(0x1.8p23f)));
+      return _mm256_castsi256_ps(_mm256_slli_epi32(
+          _mm256_add_epi32(bits, _mm256_set1_epi32(127 - 0x4b400000)), 23));
+    }
+    static reg select_positive(reg x, reg a, reg b) noexcept {
+      return _mm256_blendv_ps(b, a, _mm256_cmp_ps(x, zero(), _CMP_GT_OQ));
+    }
+    static float reduce(reg v) noexcept {
+      return simd<isa::sse2, float>::reduce(_mm_add_ps(
+          _mm256_castps256_ps128(v), _mm256_extractf128_ps(v, 1)));
+    }
+  };
+
+  template <>
+  struct simd<isa::avx2, double> final {
+    using value_type = double;
+    using reg = __m256d;
+    static constexpr std::size_t width = 4;
+
+    static reg zero() noexcept { return _mm256_setzero_pd(); }
+    static reg set1(double v) noexcept { return _mm256_set1_pd(v); }
+    static reg load(const double* p) noexcept { return _mm256_loadu_pd(p); }
+    static void store(double* p, reg v) noexcept { _mm256_storeu_pd(p, v); }
+    static reg add(reg a, reg b) noexcept { return _mm256_add_pd(a, b); }
+    static reg sub(reg a, reg b) noexcept { return _mm256_sub_pd(a, b); }
+    static reg mul(reg a, reg b) noexcept { return _mm256_mul_pd(a, b); }
+    static reg div(reg a, reg b) noexcept { return _mm256_div_pd(a, b); }
+    static reg sqrt(reg a) noexcept { return _mm256_sqrt_pd(a); }
+    static reg fmadd(reg a, reg b, reg c) noexcept {
+      return _mm256_fmadd_pd(a, b, c);
+    }
+    static reg max(reg a, reg b) noexcept { return _mm256_max_pd(a, b); }
+    static reg min(reg a, reg b) noexcept { return _mm256_min_pd(a, b); }
+    static reg round(reg a) noexcept {
+      const auto magic = set1(0x1.8p52);
+      return _mm256_sub_pd(_mm256_add_pd(a, magic), magic);
+    }
+    static reg pow2(reg n) noexcept {
+      const auto bits =
+          _mm256_castpd_si256(_mm256_add_pd(n, set1(0x1.8p52)));
+      return _mm256_castsi256_pd(_mm256_slli_epi64(_mm256_add_epi64(bits,
+          _mm256_set1_epi64x(1023 - 0x4338000000000000)), 52));
+    }
+    static reg select_positive(reg x, reg a, reg b) noexcept {
+      return _mm256_blendv_pd(b, a, _mm256_cmp_pd(x, zero(), _CMP_GT_OQ));
+    }
+    static double reduce(reg v) noexcept {
+      return simd<isa::sse2, double>::reduce(_mm_add_pd(
+          _mm256_castpd256_pd128(v), _mm256_extractf128_pd(v, 1)));
+    }
+  };
+#endif
+
+#if defined(__AVX512F__)
+  template <>
+  struct simd<isa::avx512, float> final {
+    using value_type = float;
+    using reg = __m512;
+    static constexpr std::size_t width = 16;
+
+    static reg zero() noexcept { return _mm512_setzero_ps(); }
+    static reg set1(float v) noexcept { return _mm512_set1_ps(v); }
+    static reg load(const float* p) noexcept { return _mm512_loadu_ps(p); }
+    static void store(float* p, reg v) noexcept { _mm512_storeu_ps(p, v); }
+    static reg add(reg a, reg b) noexcept { return _mm512_add_ps(a, b); }
+    static reg sub(reg a, reg b) noexcept { return _mm512_sub_ps(a, b); }
+    static reg mul(reg a, reg b) noexcept { return _mm512_mul_ps(a, b); }
+    static reg div(reg a, reg b) noexcept { return _mm512_div_ps(a, b); }
+    // Zero masked forms of sqrt avoid the same GCC 12 warning.
+    static reg sqrt(reg a) noexcept {
+      return _mm512_maskz_sqrt_ps(__mmask16(0xffff), a);
+    }
+    static reg fmadd(reg a, reg b, reg c) noexcept {
+      return _mm512_fmadd_ps(a, b, c);
+    }
+    static reg max(reg a, reg b) noexcept {
+      return _mm512_maskz_max_ps(__mmask16(0xffff), a, b);
+    }
+    static reg min(reg a, reg b) noexcept {
+      return _mm512_maskz_min_ps(__mmask16(0xffff), a, b);
+    }
+    static reg round(reg a) noexcept {
+      const auto magic = set1(0x1.8p23f);
+      return _mm512_sub_ps(_mm512_add_ps(a, magic), magic);
+    }
+    static reg pow2(reg n) noexcept {
+      const auto bits =
+          _mm512_castps_si512(_mm512_add_ps(n, set1(0x1.8p23f)));
+      return _mm512_castsi512_ps(_mm512_maskz_slli_epi32(__mmask16(0xffff),
+          _mm512_add_epi32(bits, _mm512_set1_epi32(127 - 0x4b400000)), 23));
+    }
+    static reg select_positive(reg x, reg a, reg b) noexcept {
+      return _mm512_mask_blend_ps(
+          _mm512_cmp_ps_mask(x, zero(), _CMP_GT_OQ), b, a);
+    }
+    static float reduce(reg v) noexcept {
+      // Spilled instead of _mm512_reduce_add_ps, which trips
+      // -Wuninitialized in GCC 12's headers.
+      alignas(64) float lanes[width];
+      _mm512_store_ps(lanes, v);
+      return simd<isa::sse2, float>::reduce(_mm_add_ps(
+          _mm_add_ps(_mm_load_ps(lanes), _mm_load_ps(lanes + 4)),
+          _mm_add_ps(_mm_load_ps(lanes + 8), _mm_load_ps(lanes + 12))));
+    }
+  };
+
+  template <>
+  struct simd<isa::avx512, double> final {
+    using value_type = double;
+    using reg = __m512d;
+    static constexpr std::size_t width = 8;
+
+    static reg zero() noexcept { return _mm512_setzero_pd(); }
+    static reg set1(double v) noexcept { return _mm512_set1_pd(v); }
+    static reg load(const double* p) noexcept { return _mm512_loadu_pd(p); }
+    static void store(double* p, reg v) noexcept { _mm512_storeu_pd(p, v); }
+    static reg add(reg a, reg b) noexcept { return _mm512_add_pd(a, b); }
+    static reg sub(reg a, reg b) noexcept { return _mm512_sub_pd(a, b); }
+    static reg mul(reg a, reg b) noexcept { return _mm512_mul_pd(a, b); }
+    static reg div(reg a, reg b) noexcept { return _mm512_div_pd(a, b); }
+    static reg sqrt(reg a) noexcept {
+      return _mm512_maskz_sqrt_pd(__mmask8(0xff), a);
+    }
+    static reg fmadd(reg a, reg b, reg c) noexcept {
+      return _mm512_fmadd_pd(a, b, c);
+    }
+    static reg max(reg a, reg b) noexcept {
+      return _mm512_maskz_max_pd(__mmask8(0xff), a, b);
+    }
+    static reg min(reg a, reg b) noexcept {
+      return _mm512_maskz_min_pd(__mmask8(0xff), a, b);
+    }
+    static reg round(reg a) noexcept {
+      const auto magic = set1(0x1.8p52);
+      return _mm512_sub_pd(_mm512_add_pd(a, magic), magic);
+    }
+    static reg pow2(reg n) noexcept {
+      const auto bits =
+          _mm512_castpd_si512(_mm512_add_pd(n, set1(0x1.8p52)));
+      return _mm512_castsi512_pd(_mm512_maskz_slli_epi64(__mmask8(0xff),
+          _mm512_add_epi64(bits,
+              _mm512_set1_epi64(1023 - 0x4338000000000000)), 52));
+    }
+    static reg select_positive(reg x, reg a, reg b) noexcept {
+      return _mm512_mask_blend_pd(
+          _mm512_cmp_pd_mask(x, zero(), _CMP_GT_OQ), b, a);
+    }
+    static double reduce(reg v) noexcept {
+      alignas(64) double lanes[width];
+      _mm512_store_pd(lanes, v);
+      return simd<isa::sse2, double>::reduce(_mm_add_pd(
+          _mm_add_pd(_mm_load_pd(lanes), _mm_load_pd(lanes + 2)),
+          _mm_add_pd(_mm_load_pd(lanes + 4), _mm_load_pd(lanes + 6))));
+    }
+  };
+#endif
+
+  template <isa Isa, std::floating_point T>
+  inline T dot(std::size_t n, const T* x, const T* y) noexcept {
+    using simd = detail::simd<Isa, T>;
+    constexpr auto w = simd::width;
+
+    auto acc0 = simd::zero();
+    auto acc1 = simd::zero();
+    auto acc2 = simd::zero();
+    auto acc3 = simd::zero();
+
+    std::size_t i = 0;
+    for (; i + 4 * w <= n; i += 4 * w) {
+      acc0 = simd::fmadd(simd::load(x + i), simd::load(y + i), acc0);
+      acc1 = simd::fmadd(
+          simd::load(x + i + w), simd::load(y + i + w), acc1);
+      acc2 = simd::fmadd(
+          simd::load(x + i + 2 * w), simd::load(y + i + 2 * w), acc2);
+      acc3 = simd::fmadd(
+          simd::load(x + i + 3 * w), simd::load(y + i + 3 * w), acc3);
+    }
+    for (; i + w <= n; i += w) {
+      acc0 = simd::fmadd(simd::load(x + i), simd::load(y + i), acc0);
+    }
+
+    auto result = simd::reduce(
+        simd::add(simd::add(acc0, acc1), simd::add(acc2, acc3)));
+    for (; i < n; ++i) {
+      result += x[i] * y[i];
+    }
+    return result;
+  }
+
+  template <isa Isa, std::floating_point T>
+  inline void axpy(std::size_t n, T alpha, const T* x, T* y) noexcept {
+    using simd = detail::simd<Isa, T>;
+    constexpr auto w = simd::width;
+
+    const auto a = simd::set1(alpha);
+
+    std::size_t i = 0;
+    for (; i + 2 * w <= n; i += 2 * w) {
+      simd::store(y + i, simd::fmadd(a, simd::load(x + i), simd::load(y + i)));
+      simd::store(y + i + w,
+          simd::fmadd(a, simd::load(x + i + w), simd::load(y + i + w)));
+    }
+    for (; i + w <= n; i += w) {
+      simd::store(y + i, simd::fmadd(a, simd::load(x + i), simd::load(y + i)));
+    }
+    for (; i < n; ++i) {
+      y[i] += alpha * x[i];
+    }
+  }
+}
+
+namespace ami::kernel {
+
+  // x . y
+  template <isa Isa = native_isa, std::floating_point T>
+  requires is_available_v<Isa>
+  constexpr T dot(std::size_t n, const T* x, const T* y) noexcept {
+    if constexpr (Isa != isa::scalar) {
+      if (!std::is_constant_evaluated()) {
+        return detail::dot<Isa>(n, x, y);
+      }
+    }
+
+    T result{};
+    for (std::size_t i = 0; i < n; ++i) {
+      result += x[i] * y[i];
+    }
+    return result;
+  }
+
+  // y += alpha * x
+  template <isa Isa = native_isa, std::floating_point T>
+  requires is_available_v<Isa>
+  constexpr void axpy(std::size_t n, T alpha, const T* x, T* y) noexcept {
+    if constexpr (Isa != isa::scalar) {
+      if (!std::is_constant_evaluated()) {
+        detail::axpy<Isa>(n, alpha, x, y);
+        return;
+      }
+    }
+
+    for (std::size_t i = 0; i < n; ++i) {
+      y[i] += alpha * x[i];
+    }
+  }
+}
@@ -0,0 +1,186 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <concepts>
+#include <cstddef>
+#include <execution>
+#include <ranges>
+#include <type_traits>
+
+#include "ami/concepts/execution_policy.hpp"
+#include "ami/kernel/gemm.hpp"
+#include "ami/kernel/simd.hpp"
+#include "ami/utility/parallel_algorithm.hpp"
+
+// Kernels over compressed sparse rows (CSR): the nonzeros of row i of a
+// matrix are entries offsets[i] to offsets[i + 1] of indices, holding their
+// columns, and of the values. A sparse vector is its nonzero values and
+// their indices alone. Every kernel does work in proportion to the
+// nonzeros and splits the rows into blocks of sparse_rows under the
+// parallel policies.
+
+namespace ami::kernel {
+
+  inline constexpr std::size_t sparse_rows = 64;
+}
+
+namespace ami::kernel::detail {
+
+  // Sum of values[p] * x[indices[p]] over the entries [begin, end) of a
+  // row, four products in flight so the loads overlap. The products are
+  // fused where the target has FMA: compilers vectorize unfused chains
+  // with emulated gathers, which cost more than the scalar loads they
+  // replace; fused chains stay scalar.
+  template <std::floating_point T, std::unsigned_integral Index>
+  T sparse_dot(
+      std::size_t begin, std::size_t end, const Index* indices,
+      const T* values, const T* x) {
+    std::array<T, 4> acc{};
+    auto p = begin;
+    for (; p + 4 <= end; p += 4) {
+      for (std::size_t l = 0; l < 4; ++l) {
+        acc[l] = multiply_add(values[p + l], x[indices[p + l]], acc[l]);
+      }
+    }
+    for (; p < end; ++p) {
+      acc[0] = multiply_add(values[p], x[indices[p]], acc[0]);
+    }
+    return (acc[0] + acc[1]) + (acc[2] + acc[3]);
+  }
+
+  // y[indices[p]] += x_i * values[p] over the nonzeros of rows [begin, end).
+  template <std::floating_point T, std::unsigned_integral Index>
+  void sparse_scatter(
+      std::size_t begin, std::size_t end, const Index* offsets,
+      const Index* indices, const T* values, const T* x, T* y) {
+    for (auto i = begin; i < end; ++i) {
+      const auto xi = x[i];
+      const std::size_t last = offsets[i + 1];
+      for (std::size_t p = offsets[i]; p < last; ++p) {
+        y[indices[p]] += xi * values[p];
+      }
+    }
+  }
+
+  template <execution_policy auto P, class F>
+  void for_each_row_block(std::size_t m, F f) {
+    utility::for_each<P>(
+        std::views::iota(std::size_t{}, ceil_div(m, sparse_rows)),
+        [&](auto block) {
+          const auto end = std::min(m, (block + 1) * sparse_rows);
+          for (auto i = block * sparse_rows; i < end; ++i) {
+            f(i);
+          }
+        });
+  }
+}
+
+namespace ami::kernel {
+
+  // y(m) += A(m x n) * x(n), A in CSR. Each finished y_i is replaced by
+  // epilogue(i, y_i) before it is stored.
+  template <execution_policy auto P = std::execution::seq,
+            std::floating_point T, std::unsigned_integral Index,
+            class Epilogue = identity_epilogue>
+  requires std::is_invocable_r_v<T, Epilogue&, std::size_t, T>
+  void spmv(
+      std::size_t m, const Index* offsets, const Index* indices,
+      const T* values, const T* x, T* y, Epilogue epilogue = {}) {
+    if constexpr (adaptive_policy<P>) {
+      return utility::resolve<P>(offsets[m], [&]<execution_policy auto Q> {
+            spmv<Q>(m, offsets, indices, values, x, y, epilogue);
+          });
+    }
+
+    detail::for_each_row_block<P>(m, [&](std::size_t i) {
+          const auto sum = detail::sparse_dot(
+              offsets[i], offsets[i + 1], indices, values, x);
+          y[i] = epilogue(i, y[i] + sum);
+        });
+  }
+
+  // y(m) += A(m x n) * x(n) for a dense, row major A with leading dimension
+  // lda and a sparse x, its nnz nonzeros values at indices: only the columns
+  // of A at indices are read.
+  template <execution_policy auto P = std::execution::seq,
+            std::floating_point T, std::unsigned_integral Index,
+            class Epilogue = identity_epilogue>
+  requires std::is_invocable_r_v<T, Epilogue&, std::size_t, T>
+  void gemv_sparse(
+      std::size_t m, const T* a, std::size_t lda, std::size_t nnz,
+      const Index* indices, const T* values, T* y, Epilogue epilogue = {}) {
+    if constexpr (adaptive_policy<P>) {
+      return utility::resolve<P>(m * nnz, [&]<execution_policy auto Q> {
+            gemv_sparse<Q>(m, a, lda, nnz, indices, values, y, epilogue);
+          });
+    }
+
+    detail::for_each_row_block<P>(m, [&](std::size_t i) {
+          const auto sum = detail::sparse_dot(
+              std::size_t{}, nnz, indices, values, a + i * lda);
+          y[i] = epilogue(i, y[i] + sum);
+        });
+  }
+
+  // y(n) += A(m x n)^T * x(m), A in CSR: every row adds x_i times its
+  // nonzeros into y, reading A once in order. Under the parallel policies
+  // the rows are cut into blocks each adding into a partial of y of its
+  // own, no more blocks than there are nonzeros per column of A, so the
+  // partials never outweigh the matrix.
+  template <execution_policy auto P = std::execution::seq,
+            std::floating_point T, std::unsigned_integral Index>
+  void spmv_t(
+      std::size_t m, std::size_t n, const Index* offsets,
+      const Index* indices, const T* values, const T* x, T* y) {
+    if constexpr (adaptive_policy<P>) {
+      return utility::resolve<P>(offsets[m], [&]<execution_policy auto Q> {
+            spmv_t<Q>(m, n, offsets, indices, values, x, y);
+          });
+    }
+
+    if constexpr (!sequenced_policy<P> && !unsequenced_policy<P>) {
+      const auto blocks = std::min(detail::ceil_div(m, sparse_rows),
+          offsets[m] / std::max(n, std::size_t{1}));
+      if (blocks > 1 && !utility::in_parallel_region()) {
+        const auto rows = detail::ceil_div(m, blocks);
+        detail::reduce_blocks<P>(blocks, n, y,
+            [&](std::size_t block, T* partial) {
+              detail::sparse_scatter(block * rows,
+                  std::min(m, (block + 1) * rows), offsets, indices, values,
+                  x, partial);
+            });
+        return;
+      }
+    }
+    detail::sparse_scatter(0, m, offsets, indices, values, x, y);
+  }
+
+  // A += X(k x m)^T * Y(k x n) at the nonzeros of A only, A in CSR: the
+  // sampled product of two dense matrices. X and Y are row major with
+  // leading dimensions ldx and ldy; for k = 1 this is the outer product
+  // x * y^T restricted to the nonzeros.
+  template <execution_policy auto P = std::execution::seq,
+            std::floating_point T, std::unsigned_integral Index>
+  void sddmm(
+      std::size_t k, std::size_t m, const Index* offsets,
+      const Index* indices, const T* x, std::size_t ldx,
+      const T* y, std::size_t ldy, T* values) {
+    if constexpr (adaptive_policy<P>) {
+      return utility::resolve<P>(k * offsets[m], [&]<execution_policy auto Q> {
+            sddmm<Q>(k, m, offsets, indices, x, ldx, y, ldy, values);
+          });
+    }
+
+    detail::for_each_row_block<P>(m, [&](std::size_t i) {
+          const std::size_t end = offsets[i + 1];
+          for (std::size_t b = 0; b < k; ++b) {
+            const auto xi = x[b * ldx + i];
+            const auto* yb = y + b * ldy;
+            for (std::size_t p = offsets[i]; p < end; ++p) {
+              values[p] += xi * yb[indices[p]];
+            }
+          }
+        });
+  }
+}
@@ -1,9 +1,12 @@
 #pragma once
 
+#include <algorithm>
 #include <array>
 #include <concepts>
 #include <cstddef>
 #include <execution>
+#include <ranges>
+#include <span>
 
 #include "ami/concepts/activation_function.hpp"
 #include "ami/concepts/execution_policy.hpp"
@@ -22,27 +25,112 @@ namespace ami {
       using forward_type = input_type;
       using backward_type = input_type;
       using delta_type = input_type;
+      using function_type = F;
 
       // Public Static Members
       static constexpr size_type input_size = Size;
       static constexpr size_type output_size = Size;
 
+      // Elements per task when a batch form runs under a parallel policy.
+      static constexpr size_type chunk_size = 1024;
+
+      // With F::df_from_output the layer back propagates from its output,
+      // so a model may write the output over the input.
+      static constexpr bool backward_from_output =
+          output_activation_function<F>;
+
       // Public Static Methods
       template <execution_policy auto P = std::execution::seq>
       static constexpr forward_type forward(const input_type& input) {
         forward_type result{};
-        utility::transform<P>(input, result.begin(), F::template f<real_type>);
+        forward<P>(input, result);
         return result;
       }
 
+      template <execution_policy auto P = std::execution::seq>
+      static constexpr void forward(
+          const input_type& input, forward_type& result) {
+        if constexpr (batch_activation_function<F, real_type>) {
+          for_each_chunk<P>([&](size_type begin, size_type end) {
+                F::f_batch(std::span<const real_type>{input}.subspan(
+                               begin, end - begin),
+                    std::span{result}.subspan(begin, end - begin));
+              });
+        } else {
+          utility::transform<P>(
+              input, result.begin(), F::template f<real_type>);
+        }
+      }
+
       template <execution_policy auto P = std::execution::seq>
       static constexpr backward_type backward(
           const input_type& input, const delta_type& delta) {
         backward_type result{};
-        utility::transform<P>(input, delta, result.begin(),
-            [](auto&& input, auto&& delta) { return F::df(input) * delta; });
+        backward<P>(input, delta, result);
+        return result;
+      }
+
+      template <execution_policy auto P = std::execution::seq>
+      static constexpr void backward(
+          const input_type& input, const delta_type& delta,
+          backward_type& result) {
+        if constexpr (batch_activation_function<F, real_type>) {
+          for_each_chunk<P>([&](size_type begin, size_type end) {
+                F::df_batch(std::span<const real_type>{input}.subspan(
+                                begin, end - begin),
+                    std::span<const real_type>{delta}.subspan(
+                        begin, end - begin),
+                    std::span{result}.subspan(begin, end - begin));
+              });
+        } else {
+          utility::transform<P>(input, delta, result.begin(),
+              [](auto&& input, auto&& delta) {
+                return F::df(input) * delta;
+              });
+        }
+      }
+
+      // Backward from the output of forward instead of its input.
+      template <execution_policy auto P = std::execution::seq>
+      requires output_activation_function<F>
+      static constexpr backward_type backward_output(
+          const forward_type& output, const delta_type& delta) {
+        backward_type result{};
+        backward_output<P>(output, delta, result);
         return result;
       }
+
+      template <execution_policy auto P = std::execution::seq>
+      requires output_activation_function<F>
+      static constexpr void backward_output(
+          const forward_type& output, const delta_type& delta,
+          backward_type& result) {
+        utility::transform<P>(output, delta, result.begin(),
+            [](auto&& output, auto&& delta) {
+              return F::df_from_output(output) * delta;
+            });
+      }
+
+    private:
+      // Calls body(begin, end) on the whole range under seq and unseq,
+      // and on chunk_size pieces in parallel otherwise.
+      template <execution_policy auto P, class Body>
+      static constexpr void for_each_chunk(Body body) {
+        if constexpr (adaptive_policy<P>) {
+          utility::resolve<P>(Size, [&]<execution_policy auto Q> {
+                for_each_chunk<Q>(body);
+              });
+        } else if constexpr (sequenced_policy<P> || unsequenced_policy<P> ||
+                             Size <= chunk_size) {
+          body(size_type{}, Size);
+        } else {
+          constexpr auto chunks = (Size + chunk_size - 1) / chunk_size;
+          utility::for_each<P>(std::views::iota(size_type{}, chunks),
+              [&](size_type c) {
+                body(c * chunk_size, std::min(Size, (c + 1) * chunk_size));
+              });
+        }
+      }
     };
   };
 
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <concepts>
+#include <type_traits>
 
 #include "ami/concepts/execution_policy.hpp"
 #include "ami/concepts/optimizer.hpp"
@@ -8,11 +9,15 @@
 
 namespace ami {
 
-  template <std::floating_point RealType>
+  // Storage is either RealType or RealType& referring into a parameter
+  // buffer.
+  template <std::floating_point RealType, class Storage = RealType>
+  requires std::same_as<std::remove_cvref_t<Storage>, RealType>
   class bias final {
   public:
     // Public Types
-    using real_type = RealType;
+    using real_type    = RealType;
+    using storage_type = Storage;
 
     template <optimizer Optimizer>
     using optimizer_type = Optimizer;
@@ -20,7 +25,7 @@ namespace ami {
     // Constructor
     bias() = default;
 
-    explicit constexpr bias(real_type value) noexcept : value_{value} {}
+    explicit constexpr bias(storage_type value) noexcept : value_{value} {}
 
     // Public Static Methods
     template <execution_policy auto P = std::execution::seq>
@@ -40,6 +45,6 @@ namespace ami {
 
   private:
     // Private Members
-    real_type value_{};
+    storage_type value_{};
   };
 }
@@ -4,15 +4,22 @@
 #include <array>
 #include <concepts>
 #include <cstddef>
+#include <ranges>
 #include <type_traits>
 
 #include "ami/concepts/execution_policy.hpp"
 #include "ami/concepts/optimizer.hpp"
+#include "ami/kernel/convert.hpp"
+#include "ami/kernel/simd.hpp"
 #include "ami/utility/atomic_operation.hpp"
 #include "ami/utility/parallel_algorithm.hpp"
 
 namespace ami {
-  template<std::floating_point RealType, std::size_t Size>
+  // Storage is either the owning std::array or a std::span viewing a row of
+  // a weight_matrix. A view of 16 bit weights is read-only; forward and
+  // backward widen them to RealType as they go.
+  template<std::floating_point RealType, std::size_t Size,
+           class Storage = std::array<RealType, Size>>
   requires (Size > 0)
   class node final {
   public:
@@ -20,6 +27,7 @@ namespace ami {
     using size_type     = std::size_t;
     using real_type     = RealType;
     using value_type    = std::array<RealType, Size>;
+    using storage_type  = Storage;
     using input_type    = value_type;
     using forward_type  = real_type;
     using backward_type = value_type;
@@ -33,13 +41,21 @@ namespace ami {
     // Constructor
     node() = default;
 
-    explicit constexpr node(const value_type& value) noexcept : value_{value} {}
+    explicit constexpr node(const value_type& value) noexcept
+    requires std::same_as<storage_type, value_type>
+      : value_{value} {}
 
     explicit constexpr node(value_type&& value) noexcept
+    requires std::same_as<storage_type, value_type>
       : value_{std::move(value)} {}
 
+    explicit constexpr node(storage_type storage) noexcept
+    requires (!std::same_as<storage_type, value_type>)
+      : value_{storage} {}
+
     template <std::invocable Func>
-    requires std::constructible_from<real_type, std::invoke_result_t<Func>>
+    requires std::same_as<storage_type, value_type> &&
+             std::constructible_from<real_type, std::invoke_result_t<Func>>
     explicit constexpr node(Func func) noexcept(noexcept(func()))
       : value_ { [func]<std::size_t... I>(std::index_sequence<I...>) mutable {
           return value_type{(static_cast<void>(I), func())...};
@@ -49,24 +65,55 @@ namespace ami {
     template <execution_policy auto P = std::execution::seq>
     static constexpr void calc_gradient(
         const input_type& input, real_type delta, value_type& result) {
-      utility::for_each<P>(std::views::iota(size_type{}, size),
-          [&, delta](auto i) {
-            utility::fetch_add<P>(result[i], delta * input[i]);
-          });
+      if constexpr (adaptive_policy<P>) {
+        utility::resolve<P>(size, [&]<execution_policy auto Q> {
+              calc_gradient<Q>(input, delta, result);
+            });
+      } else if constexpr (sequenced_policy<P> || unsequenced_policy<P>) {
+        kernel::axpy(size, delta, input.data(), result.data());
+      } else {
+        // Nested in a parallel region the loop runs sequentially, but other
+        // threads may still be adding to result.
+        utility::for_each<P>(std::views::iota(size_type{}, size),
+            [&, delta](auto i) {
+              utility::fetch_add<P>(result[i], delta * input[i]);
+            });
+      }
     }
 
     // Public Methods
     template <execution_policy auto P = std::execution::seq>
     constexpr real_type forward(const input_type& input) const {
-      return utility::transform_reduce<P>(value_, input, real_type{});
+      if constexpr (adaptive_policy<P>) {
+        return utility::resolve<P>(size, [&]<execution_policy auto Q> {
+              return forward<Q>(input);
+            });
+      } else {
+        if constexpr (!sequenced_policy<P> && !unsequenced_policy<P> &&
+                      std::same_as<std::ranges::range_value_t<storage_type>,
+                                   real_type>) {
+          if (!utility::in_parallel_region()) {
+            return utility::transform_reduce<P>(value_, input, real_type{});
+          }
+        }
+        return kernel::dot(size, value_.data(), input.data());
+      }
     }
 
     template <execution_policy auto P = std::execution::seq>
     constexpr void backward(real_type delta, backward_type& result) const {
-      utility::for_each<P>(std::views::iota(size_type{}, size),
-          [&, delta](auto i) {
-            utility::fetch_add<P>(result[i], delta * value_[i]);
-          });
+      if constexpr (adaptive_policy<P>) {
+        utility::resolve<P>(size, [&]<execution_policy auto Q> {
+              backward<Q>(delta, result);
+            });
+      } else if constexpr (sequenced_policy<P> || unsequenced_policy<P>) {
+        kernel::axpy(size, delta, value_.data(), result.data());
+      } else {
+        utility::for_each<P>(std::views::iota(size_type{}, size),
+            [&, delta](auto i) {
+              utility::fetch_add<P>(result[i], delta * value_[i]);
+            });
+      }
     }
 
     template <execution_policy auto P = std::execution::seq, class Optimizer>
@@ -78,12 +125,23 @@ namespace ami {
     }
 
     // Getter
-    constexpr value_type value() const& noexcept { return value_; }
+    constexpr value_type value() const& noexcept {
+      if constexpr (std::same_as<storage_type, value_type>) {
+        return value_;
+      } else {
+        value_type result{};
+        std::ranges::copy(value_, result.begin());
+        return result;
+      }
+    }
 
-    constexpr value_type value() && noexcept { return std::move(value_); }
+    constexpr value_type value() && noexcept
+    requires std::same_as<storage_type, value_type> {
+      return std::move(value_);
+    }
 
   private:
     // Private Members
-    value_type value_{};
+    storage_type value_{};
   };
 }
@@ -0,0 +1,19 @@
+#pragma once
+
+#include <concepts>
+#include <cstdint>
+
+namespace ami {
+
+  // An active input of a sparse input vector, for layers taking inputs as
+  // lists of (index, value) pairs; a one hot feature has value 1. Inputs
+  // missing from a list are zero.
+  template <std::floating_point RealType>
+  struct sparse_feature final {
+    std::uint32_t index;
+    RealType      value;
+
+    friend constexpr bool operator==(
+        const sparse_feature&, const sparse_feature&) = default;
+  };
+}
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <array>
+#include <concepts>
+#include <cstddef>
+#include <span>
+
+#include "ami/utility/half_precision.hpp"
+
+namespace ami {
+
+  enum class row_padding { none, cache_line };
+
+  // RealType may also be a 16 bit storage format, for the working copy of a
+  // mixed precision layer.
+  template <real_storage RealType, std::size_t Rows, std::size_t Cols,
+            row_padding Padding = row_padding::none>
+  requires (Rows > 0 && Cols > 0)
+  class weight_matrix final {
+  public:
+    // Public Types
+    using size_type      = std::size_t;
+    using real_type      = RealType;
+    using row_type       = std::span<real_type, Cols>;
+    using const_row_type = std::span<const real_type, Cols>;
+
+    // Public Static Members
+    static constexpr size_type alignment = 64;
+    static constexpr size_type rows = Rows;
+    static constexpr size_type cols = Cols;
+    static constexpr size_type leading_dimension =
+        (Padding == row_padding::none) ? cols :
+        (cols * sizeof(real_type) + alignment - 1) / alignment * alignment /
+            sizeof(real_type);
+    static constexpr size_type size = rows * leading_dimension;
+
+    // Public Methods
+    constexpr real_type* data() noexcept { return data_.data(); }
+
+    constexpr const real_type* data() const noexcept { return data_.data(); }
+
+    constexpr std::span<real_type, size> span() noexcept { return data_; }
+
+    constexpr std::span<const real_type, size> span() const noexcept {
+      return data_;
+    }
+
+    constexpr row_type row(size_type i) noexcept {
+      return row_type{data_.data() + i * leading_dimension, cols};
+    }
+
+    constexpr const_row_type row(size_type i) const noexcept {
+      return const_row_type{data_.data() + i * leading_dimension, cols};
+    }
+
+  private:
+    // Private Members
+    alignas(alignment) std::array<real_type, size> data_{};
+  };
+}
@@ -1,19 +1,49 @@
 #pragma once
 
+#include <algorithm>
 #include <array>
 #include <concepts>
 #include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <ranges>
+#include <span>
+#include <type_traits>
 #include <utility>
+#include <vector>
 
 #include "ami/concepts/execution_policy.hpp"
 #include "ami/concepts/optimizer.hpp"
+#include "ami/kernel/gemm.hpp"
+#include "ami/kernel/sparse.hpp"
 #include "ami/layer/component/bias.hpp"
 #include "ami/layer/component/node.hpp"
+#include "ami/layer/component/sparse_feature.hpp"
+#include "ami/layer/component/weight_matrix.hpp"
+#include "ami/memory/scratch.hpp"
 #include "ami/utility/parallel_algorithm.hpp"
 
+namespace ami::detail {
+
+  template <class Optimizer, std::floating_point RealType,
+            std::size_t InputSize, std::size_t OutputSize>
+  struct dense_optimizer final {
+    using type = std::pair<
+        std::array<std::array<Optimizer, InputSize>, OutputSize>,
+        std::array<Optimizer, OutputSize>>;
+  };
+
+  template <buffer_optimizer_family Optimizer, std::floating_point RealType,
+            std::size_t InputSize, std::size_t OutputSize>
+  struct dense_optimizer<Optimizer, RealType, InputSize, OutputSize> final {
+    using type = typename Optimizer::template type<
+        RealType, OutputSize * (InputSize + 1)>;
+  };
+}
+
 namespace ami {
 
-  template <std::size_t OutputSize>
+  template <std::size_t OutputSize, row_padding Padding = row_padding::none>
   requires (OutputSize > 0)
   struct dense_layer final {
     template <std::floating_point RealType, std::size_t InputSize>
@@ -25,6 +55,11 @@ namespace ami {
       using real_type  = RealType;
       using node_type  = node<RealType, InputSize>;
       using bias_type  = bias<RealType>;
+      using weight_type =
+          weight_matrix<RealType, OutputSize, InputSize, Padding>;
+      using node_view_type =
+          node<RealType, InputSize, typename weight_type::row_type>;
+      using bias_view_type = bias<RealType, RealType&>;
       using value_type = std::pair<
           std::array<typename node_type::value_type, OutputSize>,
           std::array<real_type, OutputSize>>;
@@ -34,124 +69,465 @@ namespace ami {
       using delta_type = forward_type;
       using gradient_type = value_type;
 
-      template <optimizer Optimizer>
-      using optimizer_type =
-          std::pair<std::array<typename node_type::template
-              optimizer_type<Optimizer>, OutputSize>,
-          std::array<Optimizer, OutputSize>>;
+      // Sparse inputs are lists of features. Their gradient holds the
+      // weight columns of the inputs they touched only, in ascending order
+      // of input, column c being weights[c * output_size, +output_size).
+      using feature_type = sparse_feature<real_type>;
+
+      struct sparse_gradient_type final {
+        std::vector<std::uint32_t> inputs{};
+        std::vector<real_type> weights{};
+        std::array<real_type, OutputSize> biases{};
+
+        friend bool operator==(
+            const sparse_gradient_type&, const sparse_gradient_type&) = default;
+      };
+
+      // Per scalar optimizers are stored per weight; a buffer optimizer
+      // family is bound to parameter_size and updates the layer at once.
+      template <class Optimizer>
+      requires optimizer<Optimizer> || buffer_optimizer_family<Optimizer>
+      using optimizer_type = typename detail::dense_optimizer<
+          Optimizer, RealType, InputSize, OutputSize>::type;
 
       // Public Static Members
       static constexpr size_type input_size  = InputSize;
       static constexpr size_type output_size = OutputSize;
+      static constexpr size_type leading_dimension =
+          weight_type::leading_dimension;
+      static constexpr size_type parameter_size =
+          output_size * (input_size + 1);
+
+      // Cache sized outputs x inputs block of the weights; calc_gradient and
+      // the per scalar update are scheduled over these tiles.
+      static constexpr utility::tile partition{
+          std::min(output_size, kernel::gemm_tile<real_type>.rows),
+          std::min(input_size, kernel::gemm_tile<real_type>.cols)};
 
       // Constructor
       type() = default;
 
-      explicit constexpr type(const value_type& value)
-          : nodes_{[&value = value.first]<std::size_t... I>(
-                std::index_sequence<I...>) {
-              return std::array<node_type, output_size>{
-                  (static_cast<void>(I), node_type{(value.first)[I]})...};
-            }(std::make_index_sequence<output_size>{})},
-            bias_{[&value = value.second]<std::size_t... I>(
-                std::index_sequence<I...>) {
-              return std::array<bias_type, output_size>{
-                  (static_cast<void>(I), bias_type{(value.second)[I]})...};
-            }(std::make_index_sequence<output_size>{})}
-      {}
+      explicit constexpr type(const value_type& value) : bias_{value.second} {
+        for (size_type i = 0; i < output_size; ++i) {
+          std::ranges::copy(value.first[i], weight_.row(i).begin());
+        }
+      }
 
       explicit constexpr type(value_type&& value)
-          : nodes_{[value = std::move(value.first)]<std::size_t... I>(
-                std::index_sequence<I...>) {
-              return std::array<node_type, output_size>{
-                  (static_cast<void>(I), node_type{std::move(value[I])})...};
-            }(std::make_index_sequence<output_size>{})},
-            bias_{[value = std::move(value.second)]<std::size_t... I>(
-                std::index_sequence<I...>) {
-              return std::array<bias_type, output_size>{
-                  (static_cast<void>(I), bias_type{std::move(value[I])})...};
-            }(std::make_index_sequence<output_size>{})}
-      {}
+          : bias_{std::move(value.second)} {
+        for (size_type i = 0; i < output_size; ++i) {
+          std::ranges::move(value.first[i], weight_.row(i).begin());
+        }
+      }
 
       // Public Static Methods
       template <execution_policy auto P = std::execution::seq>
       static constexpr void calc_gradient(
           const input_type& input, const delta_type& delta,
           gradient_type& result) {
-        utility::for_each<P>(std::views::iota(size_type{}, output_size),
-            [&](auto i) {
-              node_type::template calc_gradient(
-                  input, delta[i], result.first[i]);
-              bias_type::template calc_gradient(delta[i], result.second[i]);
+        kernel::ger<P>(output_size, input_size, delta.data(), input.data(),
+            result.first.front().data(), input_size);
+        for (size_type i = 0; i < output_size; ++i) {
+          result.second[i] += delta[i];
+        }
+      }
+
+      template <execution_policy auto P = std::execution::seq>
+      static constexpr void calc_gradient(
+          std::span<const input_type> input, std::span<const delta_type> delta,
+          gradient_type& result) {
+        if (input.empty()) {
+          return;
+        }
+        kernel::gemm<P>(output_size, input_size, input.size(),
+            kernel::col_major(delta.front().data(), output_size),
+            kernel::row_major(input.front().data(), input_size),
+            kernel::row_major(result.first.front().data(), input_size));
+        for (const auto& d : delta) {
+          for (size_type i = 0; i < output_size; ++i) {
+            result.second[i] += d[i];
+          }
+        }
+      }
+
+      // Sparse inputs. A feature may appear more than once; its values add
+      // up.
+      template <execution_policy auto P = std::execution::seq>
+      static void calc_gradient(
+          std::span<const feature_type> input, const delta_type& delta,
+          sparse_gradient_type& result) {
+        const std::array inputs{input};
+        calc_gradient<P>(std::span<const std::span<const feature_type>>{inputs},
+            std::span{&delta, 1}, result);
+      }
+
+      // The batch is merged into result at once: the features are sorted by
+      // input, and each touched column is summed from the previous result
+      // and the features of that input.
+      template <execution_policy auto P = std::execution::seq>
+      static void calc_gradient(
+          std::span<const std::span<const feature_type>> input,
+          std::span<const delta_type> delta, sparse_gradient_type& result) {
+        struct entry {
+          std::uint32_t index;
+          std::uint32_t sample;
+          real_type     value;
+        };
+        struct column {
+          std::uint32_t input;
+          size_type     previous;
+          size_type     begin;
+          size_type     end;
+        };
+        constexpr auto none = std::numeric_limits<size_type>::max();
+
+        memory::scratch workspace{};
+        size_type count = 0;
+        for (const auto& x : input) {
+          count += x.size();
+        }
+        const auto entries = workspace.allocate<entry>(count);
+        count = 0;
+        for (size_type b = 0; b < input.size(); ++b) {
+          for (const auto& [index, value] : input[b]) {
+            entries[count++] = {index, static_cast<std::uint32_t>(b), value};
+          }
+        }
+        std::ranges::sort(entries, {}, [](const entry& e) {
+              return std::pair{e.index, e.sample};
             });
+
+        const auto previous = result.inputs.size();
+        const auto columns = workspace.allocate<column>(previous + count);
+        size_type n = 0;
+        for (size_type p = 0, e = 0; p < previous || e < count; ++n) {
+          const auto j =
+              (e == count ||
+               (p < previous && result.inputs[p] <= entries[e].index))
+              ? result.inputs[p] : entries[e].index;
+          columns[n] = {j, none, e, e};
+          if (p < previous && result.inputs[p] == j) {
+            columns[n].previous = p++;
+          }
+          while (e < count && entries[e].index == j) {
+            ++e;
+          }
+          columns[n].end = e;
+        }
+
+        sparse_gradient_type merged{std::vector<std::uint32_t>(n),
+            std::vector<real_type>(n * output_size), result.biases};
+        const auto sum = [&]<execution_policy auto Q> {
+          utility::for_each<Q>(std::views::iota(size_type{}, n), [&](auto c) {
+                const auto& [j, p, begin, end] = columns[c];
+                auto* g = merged.weights.data() + c * output_size;
+                merged.inputs[c] = j;
+                if (p != none) {
+                  std::ranges::copy_n(result.weights.data() + p * output_size,
+                      output_size, g);
+                }
+                for (auto e = begin; e < end; ++e) {
+                  const auto& d = delta[entries[e].sample];
+                  for (size_type i = 0; i < output_size; ++i) {
+                    g[i] += d[i] * entries[e].value;
+                  }
+                }
+              });
+        };
+        if constexpr (adaptive_policy<P>) {
+          utility::resolve<P>(count * output_size, sum);
+        } else {
+          sum.template operator()<P>();
+        }
+        for (const auto& d : delta.first(input.size())) {
+          for (size_type i = 0; i < output_size; ++i) {
+            merged.biases[i] += d[i];
+          }
+        }
+        result = std::move(merged);
       }
 
       // Public Methods
       template <execution_policy auto P = std::execution::seq>
       constexpr forward_type forward(const input_type& input) const {
         forward_type result{};
-        utility::transform<P>(nodes_, bias_, result.begin(),
-            [&input](const auto& node, const auto& bias) {
-              return node.template forward<P>(input) + bias.value();
-            });
+        forward<P>(input, result);
         return result;
       }
 
+      template <execution_policy auto P = std::execution::seq>
+      constexpr void forward(
+          const input_type& input, forward_type& result) const {
+        result = bias_;
+        kernel::gemv<P>(output_size, input_size, weight_.data(),
+            leading_dimension, input.data(), result.data());
+      }
+
+      // Applies epilogue(i, y_i) to each output as the kernel finishes it,
+      // so an elementwise op following the layer costs no extra pass.
+      template <execution_policy auto P = std::execution::seq, class Epilogue>
+      requires std::is_invocable_r_v<
+          real_type, Epilogue&, size_type, real_type>
+      constexpr void forward(
+          const input_type& input, forward_type& result,
+          Epilogue epilogue) const {
+        result = bias_;
+        kernel::gemv<P>(output_size, input_size, weight_.data(),
+            leading_dimension, input.data(), result.data(), epilogue);
+      }
+
+      template <execution_policy auto P = std::execution::seq>
+      constexpr void forward(
+          std::span<const input_type> input,
+          std::span<forward_type> result) const {
+        if (input.empty()) {
+          return;
+        }
+        std::ranges::fill(result.first(input.size()), bias_);
+        kernel::gemm<P>(input.size(), output_size, input_size,
+            kernel::row_major(input.front().data(), input_size),
+            kernel::col_major(weight_.data(), leading_dimension),
+            kernel::row_major(result.front().data(), output_size));
+      }
+
+      // Sparse input: only the weight columns of its features are read.
+      template <execution_policy auto P = std::execution::seq>
+      forward_type forward(std::span<const feature_type> input) const {
+        forward_type result{};
+        forward<P>(input, result);
+        return result;
+      }
+
+      template <execution_policy auto P = std::execution::seq>
+      void forward(
+          std::span<const feature_type> input, forward_type& result) const {
+        forward<P>(input, result, kernel::identity_epilogue{});
+      }
+
+      template <execution_policy auto P = std::execution::seq, class Epilogue>
+      requires std::is_invocable_r_v<
+          real_type, Epilogue&, size_type, real_type>
+      void forward(
+          std::span<const feature_type> input, forward_type& result,
+          Epilogue epilogue) const {
+        memory::scratch workspace{};
+        const auto indices = workspace.allocate<std::uint32_t>(input.size());
+        const auto values = workspace.allocate<real_type>(input.size());
+        for (size_type k = 0; k < input.size(); ++k) {
+          indices[k] = input[k].index;
+          values[k] = input[k].value;
+        }
+        result = bias_;
+        kernel::gemv_sparse<P>(output_size, weight_.data(), leading_dimension,
+            input.size(), indices.data(), values.data(), result.data(),
+            epilogue);
+      }
+
       template <execution_policy auto P = std::execution::seq>
       constexpr backward_type backward(const delta_type& delta) const {
         backward_type result{};
-        utility::for_each<P>(std::views::iota(size_type{}, output_size),
-            [&](auto i) { nodes_[i].template backward(delta[i], result); });
+        backward<P>(delta, result);
         return result;
       }
 
-      template <execution_policy auto P = std::execution::seq, class Optimizer>
+      template <execution_policy auto P = std::execution::seq>
+      constexpr void backward(
+          const delta_type& delta, backward_type& result) const {
+        result = backward_type{};
+        kernel::gemv_t<P>(output_size, input_size, weight_.data(),
+            leading_dimension, delta.data(), result.data());
+      }
+
+      template <execution_policy auto P = std::execution::seq>
+      constexpr void backward(
+          std::span<const delta_type> delta,
+          std::span<backward_type> result) const {
+        if (delta.empty()) {
+          return;
+        }
+        std::ranges::fill(result.first(delta.size()), backward_type{});
+        kernel::gemm<P>(delta.size(), input_size, output_size,
+            kernel::row_major(delta.front().data(), output_size),
+            kernel::row_major(weight_.data(), leading_dimension),
+            kernel::row_major(result.front().data(), input_size));
+      }
+
+      template <execution_policy auto P = std::execution::seq,
+                optimizer Optimizer>
+      constexpr void update(
+          std::pair<std::array<std::array<Optimizer, input_size>, output_size>,
+                    std::array<Optimizer, output_size>>& optimizer,
+          const gradient_type& gradient) {
+        if constexpr (adaptive_policy<P>) {
+          utility::resolve<P>(parameter_size, [&]<execution_policy auto Q> {
+                update<Q>(optimizer, gradient);
+              });
+        } else {
+          utility::for_each_tile<P>(output_size, input_size, partition,
+              [&](auto row_begin, auto row_end, auto col_begin, auto col_end) {
+                for (auto i = row_begin; i < row_end; ++i) {
+                  auto weights = weight_.row(i);
+                  for (auto j = col_begin; j < col_end; ++j) {
+                    optimizer.first[i][j](weights[j], gradient.first[i][j]);
+                  }
+                  if (col_begin == 0) {
+                    bias_view(i).update(
+                        optimizer.second[i], gradient.second[i]);
+                  }
+                }
+              });
+        }
+      }
+
+      // Weights then biases, with the gradient laid out the same way.
+      template <execution_policy auto P = std::execution::seq,
+                buffer_optimizer Optimizer>
+      requires (Optimizer::size == parameter_size)
       constexpr void update(
-          optimizer_type<Optimizer>& optimizer, const gradient_type& gradient) {
-        utility::for_each<P>(std::views::iota(size_type{}, output_size),
-            [&](auto i) {
-              nodes_[i].template update<P>(
-                  optimizer.first[i], gradient.first[i]);
-              bias_[i].update(optimizer.second[i], gradient.second[i]);
+          Optimizer& optimizer, const gradient_type& gradient) {
+        using tensor_type = typename Optimizer::tensor_type;
+        const std::span<const real_type, output_size> bias_gradient{
+            gradient.second};
+
+        if constexpr (leading_dimension == input_size) {
+          const std::array tensors{
+              tensor_type{weight_.span(), std::span{
+                  gradient.first.front().data(), output_size * input_size}},
+              tensor_type{bias_, bias_gradient}};
+          optimizer.template operator()<P>(tensors);
+        } else {
+          std::array<tensor_type, output_size + 1> tensors{};
+          for (size_type i = 0; i < output_size; ++i) {
+            tensors[i] = {weight_.row(i), gradient.first[i]};
+          }
+          tensors.back() = {bias_, bias_gradient};
+          optimizer.template operator()<P>(tensors);
+        }
+      }
+
+      // Only the weights of the inputs in gradient and the biases are
+      // updated.
+      template <execution_policy auto P = std::execution::seq,
+                optimizer Optimizer>
+      void update(
+          std::pair<std::array<std::array<Optimizer, input_size>, output_size>,
+                    std::array<Optimizer, output_size>>& optimizer,
+          const sparse_gradient_type& gradient) {
+        if constexpr (adaptive_policy<P>) {
+          utility::resolve<P>(gradient.weights.size(),
+              [&]<execution_policy auto Q> {
+                update<Q>(optimizer, gradient);
+              });
+        } else {
+          utility::for_each<P>(std::views::iota(size_type{}, output_size),
+              [&](auto i) {
+                auto weights = weight_.row(i);
+                for (size_type c = 0; c < gradient.inputs.size(); ++c) {
+                  const size_type j = gradient.inputs[c];
+                  optimizer.first[i][j](
+                      weights[j], gradient.weights[c * output_size + i]);
+                }
+              });
+          for (size_type i = 0; i < output_size; ++i) {
+            bias_view(i).update(optimizer.second[i], gradient.biases[i]);
+          }
+        }
+      }
+
+      // A lazy step: the moments of untouched weights are left as they
+      // are. Parameters sit in the optimizer's buffers as in the dense
+      // update, weight (i, j) at i * input_size + j and the biases last.
+      // Rows are walked one at a time, so the touched weights of a row
+      // share pages of the weights and the moments.
+      template <execution_policy auto P = std::execution::seq,
+                lazy_optimizer Optimizer>
+      requires (Optimizer::size == parameter_size)
+      void update(Optimizer& optimizer, const sparse_gradient_type& gradient) {
+        using update_type = typename Optimizer::lazy_update_type;
+        optimizer.step([&](const update_type& step) {
+              const auto rows = [&]<execution_policy auto Q> {
+                utility::for_each<Q>(
+                    std::views::iota(size_type{}, output_size),
+                    [&](auto i) {
+                      auto weights = weight_.row(i);
+                      for (size_type c = 0; c < gradient.inputs.size(); ++c) {
+                        const size_type j = gradient.inputs[c];
+                        step(i * input_size + j, weights[j],
+                            gradient.weights[c * output_size + i]);
+                      }
+                    });
+              };
+              if constexpr (adaptive_policy<P>) {
+                utility::resolve<P>(gradient.weights.size(), rows);
+              } else {
+                rows.template operator()<P>();
+              }
+              for (size_type i = 0; i < output_size; ++i) {
+                step(output_size * input_size + i, bias_[i],
+                    gradient.biases[i]);
+              }
             });
       }
 
-      // Getter
-      constexpr auto value() const& noexcept {
-        auto first = [&]<std::size_t... I>(std::index_sequence<I...>) {
-          return typename value_type::first_type{nodes_[I].value()...};
-        }(std::make_index_sequence<output_size>{});
+      // Views
+      constexpr auto weights() noexcept { return weight_.span(); }
 
-        auto second = [&]<std::size_t... I>(std::index_sequence<I...>) {
-          return typename value_type::second_type{bias_[I].value()...};
-        }(std::make_index_sequence<output_size>{});
+      constexpr auto weights() const noexcept { return weight_.span(); }
 
-        return std::pair{std::move(first), std::move(second)};
+      constexpr auto weights(size_type i) noexcept { return weight_.row(i); }
+
+      constexpr auto weights(size_type i) const noexcept {
+        return weight_.row(i);
       }
 
-      constexpr auto value() && noexcept {
-        auto first = [&]<std::size_t... I>(std::index_sequence<I...>) {
-          return typename value_type::first_type{
-              std::move(nodes_[I]).value()...};
-        }(std::make_index_sequence<output_size>{});
+      constexpr std::span<real_type, output_size> biases() noexcept {
+        return bias_;
+      }
 
-        auto second = [&]<std::size_t... I>(std::index_sequence<I...>) {
-          return typename value_type::second_type{
-              std::move(bias_[I]).value()...};
-        }(std::make_index_sequence<output_size>{});
+      constexpr std::span<const real_type, output_size> biases()
+          const noexcept {
+        return bias_;
+      }
 
-        return std::pair{std::move(first), std::move(second)};
+      constexpr node_view_type node_view(size_type i) noexcept {
+        return node_view_type{weight_.row(i)};
+      }
+
+      constexpr bias_view_type bias_view(size_type i) noexcept {
+        return bias_view_type{bias_[i]};
+      }
+
+      // Getter
+      constexpr auto value() const& noexcept {
+        value_type result{{}, bias_};
+        for (size_type i = 0; i < output_size; ++i) {
+          std::ranges::copy(weight_.row(i), result.first[i].begin());
+        }
+        return result;
+      }
+
+      constexpr auto value() && noexcept {
+        value_type result{{}, std::move(bias_)};
+        for (size_type i = 0; i < output_size; ++i) {
+          std::ranges::move(weight_.row(i), result.first[i].begin());
+        }
+        return result;
       }
 
     private:
+      // Batches of arrays are handed to the kernels as flat matrices.
+      static_assert(sizeof(input_type) == sizeof(real_type) * input_size);
+      static_assert(sizeof(forward_type) == sizeof(real_type) * output_size);
+
       // Private Members
-      std::array<node_type, output_size> nodes_{};
-      std::array<bias_type, output_size> bias_{};
+      weight_type weight_{};
+      alignas(weight_type::alignment)
+          std::array<real_type, output_size> bias_{};
     };
   };
 
   template <std::floating_point RealType, std::size_t InputSize,
-            std::size_t OutputSize>
-  using dense_layer_t =
-      typename  dense_layer<OutputSize>::template type<RealType, InputSize>;
+            std::size_t OutputSize, row_padding Padding = row_padding::none>
+  using dense_layer_t = typename dense_layer<OutputSize, Padding>::template
+      type<RealType, InputSize>;
 }
@@ -3,19 +3,64 @@
 #include <array>
 #include <concepts>
 #include <cstddef>
+#include <cstdint>
+#include <execution>
 #include <random>
-#include <utility>
+#include <ranges>
 
 #include "ami/concepts/execution_policy.hpp"
+#include "ami/utility/bit_array.hpp"
 #include "ami/utility/parallel_algorithm.hpp"
+#include "ami/utility/philox.hpp"
 
 namespace ami::detail {
-  template <std::size_t N, std::uniform_random_bit_generator G>
-  inline std::array<bool, N> make_bernouli_array(double p, G& engine) {
-    return [&engine, dist = std::bernoulli_distribution(p)]<std::size_t... I>(
-        std::index_sequence<I...>) mutable {
-          return std::array{(static_cast<void>(I), dist(engine))...};
-        }(std::make_index_sequence<N>{});
+
+  // Bit i is set with probability p. Each unit takes 16 bits of a Philox
+  // block, so p is rounded down to a multiple of 2^-16; the words are
+  // generated in parallel under P, with the same result on every policy.
+  template <execution_policy auto P, std::size_t N>
+  inline utility::bit_array<N> make_bernoulli_mask(
+      double p, utility::philox& engine) {
+    using mask_type = utility::bit_array<N>;
+    using word_type = typename mask_type::word_type;
+    constexpr std::size_t blocks_per_word = mask_type::word_bits / 8;
+
+    const auto threshold = static_cast<std::uint32_t>(p * 65536.0);
+    const auto first =
+        engine.reserve(mask_type::word_count * blocks_per_word);
+
+    mask_type mask{};
+    auto& words = mask.words();
+    utility::for_each<P>(
+        std::views::iota(std::size_t{}, mask_type::word_count),
+        [&](std::size_t w) {
+          word_type word{};
+          for (std::size_t b = 0; b < blocks_per_word; ++b) {
+            const auto block = engine.block(first + w * blocks_per_word + b);
+            for (std::size_t j = 0; j < block.size(); ++j) {
+              const word_type low = (block[j] & 0xffff) < threshold;
+              const word_type high = (block[j] >> 16) < threshold;
+              word |= (low | high << 1) << (8 * b + 2 * j);
+            }
+          }
+          words[w] = word;
+        });
+    if constexpr (N % mask_type::word_bits != 0) {
+      words.back() &= (word_type{1} << (N % mask_type::word_bits)) - 1;
+    }
+    return mask;
+  }
+
+  // Other engines draw one bernoulli variate per bit, in order.
+  template <execution_policy auto P, std::size_t N,
+            std::uniform_random_bit_generator G>
+  inline utility::bit_array<N> make_bernoulli_mask(double p, G& engine) {
+    std::bernoulli_distribution dist{p};
+    utility::bit_array<N> mask{};
+    for (std::size_t i = 0; i < N; ++i) {
+      mask.set(i, dist(engine));
+    }
+    return mask;
   }
 }
 
@@ -33,6 +78,7 @@ namespace ami {
       using forward_type = input_type;
       using backward_type = input_type;
       using delta_type = input_type;
+      using mask_type = utility::bit_array<Size>;
 
       // Public Static Members
       static constexpr size_type input_size = Size;
@@ -40,29 +86,75 @@ namespace ami {
       static constexpr double dropout_rate = DropoutRate;
 
       // Public Static Methods
+
+      // The mask of one training pass; unit i is kept where bit i is set.
+      // With utility::philox it is generated in bulk, in parallel under P.
+      template <execution_policy auto P = std::execution::seq,
+                std::uniform_random_bit_generator G>
+      static mask_type make_mask(G& engine) {
+        return detail::make_bernoulli_mask<P, Size>(dropout_rate, engine);
+      }
+
+      static constexpr real_type apply_mask(
+          real_type input, bool keep) noexcept {
+        return keep ? input / dropout_rate : real_type{0};
+      }
+
+      template <execution_policy auto P = std::execution::seq>
+      static constexpr forward_type forward(
+          const input_type& input, const mask_type& mask) {
+        forward_type result{};
+        forward<P>(input, result, mask);
+        return result;
+      }
+
+      template <execution_policy auto P = std::execution::seq>
+      static constexpr void forward(
+          const input_type& input, forward_type& result,
+          const mask_type& mask) {
+        utility::for_each<P>(std::views::iota(size_type{}, Size),
+            [&](size_type i) { result[i] = apply_mask(input[i], mask[i]); });
+      }
+
+      // Draws a fresh mask; backward needs the mask overloads above.
       template <execution_policy auto P = std::execution::seq,
                 std::uniform_random_bit_generator G>
       static forward_type forward(const input_type& input, G& engine) {
         forward_type result{};
-        utility::transform<P>(
-            input,
-            detail::make_bernouli_array<output_size>(dropout_rate, engine),
-            result.begin(), [](auto&& input, auto p) {
-              return p ? input / dropout_rate : real_type{0};
-            });
+        forward<P>(input, result, engine);
         return result;
       }
 
+      template <execution_policy auto P = std::execution::seq,
+                std::uniform_random_bit_generator G>
+      static void forward(
+          const input_type& input, forward_type& result, G& engine) {
+        forward<P>(input, result, make_mask<P>(engine));
+      }
+
+      // Inference pass; inverted dropout leaves the input unchanged.
+      template <execution_policy auto P = std::execution::seq>
+      static constexpr void forward(
+          const input_type& input, forward_type& result) {
+        result = input;
+      }
+
+      // The derivative of apply_mask is apply_mask itself, so the mask of
+      // the forward pass is applied to delta.
       template <execution_policy auto P = std::execution::seq>
-      static backward_type backward(
-          const forward_type& forward, const delta_type& delta) {
+      static constexpr backward_type backward(
+          const mask_type& mask, const delta_type& delta) {
         backward_type result{};
-        utility::transform<P>(
-            forward, delta, result.begin(), [](auto&& forward, auto&& delta) {
-              return (forward == real_type{0}) ? forward : delta;
-            });
+        backward<P>(mask, delta, result);
         return result;
       }
+
+      template <execution_policy auto P = std::execution::seq>
+      static constexpr void backward(
+          const mask_type& mask, const delta_type& delta,
+          backward_type& result) {
+        forward<P>(delta, result, mask);
+      }
     };
   };
 
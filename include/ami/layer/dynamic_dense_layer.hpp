@@ -0,0 +1,257 @@
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <concepts>
+#include <cstddef>
+#include <memory>
+#include <span>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "ami/concepts/execution_policy.hpp"
+#include "ami/concepts/optimizer.hpp"
+#include "ami/kernel/gemm.hpp"
+#include "ami/layer/component/weight_matrix.hpp"
+#include "ami/utility/aligned_allocator.hpp"
+#include "ami/utility/parallel_algorithm.hpp"
+
+namespace ami {
+
+  // dense_layer with its shape chosen at run time, for models read from a
+  // configuration and for layers too large for std::array members. The
+  // parameters live on the heap, cache line aligned, and every pass runs the
+  // same kernels as dense_layer, only with run time extents; dense_layer
+  // passes its extents as constants, so the kernels still specialise there.
+  //
+  // Inputs, outputs and deltas are flat spans. A span of k * input_size
+  // values is a batch of k samples, one per row, as the span of arrays the
+  // batch overloads of dense_layer take.
+  //
+  // Allocator must return cache line aligned storage; with a
+  // memory::arena_allocator the parameters of consecutive layers, and the
+  // gradients made for them, lie back to back in the arena.
+  template <std::floating_point RealType,
+            row_padding Padding = row_padding::none,
+            class Allocator = utility::aligned_allocator<RealType>>
+  class dynamic_dense_layer final {
+  public:
+    // Public Types
+    using size_type      = std::size_t;
+    using real_type      = RealType;
+    using allocator_type = Allocator;
+    using vector_type    = std::vector<real_type, allocator_type>;
+    using input_type     = vector_type;
+    using forward_type   = vector_type;
+    using backward_type  = vector_type;
+    using delta_type     = vector_type;
+    // Weights row by row without padding, then biases, as dense_layer.
+    using gradient_type  = std::pair<vector_type, vector_type>;
+
+    template <optimizer Optimizer>
+    using optimizer_vector_type = std::vector<Optimizer, typename
+        std::allocator_traits<allocator_type>::template rebind_alloc<Optimizer>>;
+
+    template <optimizer Optimizer>
+    using optimizer_type = std::pair<
+        optimizer_vector_type<Optimizer>, optimizer_vector_type<Optimizer>>;
+
+    // Public Static Members
+    static constexpr size_type alignment = 64;
+
+    // Constructor
+    dynamic_dense_layer() = default;
+
+    dynamic_dense_layer(size_type input_size, size_type output_size,
+                        const allocator_type& allocator = allocator_type{})
+        : input_size_{input_size},
+          output_size_{output_size},
+          leading_dimension_{Padding == row_padding::none ? input_size :
+              (input_size * sizeof(real_type) + alignment - 1) / alignment *
+                  alignment / sizeof(real_type)},
+          weight_(output_size * leading_dimension_, allocator),
+          bias_(output_size, allocator) {}
+
+    // Public Methods
+    gradient_type make_gradient() const {
+      return {vector_type(output_size_ * input_size_, get_allocator()),
+              vector_type(output_size_, get_allocator())};
+    }
+
+    template <optimizer Optimizer>
+    optimizer_type<Optimizer> make_optimizer() const {
+      const typename optimizer_vector_type<Optimizer>::allocator_type
+          allocator{get_allocator()};
+      return {optimizer_vector_type<Optimizer>(
+                  output_size_ * input_size_, allocator),
+              optimizer_vector_type<Optimizer>(output_size_, allocator)};
+    }
+
+    template <execution_policy auto P = std::execution::seq>
+    void calc_gradient(
+        std::span<const real_type> input, std::span<const real_type> delta,
+        gradient_type& result) const {
+      const auto batch = batch_size(input, delta);
+      if (batch == 0) {
+        return;
+      }
+      if (batch == 1) {
+        kernel::ger<P>(output_size_, input_size_, delta.data(), input.data(),
+            result.first.data(), input_size_);
+      } else {
+        kernel::gemm<P>(output_size_, input_size_, batch,
+            kernel::col_major(delta.data(), output_size_),
+            kernel::row_major(input.data(), input_size_),
+            kernel::row_major(result.first.data(), input_size_));
+      }
+      for (size_type b = 0; b < batch; ++b) {
+        for (size_type i = 0; i < output_size_; ++i) {
+          result.second[i] += delta[b * output_size_ + i];
+        }
+      }
+    }
+
+    template <execution_policy auto P = std::execution::seq>
+    forward_type forward(std::span<const real_type> input) const {
+      forward_type result(
+          input.size() / input_size_ * output_size_, get_allocator());
+      forward<P>(input, result);
+      return result;
+    }
+
+    template <execution_policy auto P = std::execution::seq>
+    void forward(
+        std::span<const real_type> input, std::span<real_type> result) const {
+      const auto batch = batch_size(input, result);
+      for (size_type b = 0; b < batch; ++b) {
+        std::ranges::copy(bias_, result.begin() + b * output_size_);
+      }
+      if (batch == 1) {
+        kernel::gemv<P>(output_size_, input_size_, weight_.data(),
+            leading_dimension_, input.data(), result.data());
+      } else if (batch > 1) {
+        kernel::gemm<P>(batch, output_size_, input_size_,
+            kernel::row_major(input.data(), input_size_),
+            kernel::col_major(weight_.data(), leading_dimension_),
+            kernel::row_major(result.data(), output_size_));
+      }
+    }
+
+    // Applies epilogue(i, y_i) to each output of a single sample as the
+    // kernel finishes it.
+    template <execution_policy auto P = std::execution::seq, class Epilogue>
+    requires std::is_invocable_r_v<
+        real_type, Epilogue&, size_type, real_type>
+    void forward(
+        std::span<const real_type> input, std::span<real_type> result,
+        Epilogue epilogue) const {
+      assert(input.size() == input_size_ && result.size() == output_size_);
+      std::ranges::copy(bias_, result.begin());
+      kernel::gemv<P>(output_size_, input_size_, weight_.data(),
+          leading_dimension_, input.data(), result.data(), epilogue);
+    }
+
+    template <execution_policy auto P = std::execution::seq>
+    backward_type backward(std::span<const real_type> delta) const {
+      backward_type result(
+          delta.size() / output_size_ * input_size_, get_allocator());
+      backward<P>(delta, result);
+      return result;
+    }
+
+    template <execution_policy auto P = std::execution::seq>
+    void backward(
+        std::span<const real_type> delta, std::span<real_type> result) const {
+      const auto batch = batch_size(result, delta);
+      std::ranges::fill(result.first(batch * input_size_), real_type{});
+      if (batch == 1) {
+        kernel::gemv_t<P>(output_size_, input_size_, weight_.data(),
+            leading_dimension_, delta.data(), result.data());
+      } else if (batch > 1) {
+        kernel::gemm<P>(batch, input_size_, output_size_,
+            kernel::row_major(delta.data(), output_size_),
+            kernel::row_major(weight_.data(), leading_dimension_),
+            kernel::row_major(result.data(), input_size_));
+      }
+    }
+
+    template <execution_policy auto P = std::execution::seq,
+              optimizer Optimizer>
+    void update(
+        optimizer_type<Optimizer>& optimizer, const gradient_type& gradient) {
+      if constexpr (adaptive_policy<P>) {
+        utility::resolve<P>(parameter_size(), [&]<execution_policy auto Q> {
+              update<Q>(optimizer, gradient);
+            });
+      } else {
+        const utility::tile partition{
+            std::min(output_size_, kernel::gemm_tile<real_type>.rows),
+            std::min(input_size_, kernel::gemm_tile<real_type>.cols)};
+        utility::for_each_tile<P>(output_size_, input_size_, partition,
+            [&](auto row_begin, auto row_end, auto col_begin, auto col_end) {
+              for (auto i = row_begin; i < row_end; ++i) {
+                auto* weights = weight_.data() + i * leading_dimension_;
+                const auto offset = i * input_size_;
+                for (auto j = col_begin; j < col_end; ++j) {
+                  optimizer.first[offset + j](
+                      weights[j], gradient.first[offset + j]);
+                }
+                if (col_begin == 0) {
+                  optimizer.second[i](bias_[i], gradient.second[i]);
+                }
+              }
+            });
+      }
+    }
+
+    // Views
+    std::span<real_type> weights() noexcept { return weight_; }
+
+    std::span<const real_type> weights() const noexcept { return weight_; }
+
+    std::span<real_type> weights(size_type i) noexcept {
+      return {weight_.data() + i * leading_dimension_, input_size_};
+    }
+
+    std::span<const real_type> weights(size_type i) const noexcept {
+      return {weight_.data() + i * leading_dimension_, input_size_};
+    }
+
+    std::span<real_type> biases() noexcept { return bias_; }
+
+    std::span<const real_type> biases() const noexcept { return bias_; }
+
+    // Getter
+    allocator_type get_allocator() const { return weight_.get_allocator(); }
+
+    size_type input_size() const noexcept { return input_size_; }
+
+    size_type output_size() const noexcept { return output_size_; }
+
+    size_type leading_dimension() const noexcept { return leading_dimension_; }
+
+    size_type parameter_size() const noexcept {
+      return output_size_ * (input_size_ + 1);
+    }
+
+  private:
+    // Private Methods
+
+    // Samples in a batch of inputs and the matching outputs.
+    size_type batch_size(std::span<const real_type> input,
+                         std::span<const real_type> output) const noexcept {
+      const auto batch = input_size_ == 0 ? 0 : input.size() / input_size_;
+      assert(input.size() == batch * input_size_ &&
+             output.size() >= batch * output_size_);
+      return batch;
+    }
+
+    // Private Members
+    size_type   input_size_{};
+    size_type   output_size_{};
+    size_type   leading_dimension_{};
+    vector_type weight_{};
+    vector_type bias_{};
+  };
+}
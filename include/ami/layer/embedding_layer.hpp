@@ -0,0 +1,311 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <execution>
+#include <limits>
+#include <ranges>
+#include <span>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include "ami/concepts/execution_policy.hpp"
+#include "ami/concepts/optimizer.hpp"
+#include "ami/memory/scratch.hpp"
+#include "ami/utility/aligned_allocator.hpp"
+#include "ami/utility/parallel_algorithm.hpp"
+
+namespace ami::detail {
+
+  template <class Optimizer, std::floating_point RealType>
+  struct embedding_optimizer final {
+    using type = std::vector<Optimizer>;
+  };
+
+  template <buffer_optimizer_family Optimizer, std::floating_point RealType>
+  struct embedding_optimizer<Optimizer, RealType> final {
+    using type = typename Optimizer::template type<
+        RealType, std::dynamic_extent>;
+  };
+}
+
+namespace ami {
+
+  // Lookup table of rows of Dimension values. A sample is InputSize row
+  // indices, one per categorical feature say, and the output is their rows
+  // one after another, so dense layers can follow it in a sequential.
+  //
+  // The vocabulary size is chosen at run time. The table either lives on
+  // the heap, cache line aligned, or is a read only view of rows held
+  // elsewhere, such as a memory mapped file, for serving tables too large
+  // to load.
+  //
+  // Gradients are sparse: calc_gradient records the rows looked up and the
+  // deltas of their outputs, and update sums the deltas of each distinct
+  // row and steps only the rows seen, so a step costs the batch rather than
+  // the vocabulary. Optimizer state comes from make_optimizer: per scalar
+  // optimizers are kept per table entry and only those of the rows seen are
+  // called; a lazy buffer optimizer family such as fused_adam is bound to
+  // the table size at run time and takes a lazy step.
+  template <std::size_t Dimension>
+  requires (Dimension > 0)
+  struct embedding_layer final {
+    template <std::floating_point RealType, std::size_t InputSize>
+    requires (InputSize > 0)
+    class type final {
+    public:
+      // Public Types
+      using size_type      = std::size_t;
+      using real_type      = RealType;
+      using index_type     = std::uint32_t;
+      using allocator_type = utility::aligned_allocator<real_type>;
+      using vector_type    = std::vector<real_type, allocator_type>;
+      using input_type     = std::array<index_type, InputSize>;
+      using forward_type   = std::array<real_type, InputSize * Dimension>;
+      // Row indices have no gradient to pass back.
+      using backward_type  = std::tuple<>;
+      using delta_type     = forward_type;
+
+      // Every row looked up and the delta of its output, in the order they
+      // were recorded, values[k * dimension, +dimension) belonging to
+      // rows[k]. A row may appear any number of times.
+      struct gradient_type final {
+        std::vector<index_type> rows{};
+        std::vector<real_type> values{};
+
+        friend bool operator==(
+            const gradient_type&, const gradient_type&) = default;
+      };
+
+      template <class Optimizer>
+      requires optimizer<Optimizer> || buffer_optimizer_family<Optimizer>
+      using optimizer_type = typename detail::embedding_optimizer<
+          Optimizer, RealType>::type;
+
+      // Public Static Members
+      static constexpr size_type input_size  = InputSize;
+      static constexpr size_type output_size = InputSize * Dimension;
+      static constexpr size_type dimension   = Dimension;
+
+      // Constructor
+      type() = default;
+
+      // vocabulary_size rows of zeros.
+      explicit type(size_type vocabulary_size)
+          : vocabulary_size_{vocabulary_size},
+            table_(vocabulary_size * dimension) {}
+
+      // Read only view of the rows in table, which must outlive the layer.
+      explicit type(std::span<const real_type> table)
+          : vocabulary_size_{table.size() / dimension}, view_{table.data()} {
+        assert(table.size() % dimension == 0);
+      }
+
+      // Public Static Methods
+
+      // Appends the rows of input and their deltas to result.
+      template <execution_policy auto P = std::execution::seq>
+      static void calc_gradient(
+          const input_type& input, const delta_type& delta,
+          gradient_type& result) {
+        result.rows.insert(result.rows.end(), input.begin(), input.end());
+        result.values.insert(result.values.end(), delta.begin(), delta.end());
+      }
+
+      template <execution_policy auto P = std::execution::seq>
+      static void calc_gradient(
+          std::span<const input_type> input, std::span<const delta_type> delta,
+          gradient_type& result) {
+        result.rows.reserve(result.rows.size() + input.size() * input_size);
+        result.values.reserve(
+            result.values.size() + input.size() * output_size);
+        for (size_type b = 0; b < input.size(); ++b) {
+          calc_gradient<P>(input[b], delta[b], result);
+        }
+      }
+
+      // Public Methods
+      template <class Optimizer>
+      requires optimizer<Optimizer> || buffer_optimizer_family<Optimizer>
+      optimizer_type<Optimizer> make_optimizer() const {
+        return optimizer_type<Optimizer>(vocabulary_size_ * dimension);
+      }
+
+      template <execution_policy auto P = std::execution::seq>
+      forward_type forward(const input_type& input) const {
+        forward_type result{};
+        forward<P>(input, result);
+        return result;
+      }
+
+      template <execution_policy auto P = std::execution::seq>
+      void forward(const input_type& input, forward_type& result) const {
+        gather(input, result);
+      }
+
+      // Gathers the rows of a batch, samples in parallel under P.
+      template <execution_policy auto P = std::execution::seq>
+      void forward(
+          std::span<const input_type> input,
+          std::span<forward_type> result) const {
+        if constexpr (adaptive_policy<P>) {
+          utility::resolve<P>(input.size() * output_size,
+              [&]<execution_policy auto Q> {
+                forward<Q>(input, result);
+              });
+        } else {
+          utility::for_each<P>(std::views::iota(size_type{}, input.size()),
+              [&](auto b) {
+                gather(input[b], result[b]);
+              });
+        }
+      }
+
+      template <execution_policy auto P = std::execution::seq>
+      backward_type backward(const delta_type&) const {
+        return {};
+      }
+
+      template <execution_policy auto P = std::execution::seq>
+      void backward(const delta_type&, backward_type&) const {}
+
+      template <execution_policy auto P = std::execution::seq>
+      void backward(
+          std::span<const delta_type>, std::span<backward_type>) const {}
+
+      template <execution_policy auto P = std::execution::seq,
+                optimizer Optimizer>
+      void update(
+          std::vector<Optimizer>& optimizer, const gradient_type& gradient) {
+        assert(optimizer.size() == table_.size());
+        for_each_row<P>(gradient, [&](size_type row, const auto& sum) {
+              auto* weights = table_.data() + row * dimension;
+              auto* optimizers = optimizer.data() + row * dimension;
+              for (size_type d = 0; d < dimension; ++d) {
+                optimizers[d](weights[d], sum[d]);
+              }
+            });
+      }
+
+      // Row r sits at r * dimension of the optimizer's buffers.
+      template <execution_policy auto P = std::execution::seq,
+                lazy_optimizer Optimizer>
+      requires (Optimizer::size == std::dynamic_extent)
+      void update(Optimizer& optimizer, const gradient_type& gradient) {
+        assert(optimizer.m().size() == table_.size());
+        using update_type = typename Optimizer::lazy_update_type;
+        optimizer.step([&](const update_type& step) {
+              for_each_row<P>(gradient, [&](size_type row, const auto& sum) {
+                    step(row * dimension, std::span<real_type>{
+                        table_.data() + row * dimension, dimension}, sum);
+                  });
+            });
+      }
+
+      // Views
+      std::span<const real_type> table() const noexcept {
+        return {data(), vocabulary_size_ * dimension};
+      }
+
+      // The rows of an owned table.
+      std::span<real_type> table() noexcept {
+        assert(view_ == nullptr);
+        return table_;
+      }
+
+      std::span<const real_type, dimension> row(size_type i) const noexcept {
+        return std::span<const real_type, dimension>{
+            data() + i * dimension, dimension};
+      }
+
+      std::span<real_type, dimension> row(size_type i) noexcept {
+        assert(view_ == nullptr);
+        return std::span<real_type, dimension>{
+            table_.data() + i * dimension, dimension};
+      }
+
+      // Getter
+      size_type vocabulary_size() const noexcept { return vocabulary_size_; }
+
+    private:
+      // Private Methods
+      const real_type* data() const noexcept {
+        return view_ != nullptr ? view_ : table_.data();
+      }
+
+      void gather(const input_type& input, forward_type& result) const {
+        const auto* table = data();
+        for (size_type k = 0; k < input_size; ++k) {
+          assert(input[k] < vocabulary_size_);
+          std::ranges::copy_n(table + size_type{input[k]} * dimension,
+              dimension, result.begin() + k * dimension);
+        }
+      }
+
+      // Calls f(row, sum) once for every distinct row of gradient, sum being
+      // the total of its deltas, rows in parallel under P. The deltas of a
+      // row are added in the order they were recorded, so the sums do not
+      // depend on the policy.
+      template <execution_policy auto P, class F>
+      void for_each_row(const gradient_type& gradient, F f) {
+        assert(view_ == nullptr);
+        memory::scratch workspace{};
+        const auto n = gradient.rows.size();
+        assert(n <= std::numeric_limits<index_type>::max());
+        // Row in the high half, record in the low half, so a plain sort of
+        // the keys groups the records of a row in the order they came.
+        const auto keys = workspace.allocate<std::uint64_t>(n);
+        for (size_type k = 0; k < n; ++k) {
+          keys[k] = std::uint64_t{gradient.rows[k]} << 32 | k;
+        }
+        std::ranges::sort(keys);
+
+        const auto starts = workspace.allocate<size_type>(n + 1);
+        size_type runs = 0;
+        for (size_type k = 0; k < n; ++k) {
+          if (k == 0 || keys[k] >> 32 != keys[k - 1] >> 32) {
+            starts[runs++] = k;
+          }
+        }
+        starts[runs] = n;
+
+        const auto rows = [&]<execution_policy auto Q> {
+          utility::for_each<Q>(std::views::iota(size_type{}, runs),
+              [&](auto r) {
+                std::array<real_type, dimension> sum{};
+                for (auto k = starts[r]; k < starts[r + 1]; ++k) {
+                  const auto* delta = gradient.values.data() +
+                      (keys[k] & 0xffffffff) * dimension;
+                  for (size_type d = 0; d < dimension; ++d) {
+                    sum[d] += delta[d];
+                  }
+                }
+                const auto row = static_cast<index_type>(keys[starts[r]] >> 32);
+                assert(row < vocabulary_size_);
+                f(size_type{row}, std::as_const(sum));
+              });
+        };
+        if constexpr (adaptive_policy<P>) {
+          utility::resolve<P>(gradient.values.size(), rows);
+        } else {
+          rows.template operator()<P>();
+        }
+      }
+
+      // Private Members
+      size_type vocabulary_size_{};
+      vector_type table_{};
+      const real_type* view_{};
+    };
+  };
+
+  template <std::floating_point RealType, std::size_t InputSize,
+            std::size_t Dimension>
+  using embedding_layer_t = typename embedding_layer<Dimension>::template
+      type<RealType, InputSize>;
+}
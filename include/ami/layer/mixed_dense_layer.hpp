@@ -0,0 +1,264 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <concepts>
+#include <cstddef>
+#include <span>
+#include <type_traits>
+#include <utility>
+
+#include "ami/concepts/execution_policy.hpp"
+#include "ami/kernel/convert.hpp"
+#include "ami/kernel/gemm.hpp"
+#include "ami/layer/component/node.hpp"
+#include "ami/layer/component/weight_matrix.hpp"
+#include "ami/layer/dense_layer.hpp"
+#include "ami/utility/half_precision.hpp"
+#include "ami/utility/parallel_algorithm.hpp"
+
+namespace ami {
+
+  // dense_layer reading its weights from a 16 bit working copy. forward and
+  // backward stream every weight once per sample and are bound by memory
+  // bandwidth, so halving the width halves their traffic; the products are
+  // still accumulated in RealType. The RealType weights stay the master
+  // copy: gradients, optimizer state and updates are full precision and
+  // each update rounds the master into the working copy afresh, so steps
+  // smaller than a 16 bit ulp still add up.
+  //
+  // The views expose the master weights; after writing through them call
+  // synchronize(). Batches of inputs may be stored in 16 bits as well.
+  template <std::size_t OutputSize, half_precision Storage = bfloat16,
+            row_padding Padding = row_padding::none>
+  requires (OutputSize > 0)
+  struct mixed_dense_layer final {
+    template <std::floating_point RealType, std::size_t InputSize>
+    requires (InputSize > 0)
+    class type final {
+    public:
+      // Public Types
+      using size_type      = std::size_t;
+      using real_type      = RealType;
+      using storage_type   = Storage;
+      using master_type    =
+          dense_layer_t<RealType, InputSize, OutputSize, Padding>;
+      using working_type   =
+          weight_matrix<Storage, OutputSize, InputSize, Padding>;
+      using node_view_type = node<RealType, InputSize,
+          std::span<const Storage, InputSize>>;
+      using bias_view_type = typename master_type::bias_view_type;
+      using value_type     = typename master_type::value_type;
+      using input_type     = typename master_type::input_type;
+      using forward_type   = typename master_type::forward_type;
+      using backward_type  = typename master_type::backward_type;
+      using delta_type     = typename master_type::delta_type;
+      using gradient_type  = typename master_type::gradient_type;
+      using storage_input_type = std::array<Storage, InputSize>;
+
+      template <class Optimizer>
+      using optimizer_type =
+          typename master_type::template optimizer_type<Optimizer>;
+
+      // Public Static Members
+      static constexpr size_type input_size  = InputSize;
+      static constexpr size_type output_size = OutputSize;
+      static constexpr size_type leading_dimension =
+          master_type::leading_dimension;
+      static constexpr size_type parameter_size = master_type::parameter_size;
+
+      // Constructor
+      type() = default;
+
+      explicit constexpr type(const value_type& value) : master_{value} {
+        synchronize();
+      }
+
+      explicit constexpr type(value_type&& value)
+          : master_{std::move(value)} {
+        synchronize();
+      }
+
+      // Public Static Methods
+      template <execution_policy auto P = std::execution::seq>
+      static constexpr void calc_gradient(
+          const input_type& input, const delta_type& delta,
+          gradient_type& result) {
+        master_type::template calc_gradient<P>(input, delta, result);
+      }
+
+      template <execution_policy auto P = std::execution::seq, class Input>
+      requires std::same_as<Input, input_type> ||
+               std::same_as<Input, storage_input_type>
+      static constexpr void calc_gradient(
+          std::span<const Input> input, std::span<const delta_type> delta,
+          gradient_type& result) {
+        if (input.empty()) {
+          return;
+        }
+        kernel::gemm<P>(output_size, input_size, input.size(),
+            kernel::col_major(delta.front().data(), output_size),
+            kernel::row_major(input.front().data(), input_size),
+            kernel::row_major(result.first.front().data(), input_size));
+        for (const auto& d : delta) {
+          for (size_type i = 0; i < output_size; ++i) {
+            result.second[i] += d[i];
+          }
+        }
+      }
+
+      // Public Methods
+      template <execution_policy auto P = std::execution::seq>
+      constexpr forward_type forward(const input_type& input) const {
+        forward_type result{};
+        forward<P>(input, result);
+        return result;
+      }
+
+      template <execution_policy auto P = std::execution::seq>
+      constexpr void forward(
+          const input_type& input, forward_type& result) const {
+        forward<P>(input, result, kernel::identity_epilogue{});
+      }
+
+      template <execution_policy auto P = std::execution::seq, class Epilogue>
+      requires std::is_invocable_r_v<
+          real_type, Epilogue&, size_type, real_type>
+      constexpr void forward(
+          const input_type& input, forward_type& result,
+          Epilogue epilogue) const {
+        std::ranges::copy(master_.biases(), result.begin());
+        kernel::gemv<P>(output_size, input_size, working_.data(),
+            working_type::leading_dimension, input.data(), result.data(),
+            epilogue);
+      }
+
+      template <execution_policy auto P = std::execution::seq, class Input>
+      requires std::same_as<Input, input_type> ||
+               std::same_as<Input, storage_input_type>
+      constexpr void forward(
+          std::span<const Input> input,
+          std::span<forward_type> result) const {
+        if (input.empty()) {
+          return;
+        }
+        for (auto& r : result.first(input.size())) {
+          std::ranges::copy(master_.biases(), r.begin());
+        }
+        kernel::gemm<P>(input.size(), output_size, input_size,
+            kernel::row_major(input.front().data(), input_size),
+            kernel::col_major(working_.data(),
+                working_type::leading_dimension),
+            kernel::row_major(result.front().data(), output_size));
+      }
+
+      template <execution_policy auto P = std::execution::seq>
+      constexpr backward_type backward(const delta_type& delta) const {
+        backward_type result{};
+        backward<P>(delta, result);
+        return result;
+      }
+
+      template <execution_policy auto P = std::execution::seq>
+      constexpr void backward(
+          const delta_type& delta, backward_type& result) const {
+        result = backward_type{};
+        kernel::gemv_t<P>(output_size, input_size, working_.data(),
+            working_type::leading_dimension, delta.data(), result.data());
+      }
+
+      template <execution_policy auto P = std::execution::seq>
+      constexpr void backward(
+          std::span<const delta_type> delta,
+          std::span<backward_type> result) const {
+        if (delta.empty()) {
+          return;
+        }
+        std::ranges::fill(result.first(delta.size()), backward_type{});
+        kernel::gemm<P>(delta.size(), input_size, output_size,
+            kernel::row_major(delta.front().data(), output_size),
+            kernel::row_major(working_.data(),
+                working_type::leading_dimension),
+            kernel::row_major(result.front().data(), input_size));
+      }
+
+      // Updates the master weights with either kind of optimizer dense_layer
+      // takes, then refreshes the working copy.
+      template <execution_policy auto P = std::execution::seq,
+                class Optimizer>
+      requires requires(master_type& master, Optimizer& optimizer,
+                        const gradient_type& gradient) {
+        master.template update<P>(optimizer, gradient);
+      }
+      constexpr void update(
+          Optimizer& optimizer, const gradient_type& gradient) {
+        master_.template update<P>(optimizer, gradient);
+        synchronize<P>();
+      }
+
+      // Rounds the master weights into the working copy.
+      template <execution_policy auto P = std::execution::seq>
+      constexpr void synchronize() {
+        if constexpr (adaptive_policy<P>) {
+          utility::resolve<P>(parameter_size, [&]<execution_policy auto Q> {
+                synchronize<Q>();
+              });
+        } else {
+          utility::for_each<P>(std::views::iota(size_type{}, output_size),
+              [&](auto i) {
+                kernel::convert(input_size, master_.weights(i).data(),
+                    working_.row(i).data());
+              });
+        }
+      }
+
+      // Views
+      constexpr auto weights() noexcept { return master_.weights(); }
+
+      constexpr auto weights() const noexcept { return master_.weights(); }
+
+      constexpr auto weights(size_type i) noexcept {
+        return master_.weights(i);
+      }
+
+      constexpr auto weights(size_type i) const noexcept {
+        return master_.weights(i);
+      }
+
+      constexpr auto biases() noexcept { return master_.biases(); }
+
+      constexpr auto biases() const noexcept { return master_.biases(); }
+
+      // The working copy the passes read.
+      constexpr auto working_weights() const noexcept {
+        return working_.span();
+      }
+
+      constexpr node_view_type node_view(size_type i) const noexcept {
+        return node_view_type{working_.row(i)};
+      }
+
+      constexpr bias_view_type bias_view(size_type i) noexcept {
+        return master_.bias_view(i);
+      }
+
+      // Getter
+      constexpr auto value() const& noexcept { return master_.value(); }
+
+      constexpr auto value() && noexcept {
+        return std::move(master_).value();
+      }
+
+    private:
+      // Private Members
+      master_type  master_{};
+      working_type working_{};
+    };
+  };
+
+  template <std::floating_point RealType, std::size_t InputSize,
+            std::size_t OutputSize, half_precision Storage = bfloat16,
+            row_padding Padding = row_padding::none>
+  using mixed_dense_layer_t = typename mixed_dense_layer<
+      OutputSize, Storage, Padding>::template type<RealType, InputSize>;
+}
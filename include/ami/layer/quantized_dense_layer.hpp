@@ -0,0 +1,257 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <execution>
+#include <ranges>
+#include <span>
+#include <type_traits>
+
+#include "ami/concepts/execution_policy.hpp"
+#include "ami/kernel/gemm.hpp"
+#include "ami/kernel/quantized.hpp"
+#include "ami/layer/dense_layer.hpp"
+#include "ami/utility/parallel_algorithm.hpp"
+#include "ami/utility/quantization.hpp"
+
+namespace ami {
+
+  // Inference-only dense_layer with int8 weights, a quarter of the memory
+  // forward streams. Each row of weights is quantized with its own scale
+  // and zero point, the inputs to uint8 with the input quantization chosen
+  // by calibration; the dot products are exact in int32 and are turned
+  // back into reals, zero points taken out, as the biases are added.
+  //
+  // Layers of a quantized model hand each other uint8 outputs: the
+  // dequantization, the activation and the quantization for the next
+  // layer run as one pass over the int32 sums.
+  template <std::size_t OutputSize>
+  requires (OutputSize > 0)
+  struct quantized_dense_layer final {
+    template <std::floating_point RealType, std::size_t InputSize>
+    requires (InputSize > 0 && InputSize <= kernel::quantized_dot_limit)
+    class type final {
+    public:
+      // Public Types
+      using size_type         = std::size_t;
+      using real_type         = RealType;
+      using quantization_type = quantization<RealType>;
+      using value_type        = typename dense_layer_t<
+          RealType, InputSize, OutputSize>::value_type;
+      using input_type        = std::array<real_type, InputSize>;
+      using forward_type      = std::array<real_type, OutputSize>;
+      using quantized_input_type   = std::array<std::uint8_t, InputSize>;
+      using quantized_forward_type = std::array<std::uint8_t, OutputSize>;
+
+      // Public Static Members
+      static constexpr size_type input_size  = InputSize;
+      static constexpr size_type output_size = OutputSize;
+      static constexpr size_type alignment   = 64;
+
+      // Rows start on a cache line.
+      static constexpr size_type leading_dimension =
+          (input_size + alignment - 1) / alignment * alignment;
+
+      // Constructor
+      type() = default;
+
+      // Quantizes the weights of a dense layer, value(), row by row.
+      constexpr type(const value_type& value, const quantization_type& input)
+          : bias_{value.second}, input_quantization_{input} {
+        for (size_type i = 0; i < output_size; ++i) {
+          quantize_row(i, value.first[i]);
+        }
+      }
+
+      // Public Methods
+
+      // Quantizes the weights of a trained layer of the same shape through
+      // its views, in place; no copy of its weights is made.
+      template <class Layer>
+      requires (Layer::input_size == input_size &&
+                Layer::output_size == output_size) &&
+               requires(const Layer& layer, size_type i) {
+                 { layer.weights(i)[0] } -> std::convertible_to<real_type>;
+                 { layer.biases()[0] } -> std::convertible_to<real_type>;
+               }
+      constexpr void assign(
+          const Layer& layer, const quantization_type& input) {
+        for (size_type i = 0; i < output_size; ++i) {
+          quantize_row(i, layer.weights(i));
+        }
+        std::ranges::copy(layer.biases(), bias_.begin());
+        input_quantization_ = input;
+      }
+
+      constexpr quantized_input_type quantize(
+          const input_type& input) const {
+        quantized_input_type result{};
+        std::ranges::transform(input, result.begin(), [&](real_type x) {
+              return input_quantization_.template quantize<std::uint8_t>(x);
+            });
+        return result;
+      }
+
+      template <execution_policy auto P = std::execution::seq>
+      constexpr forward_type forward(const input_type& input) const {
+        forward_type result{};
+        forward<P>(input, result);
+        return result;
+      }
+
+      // Applies epilogue(i, y_i) to each output as it is dequantized.
+      template <execution_policy auto P = std::execution::seq,
+                class Epilogue = kernel::identity_epilogue>
+      requires std::is_invocable_r_v<
+          real_type, Epilogue&, size_type, real_type>
+      constexpr void forward(
+          const input_type& input, forward_type& result,
+          Epilogue epilogue = {}) const {
+        forward<P>(quantize(input), result, epilogue);
+      }
+
+      template <execution_policy auto P = std::execution::seq,
+                class Epilogue = kernel::identity_epilogue>
+      requires std::is_invocable_r_v<
+          real_type, Epilogue&, size_type, real_type>
+      constexpr void forward(
+          const quantized_input_type& input, forward_type& result,
+          Epilogue epilogue = {}) const {
+        dequantize<P>(input, [&](size_type i, real_type y) {
+              result[i] = epilogue(i, y);
+            });
+      }
+
+      // The outputs after epilogue, quantized with output: the
+      // input_quantization() of the layer that follows.
+      template <execution_policy auto P = std::execution::seq, class Input,
+                class Epilogue = kernel::identity_epilogue>
+      requires (std::same_as<Input, input_type> ||
+                std::same_as<Input, quantized_input_type>) &&
+               std::is_invocable_r_v<
+                   real_type, Epilogue&, size_type, real_type>
+      constexpr void forward(
+          const Input& input, quantized_forward_type& result,
+          const quantization_type& output, Epilogue epilogue = {}) const {
+        const auto run = [&](const quantized_input_type& q) {
+          dequantize<P>(q, [&](size_type i, real_type y) {
+                result[i] = output.template quantize<std::uint8_t>(
+                    epilogue(i, y));
+              });
+        };
+        if constexpr (std::same_as<Input, input_type>) {
+          run(quantize(input));
+        } else {
+          run(input);
+        }
+      }
+
+      // A batch of samples, spread over the workers under a parallel
+      // policy.
+      template <execution_policy auto P = std::execution::seq>
+      constexpr void forward(
+          std::span<const input_type> input,
+          std::span<forward_type> result) const {
+        utility::for_each<P>(std::views::iota(size_type{}, input.size()),
+            [&](size_type b) {
+              forward<std::execution::seq>(input[b], result[b]);
+            });
+      }
+
+      // Views
+      constexpr std::span<const std::int8_t, input_size> weights(
+          size_type i) const noexcept {
+        return std::span<const std::int8_t, input_size>{
+            weight_.data() + i * leading_dimension, input_size};
+      }
+
+      constexpr const quantization_type& weight_quantization(
+          size_type i) const noexcept {
+        return weight_quantization_[i];
+      }
+
+      constexpr std::span<const real_type, output_size> biases()
+          const noexcept {
+        return bias_;
+      }
+
+      // Getter
+      constexpr const quantization_type& input_quantization()
+          const noexcept {
+        return input_quantization_;
+      }
+
+      // The weights as the layer sees them, dequantized.
+      constexpr value_type value() const {
+        value_type result{{}, bias_};
+        for (size_type i = 0; i < output_size; ++i) {
+          std::ranges::transform(weights(i), result.first[i].begin(),
+              [&](std::int8_t w) {
+                return weight_quantization_[i].dequantize(w);
+              });
+        }
+        return result;
+      }
+
+    private:
+      // Private Methods
+      template <class Row>
+      constexpr void quantize_row(size_type i, const Row& row) {
+        const auto [min, max] = std::ranges::minmax(row);
+        const auto q = quantization_type::template from_range<std::int8_t>(
+            static_cast<real_type>(min), static_cast<real_type>(max));
+        auto* weights = weight_.data() + i * leading_dimension;
+        std::int32_t sum = 0;
+        for (size_type j = 0; j < input_size; ++j) {
+          weights[j] = q.template quantize<std::int8_t>(
+              static_cast<real_type>(row[j]));
+          sum += weights[j];
+        }
+        weight_quantization_[i] = q;
+        row_sums_[i] = sum;
+      }
+
+      // Calls store(i, y_i) with each output: the int32 sum of row i,
+      // shifted by the zero points and scaled, plus the bias.
+      //   sum_j (x_j - zx)(w_ij - zw_i) = sum_j x_j w_ij - zx sum_j w_ij
+      //                                   - zw_i sum_j x_j + n zx zw_i
+      template <execution_policy auto P, class Store>
+      constexpr void dequantize(
+          const quantized_input_type& input, Store store) const {
+        std::array<std::int32_t, output_size> sums{};
+        kernel::gemv<P>(output_size, input_size, weight_.data(),
+            leading_dimension, input.data(), sums.data());
+
+        std::int64_t input_sum = 0;
+        for (const auto x : input) {
+          input_sum += x;
+        }
+        const std::int64_t zx = input_quantization_.zero_point;
+        for (size_type i = 0; i < output_size; ++i) {
+          const auto& q = weight_quantization_[i];
+          const std::int64_t zw = q.zero_point;
+          const auto sum = sums[i] - zx * row_sums_[i] - zw * input_sum +
+              static_cast<std::int64_t>(input_size) * zx * zw;
+          store(i, bias_[i] + input_quantization_.scale * q.scale *
+              static_cast<real_type>(sum));
+        }
+      }
+
+      // Private Members
+      alignas(alignment) std::array<std::int8_t,
+          output_size * leading_dimension> weight_{};
+      std::array<quantization_type, output_size> weight_quantization_{};
+      std::array<std::int32_t, output_size> row_sums_{};
+      std::array<real_type, output_size> bias_{};
+      quantization_type input_quantization_{};
+    };
+  };
+
+  template <std::floating_point RealType, std::size_t InputSize,
+            std::size_t OutputSize>
+  using quantized_dense_layer_t = typename quantized_dense_layer<
+      OutputSize>::template type<RealType, InputSize>;
+}
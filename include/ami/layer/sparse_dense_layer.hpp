@@ -0,0 +1,361 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cmath>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <ranges>
+#include <span>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "ami/concepts/execution_policy.hpp"
+#include "ami/concepts/optimizer.hpp"
+#include "ami/kernel/sparse.hpp"
+#include "ami/utility/parallel_algorithm.hpp"
+
+namespace ami::detail {
+
+  template <class Optimizer, std::floating_point RealType,
+            std::size_t NonZeros, std::size_t OutputSize>
+  struct sparse_optimizer final {
+    using type = std::pair<std::array<Optimizer, NonZeros>,
+                           std::array<Optimizer, OutputSize>>;
+  };
+
+  template <buffer_optimizer_family Optimizer, std::floating_point RealType,
+            std::size_t NonZeros, std::size_t OutputSize>
+  struct sparse_optimizer<Optimizer, RealType, NonZeros, OutputSize> final {
+    using type =
+        typename Optimizer::template type<RealType, NonZeros + OutputSize>;
+  };
+}
+
+namespace ami {
+
+  // dense_layer holding only NonZeros of its weights, for pruned models.
+  // The weights are kept in compressed sparse rows: forward, backward,
+  // calc_gradient and update all cost time in proportion to the nonzeros,
+  // and gradients and optimizer state exist for the nonzeros only. The
+  // pattern is fixed once pruned; training moves the kept weights, never
+  // which they are.
+  //
+  // Each nonzero takes its value and a 32 bit column index, so a float
+  // layer keeping a fraction d of its weights takes about 2d times the
+  // memory of dense_layer.
+  template <std::size_t OutputSize, std::size_t NonZeros>
+  requires (OutputSize > 0 && NonZeros > 0 &&
+            NonZeros <= std::numeric_limits<std::uint32_t>::max())
+  struct sparse_dense_layer final {
+    template <std::floating_point RealType, std::size_t InputSize>
+    requires (InputSize > 0 && NonZeros <= InputSize * OutputSize &&
+              InputSize <= std::numeric_limits<std::uint32_t>::max())
+    class type final {
+    public:
+      // Public Types
+      using size_type     = std::size_t;
+      using index_type    = std::uint32_t;
+      using real_type     = RealType;
+      using value_type    = std::pair<
+          std::array<std::array<real_type, InputSize>, OutputSize>,
+          std::array<real_type, OutputSize>>;
+      using input_type    = std::array<real_type, InputSize>;
+      using forward_type  = std::array<real_type, OutputSize>;
+      using backward_type = input_type;
+      using delta_type    = forward_type;
+      // The nonzero weights in row order, then the biases.
+      using gradient_type = std::pair<std::array<real_type, NonZeros>,
+                                      std::array<real_type, OutputSize>>;
+
+      template <class Optimizer>
+      requires optimizer<Optimizer> || buffer_optimizer_family<Optimizer>
+      using optimizer_type = typename detail::sparse_optimizer<
+          Optimizer, RealType, NonZeros, OutputSize>::type;
+
+      // Public Static Members
+      static constexpr size_type input_size     = InputSize;
+      static constexpr size_type output_size    = OutputSize;
+      static constexpr size_type nonzeros       = NonZeros;
+      static constexpr size_type parameter_size = nonzeros + output_size;
+
+      // Constructor
+
+      // All weights zero, the first nonzeros of them in row order kept.
+      type() {
+        for (size_type i = 0; i <= output_size; ++i) {
+          row_offsets_[i] =
+              static_cast<index_type>(std::min(i * input_size, nonzeros));
+        }
+        for (size_type p = 0; p < nonzeros; ++p) {
+          columns_[p] = static_cast<index_type>(p % input_size);
+        }
+      }
+
+      // Prunes value, as assign does a dense layer.
+      explicit type(const value_type& value) {
+        prune([&](size_type i) { return std::span{value.first[i]}; },
+            value.second);
+      }
+
+      // Public Methods
+
+      // Magnitude pruning: keeps the nonzeros weights of layer largest in
+      // absolute value, and all the biases. Of equal weights the first in
+      // row order are kept. Layer is any layer with the same shape and
+      // weights(i) and biases() views, such as dense_layer.
+      template <class Layer>
+      requires (Layer::input_size == input_size &&
+                Layer::output_size == output_size) &&
+               requires(const Layer& layer, size_type i) {
+                 { layer.weights(i)[0] } -> std::convertible_to<real_type>;
+                 { layer.biases()[0] } -> std::convertible_to<real_type>;
+               }
+      void assign(const Layer& layer) {
+        prune([&](size_type i) { return layer.weights(i); }, layer.biases());
+      }
+
+      template <execution_policy auto P = std::execution::seq>
+      void calc_gradient(
+          const input_type& input, const delta_type& delta,
+          gradient_type& result) const {
+        kernel::sddmm<P>(1, output_size, row_offsets_.data(),
+            columns_.data(), delta.data(), output_size, input.data(),
+            input_size, result.first.data());
+        for (size_type i = 0; i < output_size; ++i) {
+          result.second[i] += delta[i];
+        }
+      }
+
+      template <execution_policy auto P = std::execution::seq>
+      void calc_gradient(
+          std::span<const input_type> input, std::span<const delta_type> delta,
+          gradient_type& result) const {
+        if (input.empty()) {
+          return;
+        }
+        kernel::sddmm<P>(input.size(), output_size, row_offsets_.data(),
+            columns_.data(), delta.front().data(), output_size,
+            input.front().data(), input_size, result.first.data());
+        for (const auto& d : delta.first(input.size())) {
+          for (size_type i = 0; i < output_size; ++i) {
+            result.second[i] += d[i];
+          }
+        }
+      }
+
+      template <execution_policy auto P = std::execution::seq>
+      forward_type forward(const input_type& input) const {
+        forward_type result{};
+        forward<P>(input, result);
+        return result;
+      }
+
+      // Applies epilogue(i, y_i) to each output as the kernel finishes it.
+      template <execution_policy auto P = std::execution::seq,
+                class Epilogue = kernel::identity_epilogue>
+      requires std::is_invocable_r_v<
+          real_type, Epilogue&, size_type, real_type>
+      void forward(
+          const input_type& input, forward_type& result,
+          Epilogue epilogue = {}) const {
+        result = bias_;
+        kernel::spmv<P>(output_size, row_offsets_.data(), columns_.data(),
+            values_.data(), input.data(), result.data(), epilogue);
+      }
+
+      // Samples run in parallel, each through the sequential kernel.
+      template <execution_policy auto P = std::execution::seq>
+      void forward(
+          std::span<const input_type> input,
+          std::span<forward_type> result) const {
+        utility::for_each<P>(std::views::iota(size_type{}, input.size()),
+            [&](auto b) {
+              forward<std::execution::seq>(input[b], result[b]);
+            });
+      }
+
+      template <execution_policy auto P = std::execution::seq>
+      backward_type backward(const delta_type& delta) const {
+        backward_type result{};
+        backward<P>(delta, result);
+        return result;
+      }
+
+      template <execution_policy auto P = std::execution::seq>
+      void backward(
+          const delta_type& delta, backward_type& result) const {
+        result = backward_type{};
+        kernel::spmv_t<P>(output_size, input_size, row_offsets_.data(),
+            columns_.data(), values_.data(), delta.data(), result.data());
+      }
+
+      template <execution_policy auto P = std::execution::seq>
+      void backward(
+          std::span<const delta_type> delta,
+          std::span<backward_type> result) const {
+        utility::for_each<P>(std::views::iota(size_type{}, delta.size()),
+            [&](auto b) {
+              backward<std::execution::seq>(delta[b], result[b]);
+            });
+      }
+
+      template <execution_policy auto P = std::execution::seq,
+                optimizer Optimizer>
+      void update(
+          std::pair<std::array<Optimizer, nonzeros>,
+                    std::array<Optimizer, output_size>>& optimizer,
+          const gradient_type& gradient) {
+        if constexpr (adaptive_policy<P>) {
+          utility::resolve<P>(parameter_size, [&]<execution_policy auto Q> {
+                update<Q>(optimizer, gradient);
+              });
+        } else {
+          utility::for_each<P>(std::views::iota(size_type{}, output_size),
+              [&](auto i) {
+                for (auto p = row_offsets_[i]; p < row_offsets_[i + 1]; ++p) {
+                  optimizer.first[p](values_[p], gradient.first[p]);
+                }
+                optimizer.second[i](bias_[i], gradient.second[i]);
+              });
+        }
+      }
+
+      // Nonzeros then biases, with the gradient laid out the same way.
+      template <execution_policy auto P = std::execution::seq,
+                buffer_optimizer Optimizer>
+      requires (Optimizer::size == parameter_size)
+      void update(
+          Optimizer& optimizer, const gradient_type& gradient) {
+        using tensor_type = typename Optimizer::tensor_type;
+        const std::array tensors{
+            tensor_type{values_, gradient.first},
+            tensor_type{bias_, gradient.second}};
+        optimizer.template operator()<P>(tensors);
+      }
+
+      // Views
+
+      // The nonzero weights in row order, or those of row i.
+      std::span<real_type, nonzeros> values() noexcept {
+        return values_;
+      }
+
+      std::span<const real_type, nonzeros> values() const noexcept {
+        return values_;
+      }
+
+      std::span<real_type> values(size_type i) noexcept {
+        return std::span{values_}.subspan(
+            row_offsets_[i], row_offsets_[i + 1] - row_offsets_[i]);
+      }
+
+      std::span<const real_type> values(size_type i)
+          const noexcept {
+        return std::span{values_}.subspan(
+            row_offsets_[i], row_offsets_[i + 1] - row_offsets_[i]);
+      }
+
+      // Columns of the nonzeros of row i, ascending.
+      std::span<const index_type> columns(size_type i)
+          const noexcept {
+        return std::span{columns_}.subspan(
+            row_offsets_[i], row_offsets_[i + 1] - row_offsets_[i]);
+      }
+
+      std::span<real_type, output_size> biases() noexcept {
+        return bias_;
+      }
+
+      std::span<const real_type, output_size> biases()
+          const noexcept {
+        return bias_;
+      }
+
+      // Getter
+
+      // The weights as a dense matrix, zero outside the nonzeros.
+      value_type value() const {
+        value_type result{{}, bias_};
+        for (size_type i = 0; i < output_size; ++i) {
+          for (auto p = row_offsets_[i]; p < row_offsets_[i + 1]; ++p) {
+            result.first[i][columns_[p]] = values_[p];
+          }
+        }
+        return result;
+      }
+
+    private:
+      // Private Methods
+
+      // Keeps the nonzeros weights of rows(0) .. rows(output_size - 1)
+      // largest in magnitude, found by selection rather than a sort.
+      template <class Rows, class Biases>
+      void prune(Rows rows, const Biases& biases) {
+        std::vector<real_type> magnitudes{};
+        magnitudes.reserve(input_size * output_size);
+        for (size_type i = 0; i < output_size; ++i) {
+          for (const real_type w : rows(i)) {
+            magnitudes.push_back(std::abs(w));
+          }
+        }
+        const auto nth = magnitudes.begin() + (nonzeros - 1);
+        std::ranges::nth_element(magnitudes, nth, std::greater<>{});
+        const auto threshold = *nth;
+        // Weights equal to the threshold fill the places the larger ones
+        // leave.
+        auto ties = nonzeros - static_cast<size_type>(std::ranges::count_if(
+            magnitudes, [&](auto m) { return m > threshold; }));
+
+        size_type p = 0;
+        for (size_type i = 0; i < output_size; ++i) {
+          row_offsets_[i] = static_cast<index_type>(p);
+          const auto row = rows(i);
+          for (size_type j = 0; j < input_size; ++j) {
+            const real_type w = row[j];
+            const auto magnitude = std::abs(w);
+            auto keep = magnitude > threshold;
+            if (!keep && magnitude == threshold && ties > 0) {
+              keep = true;
+              --ties;
+            }
+            if (keep) {
+              columns_[p] = static_cast<index_type>(j);
+              values_[p++] = w;
+            }
+          }
+        }
+        row_offsets_[output_size] = static_cast<index_type>(p);
+        assert(p == nonzeros);
+        std::ranges::copy(biases, bias_.begin());
+      }
+
+      // Private Members
+      alignas(64) std::array<real_type, nonzeros> values_{};
+      std::array<real_type, output_size> bias_{};
+      std::array<index_type, output_size + 1> row_offsets_{};
+      std::array<index_type, nonzeros> columns_{};
+    };
+  };
+
+  template <std::floating_point RealType, std::size_t InputSize,
+            std::size_t OutputSize, std::size_t NonZeros>
+  using sparse_dense_layer_t = typename sparse_dense_layer<
+      OutputSize, NonZeros>::template type<RealType, InputSize>;
+
+  // The sparse form of a dense layer keeping its NonZeros largest weights;
+  // see sparse_dense_layer::assign. Large layers are better assigned in
+  // place on the heap.
+  template <std::size_t NonZeros, class Layer>
+  auto prune(const Layer& layer) {
+    sparse_dense_layer_t<typename Layer::real_type, Layer::input_size,
+        Layer::output_size, NonZeros> result;
+    result.assign(layer);
+    return result;
+  }
+}
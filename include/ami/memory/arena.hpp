@@ -0,0 +1,219 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <new>
+#include <span>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#if defined(__linux__)
+#include <sys/mman.h>
+#endif
+
+namespace ami::memory {
+
+  enum class page_size { normal, huge };
+
+  // Bump allocator over large blocks. allocate only advances an offset;
+  // nothing is freed individually, instead reset (or rewind to a mark)
+  // makes everything allocated since reusable at once. A full block is
+  // followed by a new one, and reset folds several blocks into a single one
+  // of their total size, so once a step has run, later steps of the same
+  // shape allocate nothing and their buffers lie contiguously.
+  //
+  // Allocations are at least 64 byte aligned. With page_size::huge blocks
+  // are backed by 2 MiB pages where the system provides them, which cuts
+  // TLB misses when streaming over large parameter buffers.
+  class arena final {
+  public:
+    // Public Types
+    using size_type = std::size_t;
+
+    // Position to rewind to; everything allocated after mark() is released.
+    struct marker final {
+      size_type block;
+      size_type offset;
+    };
+
+    // Public Static Members
+    static constexpr size_type alignment = 64;
+    static constexpr size_type huge_page_size = size_type{2} << 20;
+
+    // Constructor
+    explicit arena(size_type block_size = size_type{1} << 20,
+                   page_size pages = page_size::normal)
+        : block_size_{std::max(block_size, alignment)}, pages_{pages} {}
+
+    arena(const arena&) = delete;
+
+    arena& operator=(const arena&) = delete;
+
+    // Destructor
+    ~arena() {
+      for (auto& block : blocks_) {
+        release(block);
+      }
+    }
+
+    // Public Methods
+
+    // Uninitialised storage; throws std::bad_alloc if no block can be had.
+    [[nodiscard]] void* allocate(
+        size_type bytes, size_type align = alignment) {
+      align = std::max(align, alignment);
+      while (current_ < blocks_.size()) {
+        auto& block = blocks_[current_];
+        const auto base = reinterpret_cast<std::uintptr_t>(block.data);
+        const auto offset = static_cast<size_type>(
+            (base + offset_ + align - 1) / align * align - base);
+        if (offset <= block.size && bytes <= block.size - offset) {
+          offset_ = offset + bytes;
+          return block.data + offset;
+        }
+        ++current_;
+        offset_ = 0;
+      }
+      blocks_.push_back(acquire(std::max(block_size_, bytes + align)));
+      offset_ = 0;
+      return allocate(bytes, align);
+    }
+
+    // n value initialised objects; the arena never runs destructors.
+    template <class T>
+    requires std::is_trivially_destructible_v<T>
+    [[nodiscard]] std::span<T> allocate(size_type n) {
+      auto* data = static_cast<T*>(allocate(n * sizeof(T), alignof(T)));
+      std::uninitialized_value_construct_n(data, n);
+      return {data, n};
+    }
+
+    marker mark() const noexcept { return {current_, offset_}; }
+
+    void rewind(marker m) noexcept {
+      current_ = m.block;
+      offset_ = m.offset;
+    }
+
+    // Releases every allocation, merging the blocks into one if the last
+    // pass needed more than one.
+    void reset() {
+      if (blocks_.size() > 1) {
+        size_type total{};
+        for (auto& block : blocks_) {
+          total += block.size;
+          release(block);
+        }
+        blocks_.clear();
+        blocks_.push_back(acquire(total));
+      }
+      rewind({});
+    }
+
+    // Getter
+    size_type capacity() const noexcept {
+      size_type result{};
+      for (const auto& block : blocks_) {
+        result += block.size;
+      }
+      return result;
+    }
+
+    size_type block_count() const noexcept { return blocks_.size(); }
+
+  private:
+    // Private Types
+    struct block_type final {
+      std::byte* data;
+      size_type  size;
+      bool       mapped;
+    };
+
+    // Private Methods
+    block_type acquire(size_type size) const {
+#if defined(__linux__)
+      if (pages_ == page_size::huge) {
+        size = (size + huge_page_size - 1) / huge_page_size * huge_page_size;
+        void* data = ::mmap(nullptr, size, PROT_READ | PROT_WRITE,
+            MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+        if (data == MAP_FAILED) {
+          // No reserved huge pages; ask for transparent ones instead.
+          data = ::mmap(nullptr, size, PROT_READ | PROT_WRITE,
+              MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+          if (data == MAP_FAILED) {
+            throw std::bad_alloc{};
+          }
+          ::madvise(data, size, MADV_HUGEPAGE);
+        }
+        return {static_cast<std::byte*>(data), size, true};
+      }
+#endif
+      size = (size + alignment - 1) / alignment * alignment;
+      return {static_cast<std::byte*>(
+                  ::operator new(size, std::align_val_t{alignment})),
+              size, false};
+    }
+
+    static void release(block_type& block) noexcept {
+#if defined(__linux__)
+      if (block.mapped) {
+        ::munmap(block.data, block.size);
+        return;
+      }
+#endif
+      ::operator delete(block.data, std::align_val_t{alignment});
+    }
+
+    // Private Members
+    size_type               block_size_;
+    page_size               pages_;
+    std::vector<block_type> blocks_{};
+    size_type               current_{};
+    size_type               offset_{};
+  };
+
+  // Standard allocator drawing from an arena, for containers whose storage
+  // should share the arena's lifetime. deallocate does nothing; the memory
+  // returns with the arena's next reset. Not final: containers derive from
+  // their allocator.
+  template <class T>
+  class arena_allocator {
+  public:
+    // Public Types
+    using value_type = T;
+    using size_type  = std::size_t;
+
+    // Constructor
+    explicit arena_allocator(arena& source) noexcept : arena_{&source} {}
+
+    template <class U>
+    arena_allocator(const arena_allocator<U>& other) noexcept
+        : arena_{other.source()} {}
+
+    // Public Methods
+    [[nodiscard]] T* allocate(size_type n) {
+      if (n > std::numeric_limits<size_type>::max() / sizeof(T)) {
+        throw std::bad_array_new_length{};
+      }
+      return static_cast<T*>(arena_->allocate(n * sizeof(T), alignof(T)));
+    }
+
+    void deallocate(T*, size_type) noexcept {}
+
+    template <class U>
+    bool operator==(const arena_allocator<U>& other) const noexcept {
+      return arena_ == other.source();
+    }
+
+    // Getter
+    arena* source() const noexcept { return arena_; }
+
+  private:
+    // Private Members
+    arena* arena_;
+  };
+}
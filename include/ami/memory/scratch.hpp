@@ -0,0 +1,51 @@
+#pragma once
+
+#include <cstddef>
+#include <span>
+#include <type_traits>
+
+#include "ami/memory/arena.hpp"
+
+namespace ami::memory {
+
+  // Arena of the calling thread for short lived kernel workspaces.
+  inline arena& thread_scratch() {
+    thread_local arena scratch{};
+    return scratch;
+  }
+
+  // Workspace on the thread's scratch arena, released when the scope ends.
+  // Scopes on one thread nest strictly, also when a thread waiting on a
+  // parallel loop runs stolen tasks, so the arena behaves as a stack and,
+  // once warm, kernels needing workspace allocate nothing.
+  class scratch final {
+  public:
+    // Public Types
+    using size_type = std::size_t;
+
+    // Constructor
+    scratch() : arena_{thread_scratch()}, mark_{arena_.mark()} {}
+
+    scratch(const scratch&) = delete;
+
+    scratch& operator=(const scratch&) = delete;
+
+    // Destructor
+    ~scratch() { arena_.rewind(mark_); }
+
+    // Public Methods
+
+    // Uninitialised storage for n objects.
+    template <class T>
+    requires std::is_trivial_v<T>
+    [[nodiscard]] std::span<T> allocate(size_type n) {
+      return {static_cast<T*>(arena_.allocate(n * sizeof(T), alignof(T))),
+              n};
+    }
+
+  private:
+    // Private Members
+    arena&        arena_;
+    arena::marker mark_;
+  };
+}
@@ -0,0 +1,420 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <ostream>
+#include <ranges>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "ami/model/parameters.hpp"
+#include "ami/utility/mapped_file.hpp"
+
+// Checkpoint file layout, all integers in the byte order of the writer:
+//
+//   header        64 bytes, checkpoint_header
+//   layers        64 bytes per layer, checkpoint_layer
+//   blobs         per layer its parameters, then its optimizer state, each
+//                 starting at a multiple of 64 bytes
+//
+// The parameters of a dense layer are its weights row by row followed by
+// its biases, as real_size byte floating point numbers. Optimizer state is
+// stored as the object representation of the optimizer, so it can only be
+// read back by a build with the same optimizer types.
+
+namespace ami {
+
+  // Thrown when a checkpoint is malformed or does not match the model it is
+  // loaded into.
+  class checkpoint_error final : public std::runtime_error {
+  public:
+    using std::runtime_error::runtime_error;
+  };
+
+  struct checkpoint_header final {
+    std::array<char, 8> magic;
+    std::uint32_t       version;
+    std::uint32_t       byte_order;
+    std::uint32_t       real_size;
+    std::uint32_t       alignment;
+    std::uint64_t       depth;
+    std::uint64_t       flags;
+    std::uint64_t       file_size;
+    std::array<std::byte, 16> reserved;
+  };
+
+  struct checkpoint_layer final {
+    std::uint64_t input_size;
+    std::uint64_t output_size;
+    std::uint64_t parameter_offset;  // in bytes from the start of the file
+    std::uint64_t parameter_size;    // in reals
+    std::uint64_t state_offset;      // in bytes from the start of the file
+    std::uint64_t state_size;        // in bytes
+    std::array<std::byte, 16> reserved;
+  };
+
+  static_assert(sizeof(checkpoint_header) == 64);
+  static_assert(sizeof(checkpoint_layer) == 64);
+}
+
+namespace ami::detail {
+
+  inline constexpr std::array<char, 8> checkpoint_magic{
+      'A', 'M', 'I', 'C', 'K', 'P', 'T', '\0'};
+  inline constexpr std::uint32_t checkpoint_version = 1;
+  inline constexpr std::uint32_t checkpoint_byte_order = 0x01020304;
+  inline constexpr std::size_t   checkpoint_alignment = 64;
+  inline constexpr std::uint64_t checkpoint_has_state = 1;
+
+  constexpr std::size_t checkpoint_align(std::size_t offset) noexcept {
+    return (offset + checkpoint_alignment - 1) / checkpoint_alignment *
+        checkpoint_alignment;
+  }
+
+  // Calls f(pointer, bytes) for every trivially copyable part of state,
+  // looking through pairs, tuples and arrays of other types.
+  template <class T, class F>
+  constexpr void for_each_state_block(T& state, F& f) {
+    using value_type = std::remove_const_t<T>;
+    if constexpr (std::is_trivially_copyable_v<value_type>) {
+      if constexpr (!std::is_empty_v<value_type>) {
+        f(&state, sizeof(value_type));
+      }
+    } else if constexpr (requires { std::tuple_size<value_type>::value; } &&
+                         !std::ranges::range<value_type>) {
+      std::apply([&](auto&... element) {
+        (for_each_state_block(element, f), ...);
+      }, state);
+    } else {
+      static_assert(std::ranges::range<value_type>,
+          "optimizer state must be built from trivially copyable types");
+      for (auto& element : state) {
+        for_each_state_block(element, f);
+      }
+    }
+  }
+
+  template <class T>
+  constexpr std::size_t state_size(const T& state) {
+    std::size_t result{};
+    auto add = [&](const void*, std::size_t size) { result += size; };
+    for_each_state_block(state, add);
+    return result;
+  }
+
+  // Layout of the blobs of one model, as written by save_checkpoint.
+  template <class Model>
+  std::vector<checkpoint_layer> checkpoint_layout(
+      std::span<const std::size_t> state_sizes) {
+    using layers_type = typename model_layers<Model>::type;
+    using real_type = typename Model::real_type;
+    constexpr auto depth = std::tuple_size_v<layers_type>;
+
+    std::vector<checkpoint_layer> result(depth);
+    auto offset = checkpoint_align(sizeof(checkpoint_header) +
+        depth * sizeof(checkpoint_layer));
+    [&]<std::size_t... I>(std::index_sequence<I...>) {
+      const auto place = [&]<std::size_t L>() {
+        using layer_type = std::tuple_element_t<L, layers_type>;
+        static_assert(dense_parameters<layer_type> ||
+            !trainable_layer<layer_type>,
+            "checkpoints store the parameters of dense layers only");
+        auto& layer = result[L];
+        layer.input_size = layer_type::input_size;
+        layer.output_size = layer_type::output_size;
+        layer.parameter_size = layer_parameter_size<layer_type>;
+        layer.parameter_offset = offset;
+        offset = checkpoint_align(
+            offset + layer.parameter_size * sizeof(real_type));
+        layer.state_size = state_sizes.empty() ? 0 : state_sizes[L];
+        layer.state_offset = offset;
+        offset = checkpoint_align(offset + layer.state_size);
+      };
+      (place.template operator()<I>(), ...);
+    }(std::make_index_sequence<depth>{});
+    return result;
+  }
+
+  inline void write_padding(std::ostream& os, std::size_t from,
+                            std::size_t to) {
+    static constexpr std::array<char, checkpoint_alignment> zeros{};
+    os.write(zeros.data(), static_cast<std::streamsize>(to - from));
+  }
+
+  template <class Model, class... States>
+  void save_checkpoint(
+      std::ostream& os, const Model& model, const States&... optimizer) {
+    using layers_type = typename model_layers<Model>::type;
+    using real_type = typename Model::real_type;
+    constexpr auto depth = std::tuple_size_v<layers_type>;
+
+    std::array<std::size_t, depth> state_sizes{};
+    if constexpr (sizeof...(States) > 0) {
+      [&]<std::size_t... I>(std::index_sequence<I...>) {
+        ((state_sizes[I] = state_size(std::get<I>(optimizer...))), ...);
+      }(std::make_index_sequence<depth>{});
+    }
+    const auto layout = checkpoint_layout<Model>(sizeof...(States) > 0 ?
+        std::span<const std::size_t>{state_sizes} :
+        std::span<const std::size_t>{});
+
+    checkpoint_header header{};
+    header.magic = checkpoint_magic;
+    header.version = checkpoint_version;
+    header.byte_order = checkpoint_byte_order;
+    header.real_size = sizeof(real_type);
+    header.alignment = checkpoint_alignment;
+    header.depth = depth;
+    header.flags = sizeof...(States) > 0 ? checkpoint_has_state : 0;
+    header.file_size = layout.back().state_offset + layout.back().state_size;
+
+    std::size_t position{};
+    const auto write = [&](const void* data, std::size_t size) {
+      os.write(static_cast<const char*>(data),
+          static_cast<std::streamsize>(size));
+      position += size;
+    };
+    const auto pad_to = [&](std::size_t offset) {
+      write_padding(os, position, offset);
+      position = offset;
+    };
+
+    write(&header, sizeof(header));
+    write(layout.data(), layout.size() * sizeof(checkpoint_layer));
+    [&]<std::size_t... I>(std::index_sequence<I...>) {
+      const auto blobs = [&]<std::size_t L>() {
+        using layer_type = std::tuple_element_t<L, layers_type>;
+        pad_to(layout[L].parameter_offset);
+        if constexpr (dense_parameters<layer_type>) {
+          const auto& layer = std::get<L>(model.layers());
+          for (std::size_t i = 0; i < layer_type::output_size; ++i) {
+            const auto row = layer.weights(i);
+            write(row.data(), row.size_bytes());
+          }
+          write(layer.biases().data(), layer.biases().size_bytes());
+        }
+        pad_to(layout[L].state_offset);
+        if constexpr (sizeof...(States) > 0) {
+          for_each_state_block(std::get<L>(optimizer...), write);
+        }
+      };
+      (blobs.template operator()<I>(), ...);
+    }(std::make_index_sequence<depth>{});
+    pad_to(header.file_size);
+  }
+}
+
+namespace ami {
+
+  // Writes model, and optionally the optimizer state of a training run, as
+  // a checkpoint. The stream should be opened in binary mode.
+  template <class Model>
+  void save_checkpoint(std::ostream& os, const Model& model) {
+    detail::save_checkpoint(os, model);
+  }
+
+  template <class Model, class... Optimizers>
+  requires (sizeof...(Optimizers) == std::tuple_size_v<
+      typename detail::model_layers<Model>::type>)
+  void save_checkpoint(std::ostream& os, const Model& model,
+                       const std::tuple<Optimizers...>& optimizer) {
+    detail::save_checkpoint(os, model, optimizer);
+  }
+
+  // A memory mapped checkpoint. Opening it validates the header and the
+  // layer table but reads none of the blobs; the parameter spans point
+  // straight into the mapping and stay valid as long as the checkpoint.
+  class checkpoint final {
+  public:
+    // Public Types
+    using size_type = std::size_t;
+
+    // Constructor
+    explicit checkpoint(const std::filesystem::path& path)
+        : file_{path} {
+      const auto bytes = file_.bytes();
+      if (bytes.size() < sizeof(header_)) {
+        throw checkpoint_error{"truncated checkpoint header"};
+      }
+      std::memcpy(&header_, bytes.data(), sizeof(header_));
+      if (header_.magic != detail::checkpoint_magic) {
+        throw checkpoint_error{"not a checkpoint"};
+      }
+      if (header_.byte_order != detail::checkpoint_byte_order) {
+        throw checkpoint_error{"checkpoint written with another byte order"};
+      }
+      if (header_.version != detail::checkpoint_version) {
+        throw checkpoint_error{"unsupported checkpoint version " +
+            std::to_string(header_.version)};
+      }
+      if (header_.alignment != detail::checkpoint_alignment ||
+          header_.file_size != bytes.size() ||
+          (header_.real_size != 4 && header_.real_size != 8)) {
+        throw checkpoint_error{"corrupt checkpoint header"};
+      }
+      if (header_.depth > (bytes.size() - sizeof(header_)) /
+              sizeof(checkpoint_layer)) {
+        throw checkpoint_error{"truncated checkpoint layer table"};
+      }
+
+      layers_.resize(header_.depth);
+      std::memcpy(layers_.data(), bytes.data() + sizeof(header_),
+          layers_.size() * sizeof(checkpoint_layer));
+      for (const auto& layer : layers_) {
+        if (layer.parameter_offset % detail::checkpoint_alignment != 0 ||
+            layer.parameter_offset > bytes.size() ||
+            layer.parameter_size >
+                (bytes.size() - layer.parameter_offset) / header_.real_size ||
+            layer.state_offset > bytes.size() ||
+            layer.state_size > bytes.size() - layer.state_offset) {
+          throw checkpoint_error{"checkpoint blob out of bounds"};
+        }
+      }
+    }
+
+    // Public Methods
+
+    // Parameters of layer i, weights row by row then biases.
+    template <std::floating_point RealType>
+    std::span<const RealType> parameters(size_type i) const {
+      if (sizeof(RealType) != header_.real_size) {
+        throw checkpoint_error{"checkpoint real type mismatch"};
+      }
+      const auto& layer = layers_.at(i);
+      return {reinterpret_cast<const RealType*>(
+                  file_.data() + layer.parameter_offset),
+              layer.parameter_size};
+    }
+
+    std::span<const std::byte> state(size_type i) const {
+      const auto& layer = layers_.at(i);
+      return file_.bytes().subspan(layer.state_offset, layer.state_size);
+    }
+
+    // Getter
+    const checkpoint_header& header() const noexcept { return header_; }
+
+    std::span<const checkpoint_layer> layers() const noexcept {
+      return layers_;
+    }
+
+    size_type depth() const noexcept { return layers_.size(); }
+
+    bool has_state() const noexcept {
+      return (header_.flags & detail::checkpoint_has_state) != 0;
+    }
+
+  private:
+    // Private Members
+    utility::mapped_file          file_;
+    checkpoint_header             header_{};
+    std::vector<checkpoint_layer> layers_{};
+  };
+}
+
+namespace ami::detail {
+
+  // Throws unless the checkpoint holds the layers of Model.
+  template <class Model>
+  void check_checkpoint(const checkpoint& source) {
+    using layers_type = typename model_layers<Model>::type;
+    constexpr auto depth = std::tuple_size_v<layers_type>;
+    if (source.header().real_size != sizeof(typename Model::real_type)) {
+      throw checkpoint_error{"checkpoint real type mismatch"};
+    }
+    if (source.depth() != depth) {
+      throw checkpoint_error{"checkpoint depth mismatch"};
+    }
+    const auto expected = checkpoint_layout<Model>({});
+    for (std::size_t i = 0; i < depth; ++i) {
+      const auto& layer = source.layers()[i];
+      if (layer.input_size != expected[i].input_size ||
+          layer.output_size != expected[i].output_size ||
+          layer.parameter_size != expected[i].parameter_size) {
+        throw checkpoint_error{
+            "checkpoint layer " + std::to_string(i) + " shape mismatch"};
+      }
+    }
+  }
+}
+
+namespace ami {
+
+  // Copies the parameters of a checkpoint into model, and optionally the
+  // optimizer state saved with them. Throws checkpoint_error if the
+  // checkpoint does not match.
+  template <class Model>
+  void load_checkpoint(const checkpoint& source, Model& model) {
+    using layers_type = typename detail::model_layers<Model>::type;
+    using real_type = typename Model::real_type;
+    detail::check_checkpoint<Model>(source);
+
+    [&]<std::size_t... I>(std::index_sequence<I...>) {
+      const auto load = [&]<std::size_t L>() {
+        using layer_type = std::tuple_element_t<L, layers_type>;
+        if constexpr (detail::dense_parameters<layer_type>) {
+          auto& layer = std::get<L>(model.layers());
+          auto p = source.parameters<real_type>(L).begin();
+          for (std::size_t i = 0; i < layer_type::output_size; ++i) {
+            p = std::ranges::copy_n(
+                p, layer_type::input_size, layer.weights(i).begin()).in;
+          }
+          std::ranges::copy_n(
+              p, layer_type::output_size, layer.biases().begin());
+          if constexpr (requires { layer.synchronize(); }) {
+            // Refresh a mixed precision layer's working copy.
+            layer.synchronize();
+          }
+        }
+      };
+      (load.template operator()<I>(), ...);
+    }(std::make_index_sequence<std::tuple_size_v<layers_type>>{});
+  }
+
+  template <class Model, class... Optimizers>
+  requires (sizeof...(Optimizers) == std::tuple_size_v<
+      typename detail::model_layers<Model>::type>)
+  void load_checkpoint(const checkpoint& source, Model& model,
+                       std::tuple<Optimizers...>& optimizer) {
+    // Everything is checked before anything is written, so a checkpoint
+    // that does not match leaves model and optimizer as they were.
+    detail::check_checkpoint<Model>(source);
+    if (!source.has_state()) {
+      throw checkpoint_error{"checkpoint holds no optimizer state"};
+    }
+    [&]<std::size_t... I>(std::index_sequence<I...>) {
+      const auto check = [&]<std::size_t L>() {
+        if (source.state(L).size() !=
+            detail::state_size(std::get<L>(optimizer))) {
+          throw checkpoint_error{"checkpoint optimizer state of layer " +
+              std::to_string(L) + " size mismatch"};
+        }
+      };
+      (check.template operator()<I>(), ...);
+    }(std::make_index_sequence<sizeof...(Optimizers)>{});
+
+    load_checkpoint(source, model);
+    [&]<std::size_t... I>(std::index_sequence<I...>) {
+      const auto load = [&]<std::size_t L>() {
+        const auto bytes = source.state(L);
+        std::size_t offset{};
+        auto read = [&](void* data, std::size_t size) {
+          std::memcpy(data, bytes.data() + offset, size);
+          offset += size;
+        };
+        detail::for_each_state_block(std::get<L>(optimizer), read);
+      };
+      (load.template operator()<I>(), ...);
+    }(std::make_index_sequence<sizeof...(Optimizers)>{});
+  }
+}
@@ -0,0 +1,212 @@
+#pragma once
+
+#include <algorithm>
+#include <concepts>
+#include <cstddef>
+#include <execution>
+#include <random>
+#include <ranges>
+#include <span>
+#include <stdexcept>
+#include <thread>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "ami/concepts/execution_policy.hpp"
+#include "ami/utility/parallel_algorithm.hpp"
+
+namespace ami::detail {
+
+  // Calls f(data, size) for every innermost contiguous run of scalars in a
+  // gradient (nested std::array, std::pair and std::tuple).
+  template <class T, class F>
+  constexpr void for_each_segment(T& value, F& f) {
+    using value_type = std::remove_const_t<T>;
+    if constexpr (std::floating_point<value_type>) {
+      f(&value, std::size_t{1});
+    } else if constexpr (requires {
+          requires std::floating_point<typename value_type::value_type>; }) {
+      f(value.data(), value.size());
+    } else if constexpr (requires { value.begin(); }) {
+      for (auto& element : value) {
+        for_each_segment(element, f);
+      }
+    } else {
+      std::apply([&](auto&... element) {
+            (for_each_segment(element, f), ...);
+          }, value);
+    }
+  }
+}
+
+namespace ami {
+
+  // Data parallel gradient computation over a batch. The batch is split into
+  // one contiguous shard per worker; each worker runs forward and backward
+  // with its own arena into its own cache line aligned gradient buffer, so
+  // no two workers write the same line and nothing is atomic. The buffers
+  // are then summed by a sharded reduction: the gradient is cut into chunks
+  // and every chunk is reduced across all workers by a single task.
+  template <class Model>
+  class data_parallel final {
+  public:
+    // Public Types
+    using size_type     = std::size_t;
+    using model_type    = Model;
+    using real_type     = typename model_type::real_type;
+    using input_type    = typename model_type::input_type;
+    using forward_type  = typename model_type::forward_type;
+    using delta_type    = typename model_type::delta_type;
+    using gradient_type = typename model_type::gradient_type;
+    using arena_type    = typename model_type::arena_type;
+
+    // Public Static Members
+    static constexpr size_type alignment = 64;
+
+    // Scalars per reduction task.
+    static constexpr size_type chunk_size = 4096;
+
+    // Constructor
+    explicit data_parallel(
+        size_type workers = std::max(std::thread::hardware_concurrency(), 1u))
+        : workers_(std::max(workers, size_type{1})) {
+      collect_segments(gradient_);
+      for (auto& worker : workers_) {
+        collect_segments(worker.gradient);
+      }
+    }
+
+    // Segments point into the members.
+    data_parallel(const data_parallel&) = delete;
+    data_parallel& operator=(const data_parallel&) = delete;
+
+    // Public Methods
+
+    // Sum of the gradients over the batch. loss_gradient(i, output) returns
+    // the delta of sample i given the model output for it.
+    template <execution_policy auto P = std::execution::par,
+              class LossGradient>
+    requires std::is_invocable_r_v<
+        delta_type, LossGradient&, size_type, const forward_type&>
+    const gradient_type& calc_gradient(
+        const model_type& model, std::span<const input_type> input,
+        LossGradient loss_gradient) {
+      return calc_gradient_impl<P>(model, input, loss_gradient,
+          [](size_type) { return std::tuple<>{}; });
+    }
+
+    // Training pass with one random engine per worker (for dropout): worker
+    // w draws from engines[w] alone. Throws std::invalid_argument if there
+    // are fewer engines than workers, as workers would then share one.
+    template <execution_policy auto P = std::execution::par,
+              class LossGradient, std::uniform_random_bit_generator G>
+    requires std::is_invocable_r_v<
+        delta_type, LossGradient&, size_type, const forward_type&>
+    const gradient_type& calc_gradient(
+        const model_type& model, std::span<const input_type> input,
+        LossGradient loss_gradient, std::span<G> engines) {
+      if (engines.size() < workers()) {
+        throw std::invalid_argument{
+            "data_parallel needs a random engine per worker"};
+      }
+      return calc_gradient_impl<P>(model, input, loss_gradient,
+          [&](size_type worker) {
+            return std::tuple<G&>{engines[worker]};
+          });
+    }
+
+    // Getter
+    constexpr size_type workers() const noexcept { return workers_.size(); }
+
+    constexpr const gradient_type& gradient() const noexcept {
+      return gradient_;
+    }
+
+  private:
+    struct alignas(alignment) worker_type final {
+      arena_type    arena{};
+      gradient_type gradient{};
+    };
+
+    // Private Methods
+    template <execution_policy auto P, class LossGradient, class Engines>
+    const gradient_type& calc_gradient_impl(
+        const model_type& model, std::span<const input_type> input,
+        LossGradient& loss_gradient, Engines engines) {
+      // Each sample costs about one pass over the gradient.
+      if constexpr (adaptive_policy<P>) {
+        return utility::resolve<P>(
+            input.size() * (sizeof(gradient_type) / sizeof(real_type)),
+            [&]<execution_policy auto Q>() -> const gradient_type& {
+              return calc_gradient_impl<Q>(
+                  model, input, loss_gradient, engines);
+            });
+      }
+
+      const auto count = workers_.size();
+      utility::for_each<P>(std::views::iota(size_type{}, count),
+          [&](auto w) {
+            auto& worker = workers_[w];
+            worker.gradient = gradient_type{};
+            auto engine = engines(w);
+            const auto end = input.size() * (w + 1) / count;
+            for (auto i = input.size() * w / count; i < end; ++i) {
+              const auto& output = std::apply([&](auto&... engine) -> auto& {
+                    return model.forward(input[i], worker.arena, engine...);
+                  }, engine);
+              model.backward(
+                  loss_gradient(i, output), worker.gradient, worker.arena);
+            }
+          });
+
+      const auto segments = sizes_.size();
+      utility::for_each<P>(std::views::iota(size_type{}, segments),
+          [&](auto s) {
+            const auto size = sizes_[s];
+            auto* data = segments_[s];
+            std::copy_n(segments_[segments + s], size, data);
+            for (size_type w = 1; w < count; ++w) {
+              const auto* src = segments_[(w + 1) * segments + s];
+              for (size_type j = 0; j < size; ++j) {
+                data[j] += src[j];
+              }
+            }
+          });
+      return gradient_;
+    }
+
+    // Appends the segments of gradient: contiguous runs of scalars cut into
+    // chunk_size pieces. The master buffer comes first, then each worker in
+    // order; all share one layout, so piece s of every buffer has the same
+    // size.
+    void collect_segments(gradient_type& gradient) {
+      std::vector<std::pair<real_type*, size_type>> runs{};
+      auto collect = [&](real_type* data, size_type size) {
+        if (!runs.empty() && runs.back().first + runs.back().second == data) {
+          runs.back().second += size;
+        } else {
+          runs.emplace_back(data, size);
+        }
+      };
+      detail::for_each_segment(gradient, collect);
+
+      const auto first = segments_.empty();
+      for (const auto& [data, size] : runs) {
+        for (size_type offset = 0; offset < size; offset += chunk_size) {
+          segments_.push_back(data + offset);
+          if (first) {
+            sizes_.push_back(std::min(chunk_size, size - offset));
+          }
+        }
+      }
+    }
+
+    // Private Members
+    std::vector<worker_type> workers_;
+    gradient_type            gradient_{};
+    std::vector<real_type*>  segments_{};
+    std::vector<size_type>   sizes_{};
+  };
+}
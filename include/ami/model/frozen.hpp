@@ -0,0 +1,187 @@
+#pragma once
+
+#include <array>
+#include <concepts>
+#include <cstddef>
+#include <execution>
+#include <ios>
+#include <ostream>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "ami/concepts/layer.hpp"
+#include "ami/model/parameters.hpp"
+
+namespace ami::detail {
+
+  // Multiply-adds up to which a frozen dense layer is written out as one
+  // expression per weight rather than loops.
+  inline constexpr std::size_t frozen_unroll_limit = 512;
+
+  template <class Layer, const auto& Parameters, std::size_t Offset>
+  struct frozen_layer final {
+    static_assert(stateless_layer<Layer>,
+        "a frozen model holds only dense and stateless layers");
+
+    static constexpr void forward(
+        const typename Layer::input_type& input,
+        typename Layer::forward_type& result) {
+      Layer::template forward<std::execution::seq>(input, result);
+    }
+  };
+
+  // The weights are stored transposed, so every input adds a contiguous
+  // column to the outputs: the inner loop vectorises without reassociating
+  // the sums, and the outputs match dense_layer up to rounding.
+  template <dense_parameters Layer, const auto& Parameters, std::size_t Offset>
+  struct frozen_layer<Layer, Parameters, Offset> final {
+    using real_type = typename Layer::real_type;
+
+    static constexpr std::size_t input_size  = Layer::input_size;
+    static constexpr std::size_t output_size = Layer::output_size;
+
+    static constexpr auto columns = [] {
+      std::array<std::array<real_type, output_size>, input_size> result{};
+      for (std::size_t i = 0; i < output_size; ++i) {
+        for (std::size_t j = 0; j < input_size; ++j) {
+          result[j][i] = Parameters[Offset + i * input_size + j];
+        }
+      }
+      return result;
+    }();
+
+    static constexpr auto bias = [] {
+      std::array<real_type, output_size> result{};
+      for (std::size_t i = 0; i < output_size; ++i) {
+        result[i] = Parameters[Offset + output_size * input_size + i];
+      }
+      return result;
+    }();
+
+    static constexpr void forward(
+        const typename Layer::input_type& input,
+        typename Layer::forward_type& result) noexcept {
+      result = bias;
+      if constexpr (input_size * output_size <= frozen_unroll_limit) {
+        [&]<std::size_t... J>(std::index_sequence<J...>) {
+          (add_column<J>(input[J], result), ...);
+        }(std::make_index_sequence<input_size>{});
+      } else {
+        for (std::size_t j = 0; j < input_size; ++j) {
+          for (std::size_t i = 0; i < output_size; ++i) {
+            result[i] += columns[j][i] * input[j];
+          }
+        }
+      }
+    }
+
+  private:
+    template <std::size_t J>
+    static constexpr void add_column(
+        real_type x, typename Layer::forward_type& result) noexcept {
+      [&]<std::size_t... I>(std::index_sequence<I...>) {
+        ((result[I] += columns[J][I] * x), ...);
+      }(std::make_index_sequence<output_size>{});
+    }
+  };
+}
+
+namespace ami {
+
+  // Writes the parameters of model as C++ source defining
+  //
+  //   inline constexpr std::array<real_type, parameter_size<Model>> name
+  //
+  // in hexadecimal floating point, so the values survive exactly. Compiled
+  // into a program, the array can be handed to frozen. The parameters must
+  // be finite.
+  template <class Model>
+  std::ostream& write_parameters(
+      std::ostream& os, const Model& model, std::string_view name) {
+    using real_type = typename Model::real_type;
+    constexpr std::string_view type =
+        std::same_as<real_type, float> ? "float" :
+        std::same_as<real_type, double> ? "double" : "long double";
+    constexpr std::string_view suffix =
+        std::same_as<real_type, float> ? "f" :
+        std::same_as<real_type, double> ? "" : "L";
+    constexpr std::size_t per_line = 4;
+
+    const auto values = parameters(model);
+    const auto flags = os.flags();
+    os << "inline constexpr std::array<" << type << ", " << values.size()
+       << "> " << name << "{";
+    for (std::size_t i = 0; i < values.size(); ++i) {
+      os << (i % per_line == 0 ? "\n    " : " ") << std::hexfloat;
+      if constexpr (std::same_as<real_type, long double>) {
+        os << values[i];
+      } else {
+        os << static_cast<double>(values[i]);
+      }
+      os << suffix << (i + 1 < values.size() ? "," : "");
+    }
+    os << "};\n";
+    os.flags(flags);
+    return os;
+  }
+
+  // Inference-only form of Model with its parameters baked in at compile
+  // time. Parameters is a constexpr array laid out as by parameters(); the
+  // dense weights become static constexpr tables, so forward allocates
+  // nothing, branches on nothing but the activations themselves, and is
+  // fully unrolled for small layers. No gradient, optimizer or arena types
+  // of the model are instantiated; dropout is the identity, as in any
+  // inference pass.
+  template <class Model, const auto& Parameters>
+  class frozen final {
+  public:
+    // Public Types
+    using size_type    = std::size_t;
+    using layers_type  = typename detail::model_layers<Model>::type;
+    using front_type   = std::tuple_element_t<0, layers_type>;
+    using back_type    =
+        std::tuple_element_t<std::tuple_size_v<layers_type> - 1, layers_type>;
+    using real_type    = typename front_type::real_type;
+    using input_type   = typename front_type::input_type;
+    using forward_type = typename back_type::forward_type;
+
+    // Public Static Members
+    static constexpr size_type depth          = std::tuple_size_v<layers_type>;
+    static constexpr size_type input_size     = front_type::input_size;
+    static constexpr size_type output_size    = back_type::output_size;
+    static constexpr size_type parameter_size = ami::parameter_size<Model>;
+
+    static_assert(std::same_as<std::remove_cvref_t<decltype(Parameters)>,
+        std::array<real_type, parameter_size>>,
+        "Parameters must be a std::array<real_type, parameter_size<Model>>");
+
+    // Public Static Methods
+    static constexpr forward_type forward(const input_type& input) {
+      return forward_from<0>(input);
+    }
+
+  private:
+    // Private Types
+    template <size_type I>
+    using layer_type = std::tuple_element_t<I, layers_type>;
+
+    template <size_type I>
+    using frozen_layer_type = detail::frozen_layer<layer_type<I>, Parameters,
+        detail::parameter_offset<layers_type, I>()>;
+
+    // Private Static Methods
+    template <size_type I>
+    static constexpr forward_type forward_from(
+        const typename layer_type<I>::input_type& input) {
+      typename layer_type<I>::forward_type result{};
+      frozen_layer_type<I>::forward(input, result);
+      if constexpr (I + 1 == depth) {
+        return result;
+      } else {
+        return forward_from<I + 1>(result);
+      }
+    }
+  };
+}
@@ -0,0 +1,94 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <execution>
+#include <tuple>
+#include <utility>
+
+#include "ami/concepts/execution_policy.hpp"
+#include "ami/kernel/gemm.hpp"
+#include "ami/model/checkpoint.hpp"
+#include "ami/model/parameters.hpp"
+
+namespace ami {
+
+  // Inference-only form of Model reading its dense parameters straight out
+  // of a memory mapped checkpoint, so opening a model copies nothing and
+  // pages of weights are only read when first used. The checkpoint must
+  // outlive the model. Like frozen, only the layer types of Model are used
+  // and dropout is the identity.
+  template <class Model>
+  class mapped final {
+  public:
+    // Public Types
+    using size_type    = std::size_t;
+    using layers_type  = typename detail::model_layers<Model>::type;
+    using front_type   = std::tuple_element_t<0, layers_type>;
+    using back_type    =
+        std::tuple_element_t<std::tuple_size_v<layers_type> - 1, layers_type>;
+    using real_type    = typename front_type::real_type;
+    using input_type   = typename front_type::input_type;
+    using forward_type = typename back_type::forward_type;
+
+    // Public Static Members
+    static constexpr size_type depth       = std::tuple_size_v<layers_type>;
+    static constexpr size_type input_size  = front_type::input_size;
+    static constexpr size_type output_size = back_type::output_size;
+
+    static_assert([]<size_type... I>(std::index_sequence<I...>) {
+      return ((detail::dense_parameters<std::tuple_element_t<I, layers_type>> ||
+          detail::stateless_layer<std::tuple_element_t<I, layers_type>>) &&
+          ...);
+    }(std::make_index_sequence<depth>{}),
+        "a mapped model holds only dense and stateless layers");
+
+    // Constructor
+
+    // Throws checkpoint_error if source does not hold the layers of Model.
+    explicit mapped(const checkpoint& source) {
+      detail::check_checkpoint<Model>(source);
+      for (size_type i = 0; i < depth; ++i) {
+        parameters_[i] = source.parameters<real_type>(i).data();
+      }
+    }
+
+    // Public Methods
+    template <execution_policy auto P = std::execution::seq>
+    forward_type forward(const input_type& input) const {
+      return forward_from<P, 0>(input);
+    }
+
+  private:
+    // Private Types
+    template <size_type I>
+    using layer_type = std::tuple_element_t<I, layers_type>;
+
+    // Private Methods
+    template <execution_policy auto P, size_type I>
+    forward_type forward_from(
+        const typename layer_type<I>::input_type& input) const {
+      using current_type = layer_type<I>;
+      typename current_type::forward_type result{};
+      if constexpr (detail::dense_parameters<current_type>) {
+        constexpr auto rows = current_type::output_size;
+        constexpr auto cols = current_type::input_size;
+        const auto* weights = parameters_[I];
+        std::copy_n(weights + rows * cols, rows, result.begin());
+        kernel::gemv<P>(rows, cols, weights, cols, input.data(),
+            result.data());
+      } else {
+        current_type::template forward<P>(input, result);
+      }
+      if constexpr (I + 1 == depth) {
+        return result;
+      } else {
+        return forward_from<P, I + 1>(result);
+      }
+    }
+
+    // Private Members
+    std::array<const real_type*, depth> parameters_{};
+  };
+}
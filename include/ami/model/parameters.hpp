@@ -0,0 +1,103 @@
+#pragma once
+
+#include <array>
+#include <concepts>
+#include <cstddef>
+#include <execution>
+#include <tuple>
+#include <utility>
+
+#include "ami/concepts/layer.hpp"
+#include "ami/model/sequential.hpp"
+
+namespace ami::detail {
+
+  // Layers of a sequential, read off its template arguments so that the
+  // model class, with its arena and gradient types, is never instantiated.
+  template <class Model>
+  struct model_layers final {
+    using type = typename Model::layers_type;
+  };
+
+  template <class... Layers>
+  struct model_layers<sequential<Layers...>> final {
+    using type = std::tuple<Layers...>;
+  };
+
+  // A trainable layer holding an output_size x input_size weight matrix and
+  // a bias per output, exposed through weights(i) and biases().
+  template <class T>
+  concept dense_parameters = trainable_layer<T> &&
+      T::parameter_size == T::output_size * (T::input_size + 1) &&
+      requires(const T& layer, std::size_t i) {
+        { layer.weights(i)[0] } -> std::convertible_to<typename T::real_type>;
+        { layer.biases()[0] } -> std::convertible_to<typename T::real_type>;
+      };
+
+  // Layers other than dense ones, usable without an instance as activations
+  // and dropout are. Inference-only model forms hold nothing else.
+  template <class Layer>
+  concept stateless_layer = layer<Layer> && requires(
+      const typename Layer::input_type& input,
+      typename Layer::forward_type& result) {
+    Layer::template forward<std::execution::seq>(input, result);
+  };
+
+  template <class Layer>
+  inline constexpr std::size_t layer_parameter_size = 0;
+
+  template <dense_parameters Layer>
+  inline constexpr std::size_t layer_parameter_size<Layer> =
+      Layer::parameter_size;
+
+  template <class Layers, std::size_t I>
+  consteval std::size_t parameter_offset() {
+    if constexpr (I == 0) {
+      return 0;
+    } else {
+      return parameter_offset<Layers, I - 1>() +
+          layer_parameter_size<std::tuple_element_t<I - 1, Layers>>;
+    }
+  }
+}
+
+namespace ami {
+
+  // Number of parameters of a model: the weights and biases of its dense
+  // layers.
+  template <class Model>
+  inline constexpr std::size_t parameter_size =
+      []<std::size_t... I>(std::index_sequence<I...>) {
+        using layers_type = typename detail::model_layers<Model>::type;
+        return (std::size_t{} + ... + detail::layer_parameter_size<
+            std::tuple_element_t<I, layers_type>>);
+      }(std::make_index_sequence<std::tuple_size_v<
+          typename detail::model_layers<Model>::type>>{});
+
+  // The parameters of model in layer order, each dense layer as its weights
+  // row by row followed by its biases. This is the layout frozen expects
+  // and checkpoints store.
+  template <class Model>
+  constexpr auto parameters(const Model& model) {
+    using layers_type = typename detail::model_layers<Model>::type;
+    std::array<typename Model::real_type, parameter_size<Model>> result{};
+    [&]<std::size_t... L>(std::index_sequence<L...>) {
+      const auto copy = [&]<std::size_t I>(const auto& layer) {
+        using layer_type = std::tuple_element_t<I, layers_type>;
+        if constexpr (detail::dense_parameters<layer_type>) {
+          auto offset = detail::parameter_offset<layers_type, I>();
+          for (std::size_t i = 0; i < layer_type::output_size; ++i) {
+            for (const auto w : layer.weights(i)) {
+              result[offset++] = w;
+            }
+          }
+          for (const auto b : layer.biases()) {
+            result[offset++] = b;
+          }
+        }
+      };
+      (copy.template operator()<L>(std::get<L>(model.layers())), ...);
+    }(std::make_index_sequence<std::tuple_size_v<layers_type>>{});
+    return result;
+  }
+}
@@ -0,0 +1,202 @@
+#pragma once
+
+#include <array>
+#include <concepts>
+#include <cstddef>
+#include <execution>
+#include <span>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "ami/concepts/execution_policy.hpp"
+#include "ami/concepts/layer.hpp"
+#include "ami/layer/quantized_dense_layer.hpp"
+#include "ami/model/parameters.hpp"
+#include "ami/utility/quantization.hpp"
+
+namespace ami::detail {
+
+  // Dense layers become quantized_dense_layer; activations and dropout
+  // stay as they are.
+  template <class Layer>
+  struct quantized_layer final {
+    static_assert(stateless_layer<Layer>,
+        "a quantized model holds only dense and stateless layers");
+
+    using type = Layer;
+  };
+
+  template <dense_parameters Layer>
+  struct quantized_layer<Layer> final {
+    using type = quantized_dense_layer_t<typename Layer::real_type,
+        Layer::input_size, Layer::output_size>;
+  };
+
+  template <class Layers>
+  struct quantized_layers;
+
+  template <class... Layers>
+  struct quantized_layers<std::tuple<Layers...>> final {
+    using type = std::tuple<typename quantized_layer<Layers>::type...>;
+  };
+
+  template <class T>
+  concept quantized_dense = requires {
+    typename T::quantized_input_type;
+  };
+}
+
+namespace ami {
+
+  // Inference-only form of Model with int8 dense layers, for serving; a
+  // quarter of the weight memory of a float model. The input quantization
+  // of each dense layer is calibrated on sample inputs: the float model
+  // runs over them, and each dense layer takes the range of the inputs it
+  // saw.
+  //
+  // A dense layer followed by another, directly or through an activation,
+  // hands it uint8 outputs: the activation and the quantization for the
+  // next layer run in the pass that dequantizes the int32 sums. Dropout is
+  // the identity, as in any inference pass.
+  template <class Model>
+  class quantized final {
+  public:
+    // Public Types
+    using size_type    = std::size_t;
+    using model_layers_type = typename detail::model_layers<Model>::type;
+    using layers_type  =
+        typename detail::quantized_layers<model_layers_type>::type;
+    using front_type   = std::tuple_element_t<0, layers_type>;
+    using back_type    =
+        std::tuple_element_t<std::tuple_size_v<layers_type> - 1, layers_type>;
+    using real_type    = typename front_type::real_type;
+    using input_type   = typename front_type::input_type;
+    using forward_type = typename back_type::forward_type;
+
+    // Public Static Members
+    static constexpr size_type depth       = std::tuple_size_v<layers_type>;
+    static constexpr size_type input_size  = front_type::input_size;
+    static constexpr size_type output_size = back_type::output_size;
+
+    // Constructor
+    quantized() = default;
+
+    quantized(const Model& model, std::span<const input_type> samples) {
+      std::array<range_calibrator<real_type>, depth> calibrators{};
+      for (const auto& sample : samples) {
+        observe<0>(model, sample, calibrators);
+      }
+      [&]<size_type... I>(std::index_sequence<I...>) {
+        const auto assign = [&]<size_type L>(auto& layer) {
+          if constexpr (detail::quantized_dense<
+                            std::tuple_element_t<L, layers_type>>) {
+            layer.assign(std::get<L>(model.layers()),
+                calibrators[L].make_quantization());
+          }
+        };
+        (assign.template operator()<I>(std::get<I>(layers_)), ...);
+      }(std::make_index_sequence<depth>{});
+    }
+
+    // Public Methods
+    template <execution_policy auto P = std::execution::seq>
+    constexpr forward_type forward(const input_type& input) const {
+      return forward_from<P, 0>(input);
+    }
+
+    // Getter
+    constexpr const layers_type& layers() const noexcept { return layers_; }
+
+  private:
+    // Private Types
+    template <size_type I>
+    using layer_type = std::tuple_element_t<I, layers_type>;
+
+    // Private Static Methods
+
+    // Runs layer I of the float model and those after it on input, noting
+    // the inputs of the dense layers.
+    template <size_type I, class Input>
+    static void observe(
+        const Model& model, const Input& input,
+        std::array<range_calibrator<real_type>, depth>& calibrators) {
+      if constexpr (I < depth) {
+        using model_layer_type = std::tuple_element_t<I, model_layers_type>;
+        typename model_layer_type::forward_type result{};
+        if constexpr (detail::quantized_dense<layer_type<I>>) {
+          calibrators[I].observe(input);
+          std::get<I>(model.layers()).template
+              forward<std::execution::seq>(input, result);
+        } else {
+          model_layer_type::template forward<std::execution::seq>(
+              input, result);
+        }
+        observe<I + 1>(model, result, calibrators);
+      }
+    }
+
+    // Whether layer I is followed by an activation, which then runs in the
+    // epilogue of layer I.
+    template <size_type I>
+    static consteval bool activated() {
+      if constexpr (I + 1 < depth) {
+        return detail::elementwise_activation<layer_type<I + 1>>;
+      } else {
+        return false;
+      }
+    }
+
+    // Whether the layer after dense layer I and its activation is dense as
+    // well, and takes the output of layer I quantized.
+    template <size_type I>
+    static consteval bool quantized_output() {
+      constexpr auto next = activated<I>() ? I + 2 : I + 1;
+      if constexpr (next < depth) {
+        return detail::quantized_dense<layer_type<next>>;
+      } else {
+        return false;
+      }
+    }
+
+    // Private Methods
+
+    // Input is a real array, or uint8 for a dense layer I whose
+    // predecessor quantized its output.
+    template <execution_policy auto P, size_type I, class Input>
+    constexpr forward_type forward_from(const Input& input) const {
+      if constexpr (I == depth) {
+        return input;
+      } else if constexpr (detail::quantized_dense<layer_type<I>>) {
+        const auto& layer = std::get<I>(layers_);
+        const auto epilogue = [](size_type, real_type z) {
+          if constexpr (activated<I>()) {
+            return layer_type<I + 1>::function_type::template
+                f<real_type>(z);
+          } else {
+            return z;
+          }
+        };
+        constexpr auto next = activated<I>() ? I + 2 : I + 1;
+
+        if constexpr (quantized_output<I>()) {
+          typename layer_type<I>::quantized_forward_type result{};
+          layer.template forward<P>(input, result,
+              std::get<next>(layers_).input_quantization(), epilogue);
+          return forward_from<P, next>(result);
+        } else {
+          typename layer_type<I>::forward_type result{};
+          layer.template forward<P>(input, result, epilogue);
+          return forward_from<P, next>(result);
+        }
+      } else {
+        typename layer_type<I>::forward_type result{};
+        layer_type<I>::template forward<P>(input, result);
+        return forward_from<P, I + 1>(result);
+      }
+    }
+
+    // Private Members
+    layers_type layers_{};
+  };
+}
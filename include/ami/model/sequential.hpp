@@ -0,0 +1,498 @@
+#pragma once
+
+#include <concepts>
+#include <cstddef>
+#include <execution>
+#include <random>
+#include <span>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "ami/concepts/activation_function.hpp"
+#include "ami/concepts/execution_policy.hpp"
+#include "ami/concepts/layer.hpp"
+#include "ami/concepts/optimizer.hpp"
+#include "ami/kernel/gemm.hpp"
+
+namespace ami::detail {
+
+  // Layers whose derivative is computed from their own output (activations
+  // with df_from_output) instead of their input.
+  template <class T>
+  concept backward_from_output = requires {
+    requires T::backward_from_output;
+  };
+
+  template <class Layer>
+  struct layer_gradient final {
+    using type = std::tuple<>;
+  };
+
+  template <trainable_layer Layer>
+  struct layer_gradient<Layer> final {
+    using type = typename Layer::gradient_type;
+  };
+
+  template <class Layer>
+  struct layer_mask final {
+    using type = std::tuple<>;
+  };
+
+  template <class Layer>
+  requires requires { typename Layer::mask_type; }
+  struct layer_mask<Layer> final {
+    using type = typename Layer::mask_type;
+  };
+
+  template <class Layer, class Optimizer>
+  struct layer_optimizer final {
+    using type = std::tuple<>;
+  };
+
+  template <trainable_layer Layer, class Optimizer>
+  requires requires { typename Layer::template optimizer_type<Optimizer>; }
+  struct layer_optimizer<Layer, Optimizer> final {
+    using type = typename Layer::template optimizer_type<Optimizer>;
+  };
+
+  // A trainable layer whose forward accepts a per-output epilogue.
+  template <class T>
+  concept epilogue_layer = trainable_layer<T> && requires(
+      const T& layer, const typename T::input_type& input,
+      typename T::forward_type& result) {
+    layer.template forward<std::execution::seq>(
+        input, result, kernel::identity_epilogue{});
+  };
+
+  template <class T>
+  concept elementwise_activation = layer<T> && requires {
+    typename T::function_type;
+  };
+
+  template <class T>
+  concept elementwise_dropout = layer<T> && requires(
+      typename T::real_type input, bool keep) {
+    typename T::mask_type;
+    { T::apply_mask(input, keep) } -> std::same_as<typename T::real_type>;
+  };
+
+  // Activations that back propagate from their output. The model writes
+  // their output over their input rather than keeping both where it can.
+  template <class T>
+  concept in_place_activation =
+      elementwise_activation<T> && backward_from_output<T>;
+
+  // Whether layer I writes its output over its input. Only in-place
+  // activations do, and not after a layer that back propagates from its
+  // output, which would be lost.
+  template <class Layers, std::size_t I>
+  consteval bool shares_input_slot() {
+    if constexpr (!in_place_activation<std::tuple_element_t<I, Layers>>) {
+      return false;
+    } else if constexpr (I == 0) {
+      return true;
+    } else {
+      return !backward_from_output<std::tuple_element_t<I - 1, Layers>>;
+    }
+  }
+
+  // Arena slot holding the input of layer I, or the model output for I
+  // equal to the depth.
+  template <class Layers, std::size_t I>
+  consteval std::size_t activation_slot() {
+    if constexpr (I == 0) {
+      return 0;
+    } else {
+      return activation_slot<Layers, I - 1>() +
+          (shares_input_slot<Layers, I - 1>() ? 0 : 1);
+    }
+  }
+
+  template <class Layers, class Slots, std::size_t I = 0>
+  struct activation_slots final {
+    using type = Slots;
+  };
+
+  template <class Layers, class... Slots, std::size_t I>
+  requires (I < std::tuple_size_v<Layers>)
+  struct activation_slots<Layers, std::tuple<Slots...>, I> final {
+    using type = typename activation_slots<Layers, std::conditional_t<
+        shares_input_slot<Layers, I>(), std::tuple<Slots...>,
+        std::tuple<Slots...,
+                   typename std::tuple_element_t<I, Layers>::forward_type>>,
+        I + 1>::type;
+  };
+
+  // Number of layers starting at I that run as one fused step: a layer with
+  // an epilogue followed by an activation, optionally followed by dropout.
+  template <class Layers, std::size_t I>
+  consteval std::size_t fused_length() {
+    constexpr auto size = std::tuple_size_v<Layers>;
+    if constexpr (I + 1 < size) {
+      if constexpr (
+          epilogue_layer<std::tuple_element_t<I, Layers>> &&
+          elementwise_activation<std::tuple_element_t<I + 1, Layers>>) {
+        if constexpr (I + 2 < size) {
+          if constexpr (
+              elementwise_dropout<std::tuple_element_t<I + 2, Layers>>) {
+            return 3;
+          }
+        }
+        return 2;
+      }
+    }
+    return 1;
+  }
+
+  // A training pass of dropout keeps its mask for backward.
+  template <execution_policy auto P, class Layer, class... G>
+  constexpr void forward_layer(
+      const Layer& layer, const typename Layer::input_type& input,
+      typename Layer::forward_type& result,
+      typename layer_mask<Layer>::type& mask, G&... engine) {
+    if constexpr (sizeof...(G) > 0 && elementwise_dropout<Layer>) {
+      mask = Layer::template make_mask<P>(engine...);
+      layer.template forward<P>(input, result, mask);
+    } else if constexpr (sizeof...(G) > 0 &&
+        requires { layer.template forward<P>(input, result, engine...); }) {
+      layer.template forward<P>(input, result, engine...);
+    } else {
+      layer.template forward<P>(input, result);
+    }
+  }
+
+  template <execution_policy auto P, class Layer, class Gradient>
+  constexpr void backward_layer(
+      const Layer& layer, const typename Layer::input_type& input,
+      const typename Layer::forward_type& output,
+      const typename layer_mask<Layer>::type& mask,
+      const typename Layer::delta_type& delta, Gradient& gradient,
+      typename Layer::backward_type& result) {
+    if constexpr (trainable_layer<Layer>) {
+      layer.template calc_gradient<P>(input, delta, gradient);
+      layer.template backward<P>(delta, result);
+    } else if constexpr (elementwise_dropout<Layer>) {
+      Layer::template backward<P>(mask, delta, result);
+    } else if constexpr (in_place_activation<Layer>) {
+      Layer::template backward_output<P>(output, delta, result);
+    } else if constexpr (backward_from_output<Layer>) {
+      Layer::template backward<P>(output, delta, result);
+    } else {
+      Layer::template backward<P>(input, delta, result);
+    }
+  }
+
+  template <execution_policy auto P, class Layer, class Optimizer,
+            class Gradient>
+  constexpr void update_layer(
+      Layer& layer, Optimizer& optimizer, const Gradient& gradient) {
+    if constexpr (trainable_layer<Layer>) {
+      layer.template update<P>(optimizer, gradient);
+    }
+  }
+}
+
+namespace ami {
+
+  template <layer... Layers>
+  requires (sizeof...(Layers) > 0)
+  class sequential final {
+  public:
+    // Public Types
+    using size_type   = std::size_t;
+    using layers_type = std::tuple<Layers...>;
+    using front_type  = std::tuple_element_t<0, layers_type>;
+    using back_type   =
+        std::tuple_element_t<sizeof...(Layers) - 1, layers_type>;
+    using real_type     = typename front_type::real_type;
+    using input_type    = typename front_type::input_type;
+    using forward_type  = typename back_type::forward_type;
+    using backward_type = typename front_type::backward_type;
+    using delta_type    = typename back_type::delta_type;
+    using gradient_type =
+        std::tuple<typename detail::layer_gradient<Layers>::type...>;
+
+    template <class Optimizer>
+    requires optimizer<Optimizer> || buffer_optimizer_family<Optimizer>
+    using optimizer_type = std::tuple<
+        typename detail::layer_optimizer<Layers, Optimizer>::type...>;
+
+    // The model input followed by the output of every layer, and the delta
+    // handed back by every layer, and the dropout masks of the last training
+    // pass. Sized at compile time, so a training step never allocates.
+    // Fused steps leave inner slots they do not need unwritten. In-place
+    // activations have no slot of their own unless the layer before needs
+    // its output kept.
+    struct arena_type final {
+      typename detail::activation_slots<
+          layers_type, std::tuple<input_type>>::type activations{};
+      std::tuple<typename detail::layer_mask<Layers>::type...> masks{};
+      std::tuple<typename Layers::backward_type...> deltas{};
+    };
+
+    // Public Static Members
+    static constexpr size_type depth       = sizeof...(Layers);
+    static constexpr size_type input_size  = front_type::input_size;
+    static constexpr size_type output_size = back_type::output_size;
+
+    // Constructor
+    sequential() = default;
+
+    explicit constexpr sequential(Layers... layers)
+        : layers_{std::move(layers)...} {}
+
+    // Public Methods
+
+    // Inference pass. Every intermediate result is written into the arena
+    // and the returned reference stays valid until the next forward.
+    template <execution_policy auto P = std::execution::seq>
+    constexpr const forward_type& forward(const input_type& input) {
+      return forward<P>(input, arena_);
+    }
+
+    // Training pass; layers that draw random numbers (dropout) use engine.
+    template <execution_policy auto P = std::execution::seq,
+              std::uniform_random_bit_generator G>
+    constexpr const forward_type& forward(const input_type& input, G& engine) {
+      return forward<P>(input, arena_, engine);
+    }
+
+    // Back propagates delta through the activations of the last forward, in
+    // reverse layer order. Gradients are accumulated into gradient.
+    template <execution_policy auto P = std::execution::seq>
+    constexpr const backward_type& backward(
+        const delta_type& delta, gradient_type& gradient) {
+      return backward<P>(delta, gradient, arena_);
+    }
+
+    // The same passes over a caller owned arena. They leave the model
+    // untouched, so several threads may run them at once with an arena each.
+    template <execution_policy auto P = std::execution::seq,
+              std::uniform_random_bit_generator... G>
+    requires (sizeof...(G) <= 1)
+    constexpr const forward_type& forward(
+        const input_type& input, arena_type& arena, G&... engine) const {
+      activation<0>(arena) = input;
+      forward_from<P, 0>(arena, engine...);
+      return activation<depth>(arena);
+    }
+
+    template <execution_policy auto P = std::execution::seq>
+    constexpr const backward_type& backward(
+        const delta_type& delta, gradient_type& gradient,
+        arena_type& arena) const {
+      backward_from<P, 0>(delta, gradient, arena);
+      return std::get<0>(arena.deltas);
+    }
+
+    template <execution_policy auto P = std::execution::seq,
+              class... Optimizers>
+    requires (sizeof...(Optimizers) == depth)
+    constexpr void update(
+        std::tuple<Optimizers...>& optimizer, const gradient_type& gradient) {
+      [&]<size_type... I>(std::index_sequence<I...>) {
+        (detail::update_layer<P>(std::get<I>(layers_), std::get<I>(optimizer),
+            std::get<I>(gradient)), ...);
+      }(std::make_index_sequence<depth>{});
+    }
+
+    // Getter
+    constexpr layers_type& layers() noexcept { return layers_; }
+
+    constexpr const layers_type& layers() const noexcept { return layers_; }
+
+  private:
+    // Each layer must consume exactly what its predecessor produces.
+    static_assert([]<size_type... I>(std::index_sequence<I...>) {
+      return ((std::tuple_element_t<I, layers_type>::output_size ==
+          std::tuple_element_t<I + 1, layers_type>::input_size) && ...);
+    }(std::make_index_sequence<depth - 1>{}),
+        "output_size of each layer must equal input_size of the next");
+    static_assert([]<size_type... I>(std::index_sequence<I...>) {
+      return (std::same_as<
+          typename std::tuple_element_t<I, layers_type>::forward_type,
+          typename std::tuple_element_t<I + 1, layers_type>::input_type> &&
+          ...);
+    }(std::make_index_sequence<depth - 1>{}),
+        "forward_type of each layer must be input_type of the next");
+
+    // Private Static Methods
+    template <size_type I>
+    static constexpr auto& activation(arena_type& arena) noexcept {
+      return std::get<detail::activation_slot<layers_type, I>()>(
+          arena.activations);
+    }
+
+    // Private Methods
+    template <execution_policy auto P, size_type I, class... G>
+    constexpr void forward_from(arena_type& arena, G&... engine) const {
+      if constexpr (I < depth) {
+        constexpr auto length = detail::fused_length<layers_type, I>();
+        if constexpr (length == 1) {
+          detail::forward_layer<P>(std::get<I>(layers_),
+              activation<I>(arena), activation<I + 1>(arena),
+              std::get<I>(arena.masks), engine...);
+        } else {
+          forward_fused<P, I, length>(arena, engine...);
+        }
+        forward_from<P, I + length>(arena, engine...);
+      }
+    }
+
+    // The activation (and dropout) run in the epilogue of layer I. Layer I
+    // still stores its pre-activation output, which backward needs for df,
+    // or the activation output when the activation is in place; a separate
+    // activation output is skipped when dropout follows.
+    template <execution_policy auto P, size_type I, size_type Length,
+              class... G>
+    constexpr void forward_fused(arena_type& arena, G&... engine) const {
+      using activation_type = std::tuple_element_t<I + 1, layers_type>;
+      using function_type = typename activation_type::function_type;
+      using layer_real_type = typename activation_type::real_type;
+
+      auto& output = activation<I + Length>(arena);
+      const auto forward = [&](auto epilogue) {
+        std::get<I>(layers_).template forward<P>(
+            activation<I>(arena), activation<I + 1>(arena), epilogue);
+      };
+      const auto stored = [](layer_real_type z, layer_real_type y) {
+        if constexpr (detail::in_place_activation<activation_type>) {
+          return y;
+        } else {
+          return z;
+        }
+      };
+
+      if constexpr (Length == 3 && sizeof...(G) > 0) {
+        using dropout_type = std::tuple_element_t<I + 2, layers_type>;
+        auto& mask = std::get<I + 2>(arena.masks);
+        mask = dropout_type::template make_mask<P>(engine...);
+        forward([&](size_type i, layer_real_type z) {
+          const auto y = function_type::template f<layer_real_type>(z);
+          output[i] = dropout_type::apply_mask(y, mask[i]);
+          return stored(z, y);
+        });
+      } else {
+        forward([&](size_type i, layer_real_type z) {
+          const auto y = function_type::template f<layer_real_type>(z);
+          output[i] = y;
+          return stored(z, y);
+        });
+      }
+    }
+
+    // Steps are visited from the front but run on the way back out of the
+    // recursion, i.e. in reverse layer order.
+    template <execution_policy auto P, size_type I>
+    constexpr void backward_from(
+        const delta_type& delta, gradient_type& gradient,
+        arena_type& arena) const {
+      if constexpr (I < depth) {
+        constexpr auto length = detail::fused_length<layers_type, I>();
+        backward_from<P, I + length>(delta, gradient, arena);
+
+        const auto& step_delta = [&]() -> const auto& {
+          if constexpr (I + length == depth) {
+            return delta;
+          } else {
+            return std::get<I + length>(arena.deltas);
+          }
+        }();
+
+        if constexpr (length == 1) {
+          detail::backward_layer<P>(std::get<I>(layers_),
+              activation<I>(arena), activation<I + 1>(arena),
+              std::get<I>(arena.masks), step_delta, std::get<I>(gradient),
+              std::get<I>(arena.deltas));
+        } else {
+          backward_fused<P, I, length>(step_delta, gradient, arena);
+        }
+      }
+    }
+
+    // df * delta (after the dropout mask) is formed in a single pass and
+    // handed straight to the backward of layer I.
+    template <execution_policy auto P, size_type I, size_type Length,
+              class Delta>
+    constexpr void backward_fused(
+        const Delta& delta, gradient_type& gradient, arena_type& arena) const {
+      using activation_type = std::tuple_element_t<I + 1, layers_type>;
+      using function_type = typename activation_type::function_type;
+
+      using activation_real_type = typename activation_type::real_type;
+
+      // the activation output instead when in place
+      const auto& z = activation<I + 1>(arena);
+      auto& fused_delta = std::get<I + 1>(arena.deltas);
+      if constexpr (Length == 2 &&
+                    !detail::in_place_activation<activation_type> &&
+                    batch_activation_function<
+                        function_type, activation_real_type>) {
+        function_type::df_batch(std::span<const activation_real_type>{z},
+            std::span<const activation_real_type>{delta},
+            std::span<activation_real_type>{fused_delta});
+      } else {
+        for (size_type i = 0; i < activation_type::output_size; ++i) {
+          auto d = delta[i];
+          if constexpr (Length == 3) {
+            using dropout_type = std::tuple_element_t<I + 2, layers_type>;
+            d = dropout_type::apply_mask(d, std::get<I + 2>(arena.masks)[i]);
+          }
+          if constexpr (detail::in_place_activation<activation_type>) {
+            fused_delta[i] = function_type::df_from_output(z[i]) * d;
+          } else {
+            fused_delta[i] = function_type::df(z[i]) * d;
+          }
+        }
+      }
+
+      std::get<I>(layers_).template calc_gradient<P>(
+          activation<I>(arena), fused_delta, std::get<I>(gradient));
+      std::get<I>(layers_).template backward<P>(
+          fused_delta, std::get<I>(arena.deltas));
+    }
+
+    // Private Members
+    layers_type layers_{};
+    arena_type arena_{};
+  };
+}
+
+namespace ami::detail {
+
+  template <std::floating_point RealType, std::size_t InputSize, class Result,
+            class... Layers>
+  struct make_sequential final {
+    using type = Result;
+  };
+
+  template <std::floating_point RealType, std::size_t InputSize,
+            class... Result, class Layer, class... Layers>
+  struct make_sequential<
+      RealType, InputSize, std::tuple<Result...>, Layer, Layers...> final {
+    using layer_type = typename Layer::template type<RealType, InputSize>;
+    using type = typename make_sequential<RealType, layer_type::output_size,
+        std::tuple<Result..., layer_type>, Layers...>::type;
+  };
+
+  template <class Tuple>
+  struct tuple_to_sequential;
+
+  template <class... Layers>
+  struct tuple_to_sequential<std::tuple<Layers...>> final {
+    using type = sequential<Layers...>;
+  };
+}
+
+namespace ami {
+
+  // Chains layer templates (dense_layer<N>, activation_layer<F>, ...), taking
+  // each input_size from the output_size of the previous layer.
+  template <std::floating_point RealType, std::size_t InputSize,
+            class... Layers>
+  requires (sizeof...(Layers) > 0)
+  using sequential_t = typename detail::tuple_to_sequential<
+      typename detail::make_sequential<
+          RealType, InputSize, std::tuple<>, Layers...>::type>::type;
+}
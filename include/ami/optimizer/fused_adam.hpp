@@ -0,0 +1,196 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <concepts>
+#include <cstddef>
+#include <execution>
+#include <ranges>
+#include <span>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "ami/concepts/execution_policy.hpp"
+#include "ami/kernel/adam.hpp"
+#include "ami/utility/aligned_allocator.hpp"
+#include "ami/utility/parallel_algorithm.hpp"
+
+namespace ami {
+
+  // Adam over whole parameter buffers. The moments are kept as two flat
+  // arrays and every parameter shares one step counter, so the state is two
+  // scalars per parameter instead of four, and a step is one vectorized loop
+  // per tensor. With Size std::dynamic_extent the buffer is sized at run
+  // time and the moments live on the heap, for tables too large for arrays.
+  template <double LearningRate = 0.001, double Beta1 = 0.9,
+            double Beta2 = 0.999, double Eps = 1e-7>
+  requires (LearningRate > 0.0 && Beta1 >= 0.0 && Beta1 < 1.0 &&
+            Beta2 >= 0.0 && Beta2 < 1.0 && Eps > 0.0)
+  struct fused_adam final {
+    template <std::floating_point RealType, std::size_t Size>
+    requires (Size > 0)
+    class type final {
+    public:
+      // Public Types
+      using size_type   = std::size_t;
+      using real_type   = RealType;
+      // A parameter tensor and its gradient.
+      using tensor_type =
+          std::pair<std::span<real_type>, std::span<const real_type>>;
+
+      // Public Static Members
+      static constexpr size_type size = Size;
+      static constexpr size_type alignment = 64;
+      static constexpr real_type learning_rate =
+          static_cast<real_type>(LearningRate);
+      static constexpr real_type beta1 = static_cast<real_type>(Beta1);
+      static constexpr real_type beta2 = static_cast<real_type>(Beta2);
+      static constexpr real_type eps = static_cast<real_type>(Eps);
+
+      // Elements per task on parallel policies.
+      static constexpr size_type chunk_size = 4096;
+
+      // Runs the Adam step of a lazy step over parameters named by their
+      // position in the moment buffers. Distinct parameters may be updated
+      // from several threads at once.
+      class lazy_update_type final {
+      public:
+        // Parameter i, through the same kernel as a run.
+        constexpr void operator()(
+            size_type i, real_type& weight, real_type gradient) const {
+          kernel::adam(size_type{1}, &weight, &gradient, m_ + i, v_ + i,
+              coefficients_);
+        }
+
+        // The parameters from i on, one per weight.
+        constexpr void operator()(
+            size_type i, std::span<real_type> weight,
+            std::span<const real_type> gradient) const {
+          kernel::adam(weight.size(), weight.data(), gradient.data(),
+              m_ + i, v_ + i, coefficients_);
+        }
+
+      private:
+        friend type;
+
+        constexpr lazy_update_type(
+            real_type* m, real_type* v,
+            const kernel::adam_coefficients<real_type>& coefficients)
+            : m_{m}, v_{v}, coefficients_{coefficients} {}
+
+        real_type* m_;
+        real_type* v_;
+        kernel::adam_coefficients<real_type> coefficients_;
+      };
+
+      // Constructor
+      type() = default;
+
+      explicit type(size_type parameters)
+      requires (Size == std::dynamic_extent)
+          : m_(parameters), v_(parameters) {}
+
+      // Public Methods
+
+      // Runs one step over every tensor. Tensors are laid end to end over
+      // the moment buffers, in the order given, and must cover exactly size
+      // parameters.
+      template <execution_policy auto P = std::execution::seq>
+      constexpr void operator()(std::span<const tensor_type> tensors) {
+        const auto coefficients = current_coefficients();
+        size_type offset = 0;
+        for (const auto& [weight, gradient] : tensors) {
+          update<P>(weight.size(), weight.data(), gradient.data(),
+              m_.data() + offset, v_.data() + offset, coefficients);
+          offset += weight.size();
+        }
+        advance();
+      }
+
+      template <execution_policy auto P = std::execution::seq>
+      constexpr void operator()(
+          std::span<real_type, size> weight,
+          std::span<const real_type, size> gradient) {
+        const std::array tensors{tensor_type{weight, gradient}};
+        operator()<P>(tensors);
+      }
+
+      // Runs one step over only the parameters f passes to the
+      // lazy_update_type it is called with; the moments of the others are
+      // left as they were rather than decayed, as in TensorFlow's LazyAdam.
+      // The bias corrections still advance, so the step count is global.
+      template <class F>
+      requires std::is_invocable_v<F&, const lazy_update_type&>
+      constexpr void step(F f) {
+        const lazy_update_type update{
+            m_.data(), v_.data(), current_coefficients()};
+        f(update);
+        advance();
+      }
+
+      // Getter
+      constexpr std::span<const real_type, size> m() const noexcept {
+        return m_;
+      }
+
+      constexpr std::span<const real_type, size> v() const noexcept {
+        return v_;
+      }
+
+    private:
+      // Private Static Methods
+      template <execution_policy auto P>
+      static constexpr void update(
+          size_type n, real_type* weight, const real_type* gradient,
+          real_type* m, real_type* v,
+          const kernel::adam_coefficients<real_type>& coefficients) {
+        if constexpr (adaptive_policy<P>) {
+          utility::resolve<P>(n, [&]<execution_policy auto Q> {
+                update<Q>(n, weight, gradient, m, v, coefficients);
+              });
+        } else if constexpr (sequenced_policy<P> || unsequenced_policy<P>) {
+          kernel::adam(n, weight, gradient, m, v, coefficients);
+        } else {
+          utility::for_each<P>(std::views::iota(size_type{},
+                  (n + chunk_size - 1) / chunk_size),
+              [&](auto block) {
+                const auto begin = block * chunk_size;
+                kernel::adam(std::min(chunk_size, n - begin), weight + begin,
+                    gradient + begin, m + begin, v + begin, coefficients);
+              });
+        }
+      }
+
+      // Private Methods
+      constexpr kernel::adam_coefficients<real_type>
+      current_coefficients() const noexcept {
+        return {learning_rate, beta1, beta2, eps,
+            real_type{1} - pow_beta1_, real_type{1} - pow_beta2_};
+      }
+
+      constexpr void advance() noexcept {
+        pow_beta1_ *= beta1;
+        pow_beta2_ *= beta2;
+      }
+
+      // Private Types
+      using moment_type = std::conditional_t<Size == std::dynamic_extent,
+          std::vector<real_type,
+                      utility::aligned_allocator<real_type, alignment>>,
+          std::array<real_type, Size>>;
+
+      // Private Members
+      alignas(alignment) moment_type m_{};
+      alignas(alignment) moment_type v_{};
+      real_type pow_beta1_{beta1};
+      real_type pow_beta2_{beta2};
+    };
+  };
+
+  template <std::floating_point RealType, std::size_t Size,
+            double LearningRate = 0.001, double Beta1 = 0.9,
+            double Beta2 = 0.999, double Eps = 1e-7>
+  using fused_adam_t = typename fused_adam<
+      LearningRate, Beta1, Beta2, Eps>::template type<RealType, Size>;
+}
@@ -0,0 +1,100 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <concepts>
+#include <cstddef>
+#include <limits>
+#include <ranges>
+#include <tuple>
+#include <type_traits>
+
+namespace ami {
+
+  // Dynamic loss scaling, a standalone utility for callers who keep their
+  // own float16 deltas or gradients, whose smallest normal value is 2^-14:
+  // the loss gradient is multiplied by scale() before back propagation so
+  // small values do not flush to zero, and unscale divides the gradients
+  // back before the update. bfloat16 has the range of float and needs no
+  // scaling.
+  //
+  // The layers here back propagate in their real_type, mixed_dense_layer
+  // included, so they need none either; the scale being a power of two, a
+  // scaled step through them updates exactly as an unscaled one.
+  //
+  // A step whose gradients are not all finite must be skipped; update then
+  // halves the scale. After GrowthInterval finite steps in a row the scale
+  // doubles again, so it settles just below the overflow point.
+  template <std::floating_point RealType, std::size_t GrowthInterval = 2000>
+  requires (GrowthInterval > 0)
+  class loss_scaler final {
+  public:
+    // Public Types
+    using size_type = std::size_t;
+    using real_type = RealType;
+
+    // Public Static Members
+    static constexpr size_type growth_interval = GrowthInterval;
+
+    // Constructor
+    explicit constexpr loss_scaler(real_type scale = real_type{65536})
+        : scale_{scale} {}
+
+    // Public Methods
+
+    // Divides every value of gradient, built of real_type values in arrays,
+    // ranges, pairs and tuples (a layer's or a whole model's gradient), by
+    // scale(). Returns whether all of them are finite.
+    template <class Gradient>
+    constexpr bool unscale(Gradient& gradient) const {
+      return unscale(gradient, real_type{1} / scale_);
+    }
+
+    // Adjusts the scale after a step; finite is the result of unscale.
+    constexpr void update(bool finite) noexcept {
+      if (!finite) {
+        scale_ = std::max(scale_ / 2, real_type{1});
+        finite_steps_ = 0;
+      } else if (++finite_steps_ == growth_interval) {
+        scale_ *= 2;
+        finite_steps_ = 0;
+      }
+    }
+
+    // Getter
+    constexpr real_type scale() const noexcept { return scale_; }
+
+  private:
+    // Private Static Methods
+    template <class T>
+    static constexpr bool unscale(T& value, real_type inverse) {
+      if constexpr (std::same_as<T, real_type>) {
+        value *= inverse;
+        return std::abs(value) <= std::numeric_limits<real_type>::max();
+      } else if constexpr (std::ranges::range<T>) {
+        bool finite = true;
+        if constexpr (std::ranges::contiguous_range<T> &&
+                      std::same_as<std::ranges::range_value_t<T>, real_type>) {
+          // Without early exit, so the loop vectorizes.
+          for (auto& v : value) {
+            v *= inverse;
+            finite &= std::abs(v) <= std::numeric_limits<real_type>::max();
+          }
+        } else {
+          for (auto& element : value) {
+            finite &= unscale(element, inverse);
+          }
+        }
+        return finite;
+      } else {
+        return std::apply([&](auto&... element) {
+          return (true & ... & unscale(element, inverse));
+        }, value);
+      }
+    }
+
+    // Private Members
+    real_type scale_;
+    size_type finite_steps_{};
+  };
+}
@@ -0,0 +1,99 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <execution>
+#include <limits>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "ami/concepts/execution_policy.hpp"
+#include "ami/utility/parallel_region.hpp"
+
+namespace ami::detail {
+
+  // Smallest power of four, in multiply-adds, at which a parallel transform
+  // beats a vectorized one on this machine.
+  inline std::size_t calibrate_parallel_threshold() {
+    using clock = std::chrono::steady_clock;
+    constexpr std::size_t limit = std::size_t{1} << 20;
+
+    if (std::thread::hardware_concurrency() < 2) {
+      return std::numeric_limits<std::size_t>::max();
+    }
+
+    std::vector<float> x(limit, 1.0f);
+    std::vector<float> y(limit);
+    const auto time = [&](auto policy, std::size_t n) {
+      auto best = clock::duration::max();
+      for (int repeat = 0; repeat < 3; ++repeat) {
+        const auto start = clock::now();
+        std::transform(policy, x.begin(), x.begin() + n, y.begin(),
+            [](float v) { return v * 0.5f + 1.0f; });
+        best = std::min(best, clock::now() - start);
+      }
+      return best;
+    };
+
+    for (std::size_t n = 1024; n <= limit; n *= 4) {
+      if (time(std::execution::par, n) < time(std::execution::unseq, n)) {
+        return n;
+      }
+    }
+    return std::numeric_limits<std::size_t>::max();
+  }
+
+  // Zero until calibrated or set.
+  inline std::atomic<std::size_t> parallel_threshold{};
+
+  inline std::once_flag parallel_threshold_once{};
+}
+
+namespace ami::execution {
+
+  // Below this much work a vector loop is not worth setting up.
+  inline constexpr std::size_t vector_threshold = 16;
+
+  // Work from which adaptive runs in parallel. Measured once per process,
+  // on first use, unless set_parallel_threshold was called before.
+  inline std::size_t parallel_threshold() {
+    std::call_once(detail::parallel_threshold_once, [] {
+      if (detail::parallel_threshold.load() == 0) {
+        std::size_t expected{};
+        detail::parallel_threshold.compare_exchange_strong(
+            expected, detail::calibrate_parallel_threshold());
+      }
+    });
+    return detail::parallel_threshold.load(std::memory_order_relaxed);
+  }
+
+  inline void set_parallel_threshold(std::size_t work) noexcept {
+    detail::parallel_threshold.store(std::max(work, std::size_t{1}));
+  }
+}
+
+namespace ami::utility {
+
+  // Calls f.template operator()<Q>() with the policy to run work under:
+  // P itself, or for adaptive one of seq, unseq and par picked by work, a
+  // count of elementwise operations. Inside a parallel region adaptive
+  // never picks par.
+  template <execution_policy auto P, class F>
+  inline constexpr decltype(auto) resolve(std::size_t work, F&& f) {
+    if constexpr (adaptive_policy<P>) {
+      if (work < execution::vector_threshold) {
+        return std::forward<F>(f).template operator()<std::execution::seq>();
+      }
+      if (in_parallel_region() || work < execution::parallel_threshold()) {
+        return std::forward<F>(f).template operator()<std::execution::unseq>();
+      }
+      return std::forward<F>(f).template operator()<std::execution::par>();
+    } else {
+      return std::forward<F>(f).template operator()<P>();
+    }
+  }
+}
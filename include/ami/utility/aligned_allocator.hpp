@@ -0,0 +1,55 @@
+#pragma once
+
+#include <cstddef>
+#include <limits>
+#include <new>
+
+namespace ami::utility {
+
+  // Allocator handing out Alignment aligned storage, by default a cache
+  // line, so containers of parameters can be passed to the SIMD kernels and
+  // do not share lines with other data. Not final: containers derive from
+  // their allocator.
+  template <class T, std::size_t Alignment = 64>
+  requires (Alignment >= alignof(T) && (Alignment & (Alignment - 1)) == 0)
+  class aligned_allocator {
+  public:
+    // Public Types
+    using value_type = T;
+    using size_type  = std::size_t;
+
+    template <class U>
+    struct rebind final {
+      using other = aligned_allocator<U, Alignment>;
+    };
+
+    // Public Static Members
+    static constexpr size_type alignment = Alignment;
+
+    // Constructor
+    aligned_allocator() = default;
+
+    template <class U>
+    constexpr aligned_allocator(
+        const aligned_allocator<U, Alignment>&) noexcept {}
+
+    // Public Methods
+    [[nodiscard]] T* allocate(size_type n) {
+      if (n > std::numeric_limits<size_type>::max() / sizeof(T)) {
+        throw std::bad_array_new_length{};
+      }
+      return static_cast<T*>(
+          ::operator new(n * sizeof(T), std::align_val_t{alignment}));
+    }
+
+    void deallocate(T* p, size_type) noexcept {
+      ::operator delete(p, std::align_val_t{alignment});
+    }
+
+    template <class U>
+    constexpr bool operator==(
+        const aligned_allocator<U, Alignment>&) const noexcept {
+      return true;
+    }
+  };
+}
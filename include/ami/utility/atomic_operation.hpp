@@ -7,6 +7,9 @@
 
 namespace ami::utility {
 
+  // Atomic under adaptive too: the caller may be running in parallel even
+  // when its own share of the work is small.
+
   template <execution_policy auto Policy, typename T>
   requires std::atomic_ref<T>::is_always_lock_free
   inline constexpr T fetch_add(
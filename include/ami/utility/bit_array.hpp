@@ -0,0 +1,60 @@
+#pragma once
+
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+
+namespace ami::utility {
+
+  // N bits packed into 64-bit words, bit i in word i / 64. Bits past N in
+  // the last word stay zero.
+  template <std::size_t N>
+  class bit_array final {
+  public:
+    // Public Types
+    using size_type = std::size_t;
+    using word_type = std::uint64_t;
+
+    // Public Static Members
+    static constexpr size_type word_bits = 64;
+    static constexpr size_type word_count = (N + word_bits - 1) / word_bits;
+
+    // Public Methods
+    constexpr bool operator[](size_type i) const noexcept {
+      return (words_[i / word_bits] >> (i % word_bits)) & 1;
+    }
+
+    constexpr void set(size_type i, bool value) noexcept {
+      const auto bit = word_type{1} << (i % word_bits);
+      auto& word = words_[i / word_bits];
+      word = value ? (word | bit) : (word & ~bit);
+    }
+
+    constexpr size_type count() const noexcept {
+      size_type result{};
+      for (const auto word : words_) {
+        result += static_cast<size_type>(std::popcount(word));
+      }
+      return result;
+    }
+
+    friend constexpr bool operator==(
+        const bit_array&, const bit_array&) noexcept = default;
+
+    // Getter
+    static constexpr size_type size() noexcept { return N; }
+
+    constexpr std::array<word_type, word_count>& words() noexcept {
+      return words_;
+    }
+
+    constexpr const std::array<word_type, word_count>& words() const noexcept {
+      return words_;
+    }
+
+  private:
+    // Private Members
+    std::array<word_type, word_count> words_{};
+  };
+}
@@ -0,0 +1,143 @@
+#pragma once
+
+#include <bit>
+#include <concepts>
+#include <cstdint>
+#include <type_traits>
+
+#if defined(__F16C__)
+#include <immintrin.h>
+#endif
+
+namespace ami {
+
+  // 16 bit storage formats. Neither has arithmetic of its own: values widen
+  // implicitly to float, and are narrowed explicitly, rounding to nearest
+  // even, so every sum is accumulated in float. Default construction leaves
+  // the bits uninitialised as for float, keeping both types trivial.
+
+  // The upper half of a float: float's range with 8 significant bits.
+  class bfloat16 final {
+  public:
+    // Constructor
+    bfloat16() = default;
+
+    template <std::floating_point T>
+    explicit constexpr bfloat16(T value) noexcept
+        : bits_{narrow(static_cast<float>(value))} {}
+
+    // Public Static Methods
+    static constexpr bfloat16 from_bits(std::uint16_t bits) noexcept {
+      bfloat16 result{};
+      result.bits_ = bits;
+      return result;
+    }
+
+    // Conversion
+    constexpr operator float() const noexcept {
+      return std::bit_cast<float>(std::uint32_t{bits_} << 16);
+    }
+
+    // Getter
+    constexpr std::uint16_t bits() const noexcept { return bits_; }
+
+  private:
+    // Private Static Methods
+    static constexpr std::uint16_t narrow(float value) noexcept {
+      const auto bits = std::bit_cast<std::uint32_t>(value);
+      if ((bits & 0x7fffffff) > 0x7f800000) {
+        // Keep NaNs NaN however the dropped bits would round.
+        return static_cast<std::uint16_t>((bits >> 16) | 0x40);
+      }
+      return static_cast<std::uint16_t>(
+          (bits + 0x7fff + ((bits >> 16) & 1)) >> 16);
+    }
+
+    // Private Members
+    std::uint16_t bits_;
+  };
+
+  // IEEE 754 binary16: 11 significant bits, largest finite value 65504.
+  class float16 final {
+  public:
+    // Constructor
+    float16() = default;
+
+    template <std::floating_point T>
+    explicit constexpr float16(T value) noexcept
+        : bits_{narrow(static_cast<float>(value))} {}
+
+    // Public Static Methods
+    static constexpr float16 from_bits(std::uint16_t bits) noexcept {
+      float16 result{};
+      result.bits_ = bits;
+      return result;
+    }
+
+    // Conversion
+    constexpr operator float() const noexcept {
+#if defined(__F16C__)
+      if (!std::is_constant_evaluated()) {
+        return _cvtsh_ss(bits_);
+      }
+#endif
+      const auto sign = std::uint32_t{bits_ & 0x8000u} << 16;
+      const auto exponent = (bits_ >> 10) & 0x1f;
+      const auto mantissa = std::uint32_t{bits_ & 0x3ffu};
+      if (exponent == 0x1f) {
+        return std::bit_cast<float>(sign | 0x7f800000 | mantissa << 13);
+      }
+      if (exponent == 0) {
+        const auto magnitude = static_cast<float>(mantissa) * 0x1p-24f;
+        return sign ? -magnitude : magnitude;
+      }
+      return std::bit_cast<float>(
+          sign | std::uint32_t(exponent + 112) << 23 | mantissa << 13);
+    }
+
+    // Getter
+    constexpr std::uint16_t bits() const noexcept { return bits_; }
+
+  private:
+    // Private Static Methods
+    static constexpr std::uint16_t narrow(float value) noexcept {
+#if defined(__F16C__)
+      if (!std::is_constant_evaluated()) {
+        return static_cast<std::uint16_t>(
+            _cvtss_sh(value, _MM_FROUND_TO_NEAREST_INT));
+      }
+#endif
+      const auto bits = std::bit_cast<std::uint32_t>(value);
+      const auto sign = (bits >> 16) & 0x8000;
+      const auto magnitude = bits & 0x7fffffff;
+      std::uint32_t result;
+      if (magnitude >= 0x7f800000) {
+        result = magnitude > 0x7f800000 ? 0x7e00 : 0x7c00;
+      } else if (magnitude >= 0x477ff000) {
+        // 65520 and above round to infinity.
+        result = 0x7c00;
+      } else if (magnitude >= 0x38800000) {
+        // Rebias the exponent from 127 to 15 and round off 13 bits.
+        result = (magnitude - 0x38000000 + 0xfff +
+            ((magnitude >> 13) & 1)) >> 13;
+      } else {
+        // Subnormal: adding 0.5 leaves the value rounded to a multiple of
+        // 2^-24 in the low mantissa bits.
+        result = std::bit_cast<std::uint32_t>(
+            std::bit_cast<float>(magnitude) + 0.5f) - 0x3f000000;
+      }
+      return static_cast<std::uint16_t>(sign | result);
+    }
+
+    // Private Members
+    std::uint16_t bits_;
+  };
+
+  template <class T>
+  concept half_precision =
+      std::same_as<T, bfloat16> || std::same_as<T, float16>;
+
+  // Element types parameters and activations may be stored in.
+  template <class T>
+  concept real_storage = std::floating_point<T> || half_precision<T>;
+}
@@ -0,0 +1,147 @@
+#pragma once
+
+#include <cerrno>
+#include <cstddef>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <new>
+#include <span>
+#include <string>
+#include <system_error>
+#include <utility>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define AMI_HAS_MMAP 1
+#endif
+
+namespace ami::utility {
+
+  // Read-only view of a whole file. Where mmap is available the file is
+  // mapped, so opening costs no reads, pages are loaded on first touch and
+  // are shared by every process mapping the same file; elsewhere it is read
+  // into a buffer. The data is at least page (or 64 byte) aligned.
+  // Failures throw std::system_error.
+  class mapped_file final {
+  public:
+    // Public Types
+    using size_type = std::size_t;
+
+    // Constructor
+    mapped_file() = default;
+
+    explicit mapped_file(const std::filesystem::path& path) {
+#ifdef AMI_HAS_MMAP
+      const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+      if (fd < 0) {
+        fail(path, "open");
+      }
+      struct ::stat status{};
+      if (::fstat(fd, &status) != 0) {
+        const auto error = errno;
+        ::close(fd);
+        errno = error;
+        fail(path, "stat");
+      }
+      size_ = static_cast<size_type>(status.st_size);
+      if (size_ != 0) {
+        void* data = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (data == MAP_FAILED) {
+          const auto error = errno;
+          ::close(fd);
+          errno = error;
+          fail(path, "mmap");
+        }
+        data_ = static_cast<const std::byte*>(data);
+      }
+      ::close(fd);
+#else
+      std::ifstream file{path, std::ios::binary | std::ios::ate};
+      if (!file) {
+        throw std::system_error{std::make_error_code(
+            std::errc::no_such_file_or_directory), "open " + path.string()};
+      }
+      size_ = static_cast<size_type>(file.tellg());
+      buffer_.reset(static_cast<std::byte*>(
+          ::operator new(size_, std::align_val_t{alignment})));
+      file.seekg(0);
+      if (!file.read(reinterpret_cast<char*>(buffer_.get()),
+                     static_cast<std::streamsize>(size_))) {
+        throw std::system_error{
+            std::make_error_code(std::errc::io_error), "read " + path.string()};
+      }
+      data_ = buffer_.get();
+#endif
+    }
+
+    mapped_file(mapped_file&& other) noexcept
+        : data_{std::exchange(other.data_, nullptr)},
+          size_{std::exchange(other.size_, 0)}
+#ifndef AMI_HAS_MMAP
+        , buffer_{std::move(other.buffer_)}
+#endif
+    {}
+
+    mapped_file& operator=(mapped_file&& other) noexcept {
+      if (this != &other) {
+        release();
+        data_ = std::exchange(other.data_, nullptr);
+        size_ = std::exchange(other.size_, 0);
+#ifndef AMI_HAS_MMAP
+        buffer_ = std::move(other.buffer_);
+#endif
+      }
+      return *this;
+    }
+
+    // Destructor
+    ~mapped_file() { release(); }
+
+    // Getter
+    const std::byte* data() const noexcept { return data_; }
+
+    size_type size() const noexcept { return size_; }
+
+    std::span<const std::byte> bytes() const noexcept { return {data_, size_}; }
+
+  private:
+    // Private Static Members
+    static constexpr size_type alignment = 64;
+
+    // Private Types
+    struct aligned_delete final {
+      void operator()(std::byte* p) const noexcept {
+        ::operator delete(p, std::align_val_t{alignment});
+      }
+    };
+
+    // Private Static Methods
+    [[noreturn]] static void fail(
+        const std::filesystem::path& path, const char* what) {
+      throw std::system_error{
+          errno, std::generic_category(), what + (" " + path.string())};
+    }
+
+    // Private Methods
+    void release() noexcept {
+#ifdef AMI_HAS_MMAP
+      if (data_ != nullptr) {
+        ::munmap(const_cast<std::byte*>(data_), size_);
+      }
+#endif
+      data_ = nullptr;
+      size_ = 0;
+    }
+
+    // Private Members
+    const std::byte* data_{};
+    size_type        size_{};
+#ifndef AMI_HAS_MMAP
+    std::unique_ptr<std::byte, aligned_delete> buffer_{};
+#endif
+  };
+}
@@ -2,19 +2,99 @@
 
 #include <algorithm>
 #include <concepts>
+#include <cstddef>
+#include <execution>
+#include <iterator>
 #include <numeric>
 #include <ranges>
+#include <thread>
+#include <type_traits>
+#include <vector>
 
 #include "ami/concepts/execution_policy.hpp"
+#include "ami/utility/adaptive_policy.hpp"
+#include "ami/utility/parallel_region.hpp"
+#include "ami/utility/thread_pool.hpp"
+
+namespace ami::detail {
+
+  // Policy for the elements inside one chunk of a parallel loop.
+  template <execution_policy auto P>
+  inline constexpr std::conditional_t<
+      std::same_as<std::remove_cvref_t<decltype(P)>,
+          std::execution::parallel_unsequenced_policy>,
+      std::execution::unsequenced_policy,
+      std::execution::sequenced_policy> chunk_policy{};
+
+  // Chunk length for n elements under a parallel policy: the pool's grain,
+  // or about eight chunks per hardware thread.
+  template <execution_policy auto P>
+  inline std::size_t parallel_grain(std::size_t n) {
+    if constexpr (pool_policy<P>) {
+      return P.grain != 0 ? P.grain : policy_pool<P>().default_grain(n);
+    } else {
+      static const std::size_t threads =
+          std::max(std::thread::hardware_concurrency(), 1u);
+      return std::max(n / (8 * threads), std::size_t{1});
+    }
+  }
+
+  // Calls body(begin, end) over chunks of grain elements covering [0, n),
+  // in parallel, each inside a parallel_scope.
+  template <execution_policy auto P, class Body>
+  inline void parallel_for(std::size_t n, std::size_t grain, Body body) {
+    const auto scoped = [&](std::size_t begin, std::size_t end) {
+      const parallel_scope scope{};
+      body(begin, end);
+    };
+
+    if constexpr (pool_policy<P>) {
+      policy_pool<P>().parallel_for(n, grain, scoped);
+    } else {
+      const auto chunks = (n + grain - 1) / grain;
+      std::for_each(P, std::views::iota(std::size_t{}, chunks).begin(),
+          std::views::iota(std::size_t{}, chunks).end(), [&](auto c) {
+            const auto begin = c * grain;
+            scoped(begin, std::min(n, begin + grain));
+          });
+    }
+  }
+}
 
 namespace ami::utility {
 
+  // Under adaptive the element count is taken as the amount of work. The
+  // parallel policies split random access ranges into chunks run as one
+  // task each; nested in another parallel body they run as unseq. A pool
+  // policy runs other ranges sequentially.
   template <execution_policy auto Policy,
             std::ranges::forward_range R,
             std::indirectly_unary_invocable<std::ranges::iterator_t<R>> F>
   inline constexpr void for_each(R&& r, F f) {
-    if constexpr (sequenced_policy<Policy>) {
+    if constexpr (adaptive_policy<Policy>) {
+      resolve<Policy>(static_cast<std::size_t>(std::ranges::distance(r)),
+          [&]<execution_policy auto Q> {
+            for_each<Q>(std::forward<R>(r), std::move(f));
+          });
+    } else if constexpr (sequenced_policy<Policy>) {
       std::ranges::for_each(std::forward<R>(r), std::move(f));
+    } else if constexpr (unsequenced_policy<Policy>) {
+      std::for_each(
+          Policy, std::ranges::begin(r), std::ranges::end(r), std::move(f));
+    } else if constexpr (std::ranges::random_access_range<R>) {
+      if (in_parallel_region()) {
+        return for_each<std::execution::unseq>(
+            std::forward<R>(r), std::move(f));
+      }
+      const auto first = std::ranges::begin(r);
+      const auto n = static_cast<std::size_t>(std::ranges::distance(r));
+      detail::parallel_for<Policy>(n, detail::parallel_grain<Policy>(n),
+          [&](std::size_t begin, std::size_t end) {
+            std::for_each(detail::chunk_policy<Policy>,
+                first + begin, first + end, f);
+          });
+    } else if constexpr (pool_policy<Policy>) {
+      for_each<std::execution::seq>(std::forward<R>(r), std::move(f));
     } else {
       std::for_each(
           Policy, std::ranges::begin(r), std::ranges::end(r), std::move(f));
@@ -26,12 +106,39 @@ namespace ami::utility {
   requires std::indirectly_writable<O,
       std::indirect_result_t<F, std::ranges::iterator_t<R>>>
   inline constexpr O transform(R&& r, O result, F f) {
-    if constexpr (sequenced_policy<Policy>) {
+    if constexpr (adaptive_policy<Policy>) {
+      return resolve<Policy>(
+          static_cast<std::size_t>(std::ranges::distance(r)),
+          [&]<execution_policy auto Q> {
+            return transform<Q>(
+                std::forward<R>(r), std::move(result), std::move(f));
+          });
+    } else if constexpr (sequenced_policy<Policy>) {
       return std::transform(
           std::ranges::begin(r), std::ranges::end(r), std::move(result),
           std::move(f));
-    }
-    else {
+    } else if constexpr (unsequenced_policy<Policy>) {
+      return std::transform(
+          Policy, std::ranges::begin(r), std::ranges::end(r), std::move(result),
+          std::move(f));
+    } else if constexpr (std::ranges::random_access_range<R> &&
+                         std::random_access_iterator<O>) {
+      if (in_parallel_region()) {
+        return transform<std::execution::unseq>(
+            std::forward<R>(r), std::move(result), std::move(f));
+      }
+      const auto first = std::ranges::begin(r);
+      const auto n = static_cast<std::size_t>(std::ranges::distance(r));
+      detail::parallel_for<Policy>(n, detail::parallel_grain<Policy>(n),
+          [&](std::size_t begin, std::size_t end) {
+            std::transform(detail::chunk_policy<Policy>,
+                first + begin, first + end, result + begin, f);
+          });
+      return result + n;
+    } else if constexpr (pool_policy<Policy>) {
+      return transform<std::execution::seq>(
+          std::forward<R>(r), std::move(result), std::move(f));
+    } else {
       return std::transform(
           Policy, std::ranges::begin(r), std::ranges::end(r), std::move(result),
           std::move(f));
@@ -45,31 +152,130 @@ namespace ami::utility {
       std::indirect_result_t<F, std::ranges::iterator_t<R1>,
           std::ranges::iterator_t<R2>>>
   inline constexpr O transform(R1&& r1, R2&& r2, O result, F f) {
-    if constexpr (sequenced_policy<Policy>) {
+    if constexpr (adaptive_policy<Policy>) {
+      return resolve<Policy>(
+          static_cast<std::size_t>(std::ranges::distance(r1)),
+          [&]<execution_policy auto Q> {
+            return transform<Q>(std::forward<R1>(r1), std::forward<R2>(r2),
+                std::move(result), std::move(f));
+          });
+    } else if constexpr (sequenced_policy<Policy>) {
       return std::transform(
           std::ranges::begin(r1), std::ranges::end(r1),
           std::ranges::begin(r2), std::move(result), std::move(f));
-    }
-    else {
+    } else if constexpr (unsequenced_policy<Policy>) {
+      return std::transform(
+          Policy, std::ranges::begin(r1), std::ranges::end(r1),
+          std::ranges::begin(r2), std::move(result), std::move(f));
+    } else if constexpr (std::ranges::random_access_range<R1> &&
+                         std::ranges::random_access_range<R2> &&
+                         std::random_access_iterator<O>) {
+      if (in_parallel_region()) {
+        return transform<std::execution::unseq>(std::forward<R1>(r1),
+            std::forward<R2>(r2), std::move(result), std::move(f));
+      }
+      const auto first1 = std::ranges::begin(r1);
+      const auto first2 = std::ranges::begin(r2);
+      const auto n = static_cast<std::size_t>(std::ranges::distance(r1));
+      detail::parallel_for<Policy>(n, detail::parallel_grain<Policy>(n),
+          [&](std::size_t begin, std::size_t end) {
+            std::transform(detail::chunk_policy<Policy>,
+                first1 + begin, first1 + end, first2 + begin,
+                result + begin, f);
+          });
+      return result + n;
+    } else if constexpr (pool_policy<Policy>) {
+      return transform<std::execution::seq>(std::forward<R1>(r1),
+          std::forward<R2>(r2), std::move(result), std::move(f));
+    } else {
       return std::transform(
           Policy, std::ranges::begin(r1), std::ranges::end(r1),
           std::ranges::begin(r2), std::move(result), std::move(f));
     }
   }
 
+  // Under the parallel policies the chunks are summed in order, so the
+  // result does not depend on the scheduling.
   template <execution_policy auto Policy,
             std::ranges::forward_range R1, std::ranges::forward_range R2,
             std::common_with<std::ranges::range_value_t<R1>> T>
   requires std::common_with<T, std::ranges::range_value_t<R2>>
   inline constexpr T transform_reduce(R1&& r1, R2&& r2, T init) {
-    if constexpr (sequenced_policy<Policy>) {
+    if constexpr (adaptive_policy<Policy>) {
+      return resolve<Policy>(
+          static_cast<std::size_t>(std::ranges::distance(r1)),
+          [&]<execution_policy auto Q> {
+            return transform_reduce<Q>(
+                std::forward<R1>(r1), std::forward<R2>(r2), std::move(init));
+          });
+    } else if constexpr (sequenced_policy<Policy>) {
       return std::transform_reduce(
           std::ranges::begin(r1), std::ranges::end(r1), std::ranges::begin(r2),
           std::move(init));
+    } else if constexpr (unsequenced_policy<Policy>) {
+      return std::transform_reduce(
+          Policy, std::ranges::begin(r1), std::ranges::end(r1),
+          std::ranges::begin(r2), std::move(init));
+    } else if constexpr (std::ranges::random_access_range<R1> &&
+                         std::ranges::random_access_range<R2>) {
+      if (in_parallel_region()) {
+        return transform_reduce<std::execution::unseq>(
+            std::forward<R1>(r1), std::forward<R2>(r2), std::move(init));
+      }
+      const auto first1 = std::ranges::begin(r1);
+      const auto first2 = std::ranges::begin(r2);
+      const auto n = static_cast<std::size_t>(std::ranges::distance(r1));
+      const auto grain = detail::parallel_grain<Policy>(n);
+      std::vector<T> partial((n + grain - 1) / grain, T{});
+      detail::parallel_for<Policy>(partial.size(), 1,
+          [&](std::size_t begin, std::size_t end) {
+            for (auto c = begin; c < end; ++c) {
+              const auto offset = c * grain;
+              partial[c] = std::transform_reduce(
+                  detail::chunk_policy<Policy>, first1 + offset,
+                  first1 + std::min(n, offset + grain), first2 + offset,
+                  T{});
+            }
+          });
+      return std::accumulate(partial.begin(), partial.end(), std::move(init));
+    } else if constexpr (pool_policy<Policy>) {
+      return transform_reduce<std::execution::seq>(
+          std::forward<R1>(r1), std::forward<R2>(r2), std::move(init));
     } else {
       return std::transform_reduce(
           Policy, std::ranges::begin(r1), std::ranges::end(r1),
           std::ranges::begin(r2), std::move(init));
     }
   }
+
+  // Extent of a cache sized block of a two dimensional iteration space.
+  struct tile final {
+    std::size_t rows;
+    std::size_t cols;
+  };
+
+  // Calls f(row_begin, row_end, col_begin, col_end) for every block of a
+  // rows x cols space cut into shape sized tiles, the tiles in parallel
+  // under Policy. Under adaptive the work is rows * cols.
+  template <execution_policy auto Policy, class F>
+  requires std::invocable<F&, std::size_t, std::size_t, std::size_t,
+                          std::size_t>
+  inline constexpr void for_each_tile(
+      std::size_t rows, std::size_t cols, tile shape, F f) {
+    if constexpr (adaptive_policy<Policy>) {
+      resolve<Policy>(rows * cols, [&]<execution_policy auto Q> {
+            for_each_tile<Q>(rows, cols, shape, std::move(f));
+          });
+    } else {
+      const auto row_tiles = (rows + shape.rows - 1) / shape.rows;
+      const auto col_tiles = (cols + shape.cols - 1) / shape.cols;
+      for_each<Policy>(std::views::iota(std::size_t{}, row_tiles * col_tiles),
+          [&](auto t) {
+            const auto i = t / col_tiles * shape.rows;
+            const auto j = t % col_tiles * shape.cols;
+            f(i, std::min(rows, i + shape.rows),
+              j, std::min(cols, j + shape.cols));
+          });
+    }
+  }
 }
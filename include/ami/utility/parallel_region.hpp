@@ -0,0 +1,30 @@
+#pragma once
+
+#include <cstddef>
+
+namespace ami::detail {
+
+  // Depth of parallel wrapper bodies running on this thread.
+  inline thread_local std::size_t parallel_depth = 0;
+
+  class parallel_scope final {
+  public:
+    parallel_scope() noexcept { ++parallel_depth; }
+
+    parallel_scope(const parallel_scope&) = delete;
+
+    parallel_scope& operator=(const parallel_scope&) = delete;
+
+    ~parallel_scope() { --parallel_depth; }
+  };
+}
+
+namespace ami::utility {
+
+  // True inside the body of a parallel for_each, transform or
+  // transform_reduce. Parallel policies met there run as vectorized
+  // sequential code: the outermost level already keeps every thread busy.
+  inline bool in_parallel_region() noexcept {
+    return detail::parallel_depth != 0;
+  }
+}
@@ -0,0 +1,93 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+
+namespace ami::utility {
+
+  // Philox4x32-10 (Salmon et al., "Parallel Random Numbers: As Easy as 1,
+  // 2, 3"). Block n of a stream is a pure function of the seed, the stream
+  // and n, so blocks may be generated in any order, in parallel, with the
+  // same result. operator() reads the blocks in order, four words each.
+  class philox final {
+  public:
+    // Public Types
+    using result_type = std::uint32_t;
+    using block_type = std::array<std::uint32_t, 4>;
+
+    // Constructor
+    explicit constexpr philox(
+        std::uint64_t seed = 0, std::uint64_t stream = 0) noexcept
+      : key_{static_cast<std::uint32_t>(seed),
+             static_cast<std::uint32_t>(seed >> 32)},
+        stream_{stream} {}
+
+    // Public Static Methods
+    static constexpr result_type min() noexcept { return 0; }
+
+    static constexpr result_type max() noexcept {
+      return std::numeric_limits<result_type>::max();
+    }
+
+    // Public Methods
+    constexpr result_type operator()() noexcept {
+      if (index_ == buffer_.size()) {
+        buffer_ = block(counter_++);
+        index_ = 0;
+      }
+      return buffer_[index_++];
+    }
+
+    constexpr void discard(unsigned long long n) noexcept {
+      for (; n != 0 && index_ != buffer_.size(); --n) {
+        ++index_;
+      }
+      counter_ += n / buffer_.size();
+      if (n % buffer_.size() != 0) {
+        buffer_ = block(counter_++);
+        index_ = n % buffer_.size();
+      }
+    }
+
+    constexpr block_type block(std::uint64_t n) const noexcept {
+      block_type counter{static_cast<std::uint32_t>(n),
+                         static_cast<std::uint32_t>(n >> 32),
+                         static_cast<std::uint32_t>(stream_),
+                         static_cast<std::uint32_t>(stream_ >> 32)};
+      auto key = key_;
+      for (int r = 0; r < 10; ++r) {
+        if (r != 0) {
+          key[0] += 0x9e3779b9;
+          key[1] += 0xbb67ae85;
+        }
+        const auto p0 = std::uint64_t{0xd2511f53} * counter[0];
+        const auto p1 = std::uint64_t{0xcd9e8d57} * counter[2];
+        counter = {static_cast<std::uint32_t>(p1 >> 32) ^ counter[1] ^ key[0],
+                   static_cast<std::uint32_t>(p1),
+                   static_cast<std::uint32_t>(p0 >> 32) ^ counter[3] ^ key[1],
+                   static_cast<std::uint32_t>(p0)};
+      }
+      return counter;
+    }
+
+    // Claims the next n blocks for the caller to generate with block(), and
+    // returns the first. operator() continues after them; words left in
+    // the current block are skipped.
+    constexpr std::uint64_t reserve(std::uint64_t n) noexcept {
+      index_ = buffer_.size();
+      const auto first = counter_;
+      counter_ += n;
+      return first;
+    }
+
+  private:
+    // Private Members
+    std::array<std::uint32_t, 2> key_;
+    std::uint64_t                stream_;
+    std::uint64_t                counter_{};
+    block_type                   buffer_{};
+    std::size_t                  index_{buffer_.size()};
+  };
+}
@@ -0,0 +1,107 @@
+#pragma once
+
+#include <algorithm>
+#include <concepts>
+#include <cstdint>
+#include <limits>
+#include <span>
+
+namespace ami {
+
+  // Integer types values are quantized to: uint8 activations and int8
+  // weights, as the u8 x s8 dot product instructions take them.
+  template <class T>
+  concept quantized_integer =
+      std::same_as<T, std::uint8_t> || std::same_as<T, std::int8_t>;
+
+  // Affine map between reals and integers, x = scale * (q - zero_point).
+  template <std::floating_point RealType>
+  struct quantization final {
+    // Public Types
+    using real_type = RealType;
+
+    // Public Static Methods
+
+    // The map taking [min, max] onto the whole range of Q. The range is
+    // widened to contain 0, so that 0 (padding, a ReLU output) is exact.
+    template <quantized_integer Q>
+    static constexpr quantization from_range(
+        real_type min, real_type max) noexcept {
+      constexpr auto lowest = real_type{std::numeric_limits<Q>::min()};
+      constexpr auto highest = real_type{std::numeric_limits<Q>::max()};
+      min = std::min(min, real_type{});
+      max = std::max(max, real_type{});
+      if (max == min) {
+        return {real_type{1}, 0};
+      }
+      const auto scale = (max - min) / (highest - lowest);
+      return {scale, static_cast<std::int32_t>(
+          round(std::clamp(lowest - min / scale, lowest, highest)))};
+    }
+
+    // Public Methods
+
+    // Rounds x / scale + zero_point to nearest, saturating to the range of
+    // Q. NaN maps to the lowest value.
+    template <quantized_integer Q>
+    constexpr Q quantize(real_type x) const noexcept {
+      constexpr auto lowest = real_type{std::numeric_limits<Q>::min()};
+      constexpr auto highest = real_type{std::numeric_limits<Q>::max()};
+      const auto q = x / scale + static_cast<real_type>(zero_point);
+      return static_cast<Q>(round(std::max(lowest, std::min(q, highest))));
+    }
+
+    constexpr real_type dequantize(std::int32_t q) const noexcept {
+      return scale * static_cast<real_type>(q - zero_point);
+    }
+
+    // Public Members
+    real_type scale{1};
+    std::int32_t zero_point{};
+
+  private:
+    // Private Static Methods
+
+    // Half away from zero, for values already in the integer range.
+    static constexpr std::int32_t round(real_type x) noexcept {
+      return static_cast<std::int32_t>(
+          x + (x < real_type{} ? real_type{-0.5} : real_type{0.5}));
+    }
+  };
+
+  // Tracks the range of the values a layer sees over a calibration set,
+  // from which its input quantization is chosen.
+  template <std::floating_point RealType>
+  class range_calibrator final {
+  public:
+    // Public Types
+    using real_type = RealType;
+    using quantization_type = quantization<RealType>;
+
+    // Public Methods
+    constexpr void observe(std::span<const real_type> values) noexcept {
+      for (const auto v : values) {
+        min_ = std::min(min_, v);
+        max_ = std::max(max_, v);
+      }
+    }
+
+    template <quantized_integer Q = std::uint8_t>
+    constexpr quantization_type make_quantization() const noexcept {
+      return empty() ? quantization_type{} :
+          quantization_type::template from_range<Q>(min_, max_);
+    }
+
+    // Getter
+    constexpr bool empty() const noexcept { return min_ > max_; }
+
+    constexpr real_type min() const noexcept { return min_; }
+
+    constexpr real_type max() const noexcept { return max_; }
+
+  private:
+    // Private Members
+    real_type min_{std::numeric_limits<real_type>::max()};
+    real_type max_{std::numeric_limits<real_type>::lowest()};
+  };
+}
@@ -0,0 +1,266 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <mutex>
+#include <optional>
+#include <stop_token>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+#include "ami/concepts/execution_policy.hpp"
+
+namespace ami::utility {
+
+  enum class affinity { none, core };
+
+  // Fork-join pool with one deque per worker. A task splits its range in
+  // halves down to the grain, pushing the upper halves at the back of its
+  // own deque; owners pop from the back and idle workers steal from the
+  // front of the others. A thread waiting in parallel_for runs tasks
+  // meanwhile, so nested calls do not block. Threads from outside the pool
+  // share one extra deque.
+  class thread_pool final {
+  public:
+    // Public Types
+    using size_type = std::size_t;
+
+    // Constructor
+    explicit thread_pool(
+        size_type threads = std::thread::hardware_concurrency(),
+        affinity pinning = affinity::none)
+      : queues_(threads + 1) {
+      workers_.reserve(threads);
+      for (size_type i = 0; i < threads; ++i) {
+        workers_.emplace_back([this, i](std::stop_token stop) {
+              work(i, stop);
+            });
+        if (pinning == affinity::core) {
+          pin(workers_.back(), i);
+        }
+      }
+    }
+
+    thread_pool(const thread_pool&) = delete;
+
+    thread_pool& operator=(const thread_pool&) = delete;
+
+    // Destructor
+    ~thread_pool() {
+      for (auto& worker : workers_) {
+        worker.request_stop();
+      }
+      workers_.clear();
+    }
+
+    // Public Methods
+
+    // Calls f(begin, end) on disjoint ranges, none longer than grain,
+    // covering [0, n), and returns once all have run. A grain of 0 picks
+    // default_grain(n). As with the standard parallel policies, an
+    // exception escaping f terminates.
+    template <class F>
+    requires std::is_invocable_v<F&, size_type, size_type>
+    void parallel_for(size_type n, size_type grain, F&& f) {
+      if (n == 0) {
+        return;
+      }
+      if (grain == 0) {
+        grain = default_grain(n);
+      }
+      if (n <= grain || workers_.empty()) {
+        f(size_type{}, n);
+        return;
+      }
+
+      job<std::remove_reference_t<F>> j{grain, f};
+      const auto self = index();
+      run(self, {&j, 0, n});
+      while (j.pending.load(std::memory_order_acquire) != 0) {
+        if (!try_run(self)) {
+          std::this_thread::yield();
+        }
+      }
+    }
+
+    // About eight chunks per thread, enough to even out uneven tasks.
+    size_type default_grain(size_type n) const noexcept {
+      return std::max(n / (8 * (workers_.size() + 1)), size_type{1});
+    }
+
+    // Getter
+    size_type size() const noexcept { return workers_.size(); }
+
+  private:
+    // Private Types
+    struct job_base {
+      explicit job_base(size_type grain) noexcept : grain{grain} {}
+
+      virtual void operator()(size_type begin, size_type end) = 0;
+
+      std::atomic<size_type> pending{1};
+      size_type              grain;
+
+    protected:
+      ~job_base() = default;
+    };
+
+    template <class F>
+    struct job final : job_base {
+      job(size_type grain, F& f) noexcept : job_base{grain}, f{f} {}
+
+      void operator()(size_type begin, size_type end) override {
+        f(begin, end);
+      }
+
+      F& f;
+    };
+
+    struct task_type final {
+      job_base* job;
+      size_type begin;
+      size_type end;
+    };
+
+    struct alignas(64) queue_type final {
+      std::mutex            mutex{};
+      std::deque<task_type> tasks{};
+    };
+
+    // Private Static Methods
+    static std::pair<const thread_pool*, size_type>& current() noexcept {
+      thread_local std::pair<const thread_pool*, size_type> value{};
+      return value;
+    }
+
+    template <class Thread>
+    static void pin([[maybe_unused]] Thread& thread,
+                    [[maybe_unused]] size_type i) noexcept {
+#if defined(__linux__)
+      const auto cores = std::max(std::thread::hardware_concurrency(), 1u);
+      cpu_set_t set;
+      CPU_ZERO(&set);
+      CPU_SET(i % cores, &set);
+      pthread_setaffinity_np(thread.native_handle(), sizeof(set), &set);
+#endif
+    }
+
+    // Private Methods
+    size_type index() const noexcept {
+      const auto [pool, i] = current();
+      return pool == this ? i : workers_.size();
+    }
+
+    void work(size_type self, std::stop_token stop) {
+      current() = {this, self};
+      while (!stop.stop_requested()) {
+        if (try_run(self)) {
+          continue;
+        }
+        sleepers_.fetch_add(1);
+        {
+          std::unique_lock lock{sleep_mutex_};
+          sleep_.wait(lock, stop, [&] { return queued_.load() != 0; });
+        }
+        sleepers_.fetch_sub(1);
+      }
+    }
+
+    void run(size_type self, task_type task) noexcept {
+      while (task.end - task.begin > task.job->grain) {
+        const auto middle = task.begin + (task.end - task.begin) / 2;
+        task.job->pending.fetch_add(1, std::memory_order_relaxed);
+        push(self, {task.job, middle, task.end});
+        task.end = middle;
+      }
+      (*task.job)(task.begin, task.end);
+      task.job->pending.fetch_sub(1, std::memory_order_release);
+    }
+
+    bool try_run(size_type self) {
+      auto task = pop(self);
+      for (size_type i = 1; !task && i < queues_.size(); ++i) {
+        task = steal((self + i) % queues_.size());
+      }
+      if (!task) {
+        return false;
+      }
+      run(self, *task);
+      return true;
+    }
+
+    void push(size_type i, task_type task) {
+      {
+        std::lock_guard lock{queues_[i].mutex};
+        queues_[i].tasks.push_back(task);
+      }
+      queued_.fetch_add(1);
+      if (sleepers_.load() != 0) {
+        { std::lock_guard lock{sleep_mutex_}; }
+        sleep_.notify_one();
+      }
+    }
+
+    std::optional<task_type> pop(size_type i) {
+      std::lock_guard lock{queues_[i].mutex};
+      auto& tasks = queues_[i].tasks;
+      if (tasks.empty()) {
+        return std::nullopt;
+      }
+      const auto task = tasks.back();
+      tasks.pop_back();
+      queued_.fetch_sub(1);
+      return task;
+    }
+
+    std::optional<task_type> steal(size_type i) {
+      std::lock_guard lock{queues_[i].mutex};
+      auto& tasks = queues_[i].tasks;
+      if (tasks.empty()) {
+        return std::nullopt;
+      }
+      const auto task = tasks.front();
+      tasks.pop_front();
+      queued_.fetch_sub(1);
+      return task;
+    }
+
+    // Private Members
+    std::vector<queue_type>     queues_;
+    std::atomic<size_type>      queued_{};
+    std::atomic<size_type>      sleepers_{};
+    std::mutex                  sleep_mutex_{};
+    std::condition_variable_any sleep_{};
+    std::vector<std::jthread>   workers_{};
+  };
+
+  // Pool used by execution::pool, one thread per core, started on first
+  // use.
+  inline thread_pool& default_thread_pool() {
+    static thread_pool pool{};
+    return pool;
+  }
+}
+
+namespace ami::detail {
+
+  template <execution_policy auto P>
+  requires pool_policy<P>
+  inline utility::thread_pool& policy_pool() {
+    if constexpr (P.pool == nullptr) {
+      return utility::default_thread_pool();
+    } else {
+      return *P.pool;
+    }
+  }
+}
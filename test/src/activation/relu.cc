@@ -0,0 +1,64 @@
+#include "ami/activation/relu.hpp"
+
+#include <array>
+#include <concepts>
+#include <cstddef>
+#include <span>
+#include <tuple>
+
+#include <boost/ut.hpp>
+
+#include "ami/concepts/activation_function.hpp"
+
+int main() {
+  using namespace boost::ut;
+  using namespace ami;
+
+  using func = relu;
+
+  "activation_function"_test = [] {
+    static_assert(activation_function<func>);
+    static_assert(batch_activation_function<func, float>);
+    static_assert(batch_activation_function<func, double>);
+    static_assert(func::f(2.0) == 2.0);
+    static_assert(output_activation_function<func>);
+  };
+
+  "f"_test = []<std::floating_point RealType> {
+    expect(eq(func::f(RealType{3}), RealType{3}));
+    expect(eq(func::f(RealType{-2}), RealType{}));
+    expect(eq(func::f(RealType{}), RealType{}));
+  } | std::tuple<float, double>{};
+
+  "df"_test = []<std::floating_point RealType> {
+    expect(eq(func::df(RealType{3}), RealType{1}));
+    expect(eq(func::df(RealType{-2}), RealType{}));
+  } | std::tuple<float, double>{};
+
+  "df_from_output"_test = []<std::floating_point RealType> {
+    for (const auto x : {RealType{3}, RealType{-2}, RealType{0.5}}) {
+      expect(eq(func::df_from_output(func::f(x)), func::df(x)));
+    }
+  } | std::tuple<float, double>{};
+
+  "batch"_test = []<std::floating_point RealType> {
+    std::array<RealType, 19> x{};
+    std::array<RealType, 19> delta{};
+    for (std::size_t i = 0; i < x.size(); ++i) {
+      x[i] = static_cast<RealType>(i) - 9;
+      delta[i] = static_cast<RealType>(i) / 4;
+    }
+
+    std::array<RealType, 19> y{};
+    func::f_batch(std::span<const RealType>{x}, std::span<RealType>{y});
+    for (std::size_t i = 0; i < x.size(); ++i) {
+      expect(eq(y[i], func::f(x[i])));
+    }
+
+    func::df_batch(std::span<const RealType>{x},
+        std::span<const RealType>{delta}, std::span<RealType>{y});
+    for (std::size_t i = 0; i < x.size(); ++i) {
+      expect(eq(y[i], func::df(x[i]) * delta[i]));
+    }
+  } | std::tuple<float, double>{};
+}
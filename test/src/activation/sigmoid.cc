@@ -0,0 +1,88 @@
+#include "ami/activation/sigmoid.hpp"
+
+#include <array>
+#include <cmath>
+#include <concepts>
+#include <cstddef>
+#include <limits>
+#include <span>
+#include <tuple>
+
+#include <boost/ut.hpp>
+
+#include "ami/concepts/activation_function.hpp"
+
+int main() {
+  using namespace boost::ut;
+  using namespace ami;
+
+  using exact = sigmoid<>;
+  using fast = sigmoid<precision::fast>;
+
+  constexpr std::array<double, 7> points{-6, -2, -0.5, 0, 0.25, 1.5, 6};
+
+  "activation_function"_test = [] {
+    static_assert(activation_function<exact>);
+    static_assert(activation_function<fast>);
+    static_assert(!batch_activation_function<exact, float>);
+    static_assert(batch_activation_function<fast, float>);
+    static_assert(batch_activation_function<fast, double>);
+    static_assert(output_activation_function<exact>);
+    static_assert(output_activation_function<fast>);
+  };
+
+  "f"_test = [&]<std::floating_point RealType> {
+    expect(eq(sigmoid<>::f(RealType{0}), RealType{0.5}));
+
+    should("match exact within a few ulp") = [&] {
+      constexpr auto eps = std::numeric_limits<RealType>::epsilon();
+      for (const auto p : points) {
+        const auto x = static_cast<RealType>(p);
+        expect(le(std::abs(fast::f(x) - exact::f(x)),
+            4 * eps * (std::abs(exact::f(x)) + 1)));
+      }
+    };
+  } | std::tuple<float, double>{};
+
+  "df"_test = [&] {
+    should("match the central difference") = [&] {
+      constexpr double h = 1e-5;
+      for (const auto x : points) {
+        const auto numeric = (exact::f(x + h) - exact::f(x - h)) / (2 * h);
+        expect(le(std::abs(exact::df(x) - numeric), 1e-8));
+        expect(le(std::abs(fast::df(x) - numeric), 1e-8));
+      }
+    };
+
+    should("follow from the output") = [&] {
+      for (const auto x : points) {
+        expect(eq(exact::df_from_output(exact::f(x)), exact::df(x)));
+        expect(eq(fast::df_from_output(fast::f(x)), fast::df(x)));
+      }
+    };
+  };
+
+  "batch"_test = [&]<std::floating_point RealType> {
+    constexpr auto eps = std::numeric_limits<RealType>::epsilon();
+    std::array<RealType, 19> x{};
+    std::array<RealType, 19> delta{};
+    for (std::size_t i = 0; i < x.size(); ++i) {
+      x[i] = static_cast<RealType>(points[i % points.size()]);
+      delta[i] = static_cast<RealType>(i) / 4 - 2;
+    }
+
+    std::array<RealType, 19> y{};
+    fast::f_batch(std::span<const RealType>{x}, std::span<RealType>{y});
+    for (std::size_t i = 0; i < x.size(); ++i) {
+      expect(le(std::abs(y[i] - fast::f(x[i])),
+          8 * eps * (std::abs(y[i]) + 1)));
+    }
+
+    fast::df_batch(std::span<const RealType>{x},
+        std::span<const RealType>{delta}, std::span<RealType>{y});
+    for (std::size_t i = 0; i < x.size(); ++i) {
+      expect(le(std::abs(y[i] - fast::df(x[i]) * delta[i]),
+          16 * eps * (x[i] * x[i] + 1) * (std::abs(delta[i]) + 1)));
+    }
+  } | std::tuple<float, double>{};
+}
@@ -1,6 +1,7 @@
 #include "ami/concepts/activation_function.hpp"
 
 #include <concepts>
+#include <span>
 
 #include <boost/ut.hpp>
 
@@ -16,11 +17,50 @@ struct func final {
   }
 };
 
+struct batch_func final {
+  template <std::floating_point RealType>
+  static constexpr RealType f(RealType value) { return value; }
+
+  template <std::floating_point RealType>
+  static constexpr RealType df(RealType) { return RealType{1}; }
+
+  template <std::floating_point RealType>
+  static constexpr void f_batch(
+      std::span<const RealType>, std::span<RealType>) {}
+
+  template <std::floating_point RealType>
+  static constexpr void df_batch(std::span<const RealType>,
+      std::span<const RealType>, std::span<RealType>) {}
+};
+
+struct output_func final {
+  template <std::floating_point RealType>
+  static constexpr RealType f(RealType value) { return 2 * value; }
+
+  template <std::floating_point RealType>
+  static constexpr RealType df(RealType) { return 2; }
+
+  template <std::floating_point RealType>
+  static constexpr RealType df_from_output(RealType) { return 2; }
+};
+
 int main() {
   using namespace boost::ut;
   using namespace ami;
 
   "activation_function"_test = [] {
     static_assert(activation_function<func>);
+    static_assert(activation_function<batch_func>);
+  };
+
+  "output_activation_function"_test = [] {
+    static_assert(!output_activation_function<func>);
+    static_assert(output_activation_function<output_func>);
+  };
+
+  "batch_activation_function"_test = [] {
+    static_assert(!batch_activation_function<func, float>);
+    static_assert(batch_activation_function<batch_func, float>);
+    static_assert(batch_activation_function<batch_func, double>);
   };
 }
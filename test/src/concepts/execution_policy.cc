@@ -10,12 +10,37 @@ int main() {
   using namespace boost::ut;
   using namespace std::execution;
 
+  constexpr std::tuple policies{
+      seq, par, par_unseq, unseq, ami::execution::adaptive,
+      ami::execution::pool};
+
   "execution_policy"_test = []<class Policy> {
     static_assert(ami::execution_policy<Policy>);
-  } | std::tuple{seq, par, par_unseq, unseq};
+  } | policies;
+
+  "not execution_policy"_test = [] {
+    static_assert(!ami::execution_policy<int>);
+  };
 
   "sequenced_policy"_test = []<class Policy> {
     static_assert(ami::sequenced_policy<Policy{}> ==
         std::same_as<std::remove_cvref_t<Policy>, sequenced_policy>);
-  } | std::tuple{seq, par, par_unseq, unseq};
+  } | policies;
+
+  "unsequenced_policy"_test = []<class Policy> {
+    static_assert(ami::unsequenced_policy<Policy{}> ==
+        std::same_as<std::remove_cvref_t<Policy>, unsequenced_policy>);
+  } | policies;
+
+  "adaptive_policy"_test = []<class Policy> {
+    static_assert(ami::adaptive_policy<Policy{}> ==
+        std::same_as<std::remove_cvref_t<Policy>,
+            ami::execution::adaptive_policy>);
+  } | policies;
+
+  "pool_policy"_test = []<class Policy> {
+    static_assert(ami::pool_policy<Policy{}> ==
+        std::same_as<std::remove_cvref_t<Policy>,
+            ami::execution::pool_policy>);
+  } | policies;
 }
@@ -0,0 +1,37 @@
+#include "ami/concepts/layer.hpp"
+
+#include <array>
+#include <cstddef>
+
+#include <boost/ut.hpp>
+
+#include "ami/layer/activation_layer.hpp"
+#include "ami/layer/dense_layer.hpp"
+#include "ami/layer/dropout_layer.hpp"
+
+struct func {
+  template <std::floating_point RealType>
+  static constexpr RealType f(RealType src) { return src; }
+
+  template <std::floating_point RealType>
+  static constexpr RealType df(RealType src) { return src; }
+};
+
+int main() {
+  using namespace boost::ut;
+
+  "layer"_test = [] {
+    static_assert(ami::layer<ami::dense_layer_t<float, 2, 3>>);
+    static_assert(ami::layer<ami::activation_layer_t<float, 2, func>>);
+    static_assert(ami::layer<ami::dropout_layer_t<float, 2, 0.5>>);
+    static_assert(!ami::layer<std::array<float, 2>>);
+  };
+
+  "trainable_layer"_test = [] {
+    static_assert(ami::trainable_layer<ami::dense_layer_t<float, 2, 3>>);
+    static_assert(
+        !ami::trainable_layer<ami::activation_layer_t<float, 2, func>>);
+    static_assert(
+        !ami::trainable_layer<ami::dropout_layer_t<float, 2, 0.5>>);
+  };
+}
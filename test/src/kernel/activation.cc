@@ -0,0 +1,114 @@
+#include "ami/kernel/activation.hpp"
+
+#include <cmath>
+#include <concepts>
+#include <cstddef>
+#include <limits>
+#include <random>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+
+#include <boost/ut.hpp>
+
+template <std::floating_point RealType>
+std::vector<RealType> make_vector(std::size_t size, std::mt19937& engine) {
+  std::uniform_real_distribution<RealType> dist{RealType{-8}, RealType{8}};
+  std::vector<RealType> result(size);
+  for (auto& v : result) {
+    v = dist(engine);
+  }
+  return result;
+}
+
+int main() {
+  using namespace boost::ut;
+  using namespace ami::kernel;
+
+  using isa_targets = std::tuple<
+      std::integral_constant<isa, isa::sse2>,
+      std::integral_constant<isa, isa::avx2>,
+      std::integral_constant<isa, isa::avx512>>;
+
+  using op_targets = std::tuple<
+      relu, leaky_relu<0.1>, sigmoid, ami::kernel::tanh, gelu, silu>;
+
+  constexpr std::size_t sizes[] = {0, 1, 3, 15, 16, 17, 64, 1000, 1027};
+
+  "constant evaluation"_test = [] {
+    static_assert(fast_exp(0.0f) == 1.0f);
+    static_assert(fast_exp(1.0) > 2.718281828 && fast_exp(1.0) < 2.718281829);
+    static_assert(fast_tanh(0.0) == 0.0);
+
+    constexpr auto y = [] {
+      const float x[] = {-1.0f, 2.0f};
+      float y[] = {0.0f, 0.0f};
+      activate<relu>(2, x, y);
+      return y[0] + y[1];
+    }();
+    static_assert(y == 2.0f);
+  };
+
+  "approximation"_test = []<std::floating_point RealType> {
+    constexpr auto eps = std::numeric_limits<RealType>::epsilon();
+
+    should("stay within the documented bounds") = [&] {
+      for (double v = -87; v <= 87; v += 0.0123) {
+        const auto x = static_cast<RealType>(v);
+        const auto e = std::exp(x);
+        const auto s = RealType{1} / (RealType{1} + std::exp(-x));
+        expect(le(std::abs(fast_exp(x) - e), 3 * eps * e));
+        expect(le(std::abs(fast_sigmoid(x) - s), 3 * eps * s));
+        expect(le(std::abs(fast_tanh(x) - std::tanh(x)), 2 * eps));
+      }
+    };
+
+    should("saturate outside the range") = [] {
+      constexpr auto max = std::numeric_limits<RealType>::max();
+      expect(fast_exp(RealType{-1000}) >= RealType{});
+      expect(fast_exp(RealType{1000}) < max);
+      expect(eq(fast_sigmoid(-max), RealType{}) or
+             fast_sigmoid(-max) < std::numeric_limits<RealType>::min());
+      expect(eq(fast_sigmoid(max), RealType{1}));
+      expect(eq(fast_tanh(RealType{-1000}), RealType{-1}));
+      expect(eq(fast_tanh(RealType{1000}), RealType{1}));
+    };
+  } | std::tuple<float, double>{};
+
+  "activate"_test = [&]<std::floating_point RealType> {
+    should("agree with the scalar path") = [&]<class Op> {
+      [&]<class... Isa>(std::tuple<Isa...>) {
+        ([&] {
+          if constexpr (is_available_v<Isa::value>) {
+            std::mt19937 engine{42};
+            for (auto n : sizes) {
+              const auto x = make_vector<RealType>(n, engine);
+              const auto delta = make_vector<RealType>(n, engine);
+
+              std::vector<RealType> expected(n);
+              std::vector<RealType> actual(n);
+              activate<Op, isa::scalar>(n, x.data(), expected.data());
+              activate<Op, Isa::value>(n, x.data(), actual.data());
+              for (std::size_t i = 0; i < n; ++i) {
+                expect(le(std::abs(actual[i] - expected[i]),
+                    8 * std::numeric_limits<RealType>::epsilon() *
+                    (std::abs(expected[i]) + 1)));
+              }
+
+              activate_gradient<Op, isa::scalar>(
+                  n, x.data(), delta.data(), expected.data());
+              activate_gradient<Op, Isa::value>(
+                  n, x.data(), delta.data(), actual.data());
+              // the derivatives cancel where the activation saturates
+              for (std::size_t i = 0; i < n; ++i) {
+                expect(le(std::abs(actual[i] - expected[i]),
+                    16 * std::numeric_limits<RealType>::epsilon() *
+                    (x[i] * x[i] + 1) * (std::abs(delta[i]) + 1)));
+              }
+            }
+          }
+        }(), ...);
+      }(isa_targets{});
+    } | op_targets{};
+  } | std::tuple<float, double>{};
+}
@@ -0,0 +1,90 @@
+#include "ami/kernel/adam.hpp"
+
+#include <cmath>
+#include <concepts>
+#include <cstddef>
+#include <limits>
+#include <random>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+
+#include <boost/ut.hpp>
+
+template <std::floating_point RealType>
+std::vector<RealType> make_vector(
+    std::size_t size, std::mt19937& engine, RealType low = RealType{-1}) {
+  std::uniform_real_distribution<RealType> dist{low, RealType{1}};
+  std::vector<RealType> result(size);
+  for (auto& v : result) {
+    v = dist(engine);
+  }
+  return result;
+}
+
+int main() {
+  using namespace boost::ut;
+  using namespace ami::kernel;
+
+  using isa_targets = std::tuple<
+      std::integral_constant<isa, isa::sse2>,
+      std::integral_constant<isa, isa::avx2>,
+      std::integral_constant<isa, isa::avx512>>;
+
+  constexpr std::size_t sizes[] = {0, 1, 3, 15, 16, 17, 64, 1000, 1027};
+
+  "constant evaluation"_test = [] {
+    constexpr auto w = [] {
+      float w[] = {1.0f};
+      const float g[] = {0.5f};
+      float m[] = {0.0f};
+      float v[] = {0.0f};
+      adam(1, w, g, m, v,
+          adam_coefficients<float>{0.5f, 0.5f, 0.5f, 0.0f, 0.5f, 0.5f});
+      return w[0];
+    }();
+    static_assert(w == 0.5f);
+  };
+
+  "adam"_test = [&]<std::floating_point RealType> {
+    constexpr adam_coefficients<RealType> coefficients{
+        RealType{0.001}, RealType{0.9}, RealType{0.999}, RealType{1e-7},
+        RealType{1} - RealType{0.9} * RealType{0.9},
+        RealType{1} - RealType{0.999} * RealType{0.999}};
+
+    should("agree with the scalar path") = [&]<class Isa> {
+      if constexpr (is_available_v<Isa::value>) {
+        std::mt19937 engine{42};
+        for (auto n : sizes) {
+          const auto w = make_vector<RealType>(n, engine);
+          const auto g = make_vector<RealType>(n, engine);
+          const auto m = make_vector<RealType>(n, engine);
+          const auto v = make_vector<RealType>(n, engine, RealType{0});
+
+          auto expected = std::tuple{w, m, v};
+          auto actual = expected;
+          std::apply([&](auto& w, auto& m, auto& v) {
+                adam<isa::scalar>(
+                    n, w.data(), g.data(), m.data(), v.data(), coefficients);
+              }, expected);
+          std::apply([&](auto& w, auto& m, auto& v) {
+                adam<Isa::value>(
+                    n, w.data(), g.data(), m.data(), v.data(), coefficients);
+              }, actual);
+
+          constexpr auto eps = std::numeric_limits<RealType>::epsilon();
+          std::apply([&](const auto&... expected) {
+                std::apply([&](const auto&... actual) {
+                      ([&](const auto& expected, const auto& actual) {
+                        for (std::size_t i = 0; i < n; ++i) {
+                          expect(le(std::abs(actual[i] - expected[i]),
+                              4 * eps * (std::abs(expected[i]) + 1)));
+                        }
+                      }(expected, actual), ...);
+                    }, actual);
+              }, expected);
+        }
+      }
+    } | isa_targets{};
+  } | std::tuple<float, double>{};
+}
@@ -0,0 +1,135 @@
+#include "ami/kernel/convert.hpp"
+
+#include <bit>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <random>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+
+#include <boost/ut.hpp>
+
+#include "ami/utility/half_precision.hpp"
+
+// Random values with the special cases of narrowing mixed in.
+std::vector<float> make_vector(std::size_t size, std::mt19937& engine) {
+  std::uniform_real_distribution<float> dist{-4.0f, 4.0f};
+  constexpr float specials[] = {
+      0.0f, -0.0f, 1.0f + 0x1p-8f, 1.0f + 0x3p-11f, 0x1p-20f, 1e-30f,
+      70000.0f, std::numeric_limits<float>::infinity(),
+      std::numeric_limits<float>::max(),
+      std::bit_cast<float>(0x7f800001u),
+      std::numeric_limits<float>::quiet_NaN()};
+  std::vector<float> result(size);
+  for (std::size_t i = 0; i < size; ++i) {
+    result[i] = i % 5 == 0 ? specials[i / 5 % std::size(specials)] :
+        dist(engine);
+  }
+  return result;
+}
+
+template <class T>
+bool same_bits(const std::vector<T>& x, const std::vector<T>& y) {
+  if (x.size() != y.size()) {
+    return false;
+  }
+  for (std::size_t i = 0; i < x.size(); ++i) {
+    if constexpr (ami::half_precision<T>) {
+      if (x[i].bits() != y[i].bits()) {
+        return false;
+      }
+    } else if (std::bit_cast<std::uint32_t>(x[i]) !=
+               std::bit_cast<std::uint32_t>(y[i])) {
+      return false;
+    }
+  }
+  return true;
+}
+
+int main() {
+  using namespace boost::ut;
+  using namespace ami::kernel;
+
+  using isa_targets = std::tuple<
+      std::integral_constant<isa, isa::sse2>,
+      std::integral_constant<isa, isa::avx2>,
+      std::integral_constant<isa, isa::avx512>>;
+
+  constexpr std::size_t sizes[] = {0, 1, 7, 8, 9, 64, 1000, 1027};
+
+  "constant evaluation"_test = [] {
+    static_assert([] {
+      constexpr float x[] = {1.0f, 2.5f, -3.0f};
+      ami::bfloat16 y[3]{};
+      convert(3, x, y);
+      float z[3]{};
+      convert(3, y, z);
+      return z[0] == 1.0f && z[1] == 2.5f && z[2] == -3.0f &&
+          dot(3, y, x) == 16.25f;
+    }());
+  };
+
+  "convert"_test = [&]<ami::half_precision Storage> {
+    should("agree with the scalar path") = [&]<class Isa> {
+      if constexpr (is_available_v<Isa::value>) {
+        std::mt19937 engine{42};
+        for (auto n : sizes) {
+          const auto x = make_vector(n, engine);
+
+          std::vector<Storage> expected(n), actual(n);
+          convert<isa::scalar>(n, x.data(), expected.data());
+          convert<Isa::value>(n, x.data(), actual.data());
+          expect(same_bits(actual, expected)) << n;
+          for (std::size_t i = 0; i < n; ++i) {
+            if (actual[i].bits() != Storage{x[i]}.bits()) {
+              expect(false) << "element" << i << "of" << n;
+              break;
+            }
+          }
+
+          std::vector<float> wide(n), wide_expected(n);
+          convert<isa::scalar>(n, actual.data(), wide_expected.data());
+          convert<Isa::value>(n, actual.data(), wide.data());
+          expect(same_bits(wide, wide_expected)) << n;
+        }
+      }
+    } | isa_targets{};
+  } | std::tuple<ami::bfloat16, ami::float16>{};
+
+  "dot and axpy"_test = [&]<ami::half_precision Storage> {
+    std::mt19937 engine{7};
+    for (auto n : sizes) {
+      std::uniform_real_distribution<float> dist{-1.0f, 1.0f};
+      std::vector<float> x(n), y(n);
+      for (std::size_t i = 0; i < n; ++i) {
+        x[i] = dist(engine);
+        y[i] = dist(engine);
+      }
+      std::vector<Storage> x16(n);
+      convert(n, x.data(), x16.data());
+      std::vector<float> widened(n);
+      convert(n, x16.data(), widened.data());
+
+      float magnitude{};
+      for (std::size_t i = 0; i < n; ++i) {
+        magnitude += std::abs(widened[i] * y[i]);
+      }
+      const auto expected = dot<isa::scalar>(n, widened.data(), y.data());
+      expect(le(std::abs(dot(n, x16.data(), y.data()) - expected),
+          std::numeric_limits<float>::epsilon() *
+          static_cast<float>(n + 1) * magnitude));
+
+      auto result = y;
+      auto result_expected = y;
+      axpy(n, 0.5f, x16.data(), result.data());
+      axpy<isa::scalar>(n, 0.5f, widened.data(), result_expected.data());
+      for (std::size_t i = 0; i < n; ++i) {
+        expect(le(std::abs(result[i] - result_expected[i]),
+            std::numeric_limits<float>::epsilon() * 2));
+      }
+    }
+  } | std::tuple<ami::bfloat16, ami::float16>{};
+}
@@ -0,0 +1,221 @@
+#include "ami/kernel/gemm.hpp"
+
+#include <concepts>
+#include <cstddef>
+#include <execution>
+#include <tuple>
+#include <vector>
+
+#include <boost/ut.hpp>
+
+#include "ami/utility/half_precision.hpp"
+
+template <std::floating_point RealType>
+std::vector<RealType> make_matrix(std::size_t size, std::size_t seed) {
+  std::vector<RealType> result(size);
+  for (std::size_t i = 0; i < size; ++i) {
+    result[i] = static_cast<RealType>(static_cast<int>((i * 7 + seed) % 5) - 2);
+  }
+  return result;
+}
+
+int main() {
+  using namespace boost::ut;
+  using namespace ami::kernel;
+  using namespace std::execution;
+
+  constexpr std::tuple policies{
+      seq, par, par_unseq, unseq, ami::execution::adaptive,
+      ami::execution::pool};
+
+  // Covers the unpacked path, partial register tiles and every blocking loop.
+  constexpr std::tuple sizes{
+      std::array<std::size_t, 3>{3, 5, 7},
+      std::array<std::size_t, 3>{131, 37, 300},
+      std::array<std::size_t, 3>{5, 2100, 9}};
+
+  "gemm"_test = [&]<std::floating_point RealType> {
+    should("match the naive product for every layout") = [&]<class Policy> {
+      std::apply([&](auto... size) {
+        ([&](auto m, auto n, auto k) {
+          const auto a = make_matrix<RealType>(m * k, 1);
+          const auto b = make_matrix<RealType>(k * n, 2);
+
+          std::vector<RealType> expected(m * n, RealType{1});
+          for (std::size_t i = 0; i < m; ++i) {
+            for (std::size_t j = 0; j < n; ++j) {
+              for (std::size_t p = 0; p < k; ++p) {
+                expected[i * n + j] += a[i * k + p] * b[p * n + j];
+              }
+            }
+          }
+
+          std::vector<RealType> c(m * n, RealType{1});
+          gemm<Policy{}>(m, n, k, row_major(a.data(), k),
+              row_major(b.data(), n), row_major(c.data(), n));
+          expect(c == expected);
+
+          // Same product with A^T and B^T stored row major.
+          std::vector<RealType> at(k * m);
+          std::vector<RealType> bt(n * k);
+          for (std::size_t i = 0; i < m; ++i) {
+            for (std::size_t p = 0; p < k; ++p) {
+              at[p * m + i] = a[i * k + p];
+            }
+          }
+          for (std::size_t p = 0; p < k; ++p) {
+            for (std::size_t j = 0; j < n; ++j) {
+              bt[j * k + p] = b[p * n + j];
+            }
+          }
+
+          std::vector<RealType> ct(m * n, RealType{1});
+          gemm<Policy{}>(m, n, k, col_major(at.data(), m),
+              col_major(bt.data(), k), row_major(ct.data(), n));
+          expect(ct == expected);
+        }(size[0], size[1], size[2]), ...);
+      }, sizes);
+    } | policies;
+  } | std::tuple<float, double>{};
+
+  "gemv"_test = [&]<std::floating_point RealType> {
+    should("match the naive product") = [&]<class Policy> {
+      for (auto [m, n] : {std::pair<std::size_t, std::size_t>{3, 5},
+                          {101, 300}, {7, 1000}, {1000, 20}}) {
+        const auto a = make_matrix<RealType>(m * n, 3);
+        const auto x = make_matrix<RealType>(n, 4);
+        const auto xt = make_matrix<RealType>(m, 5);
+
+        std::vector<RealType> expected(m, RealType{1});
+        std::vector<RealType> expected_t(n, RealType{1});
+        for (std::size_t i = 0; i < m; ++i) {
+          for (std::size_t j = 0; j < n; ++j) {
+            expected[i] += a[i * n + j] * x[j];
+            expected_t[j] += a[i * n + j] * xt[i];
+          }
+        }
+
+        std::vector<RealType> y(m, RealType{1});
+        gemv<Policy{}>(m, n, a.data(), n, x.data(), y.data());
+        expect(y == expected);
+
+        std::vector<RealType> yt(n, RealType{1});
+        gemv_t<Policy{}>(m, n, a.data(), n, xt.data(), yt.data());
+        expect(yt == expected_t);
+      }
+    } | policies;
+
+    should("apply the epilogue once to every output") = [&]<class Policy> {
+      for (auto [m, n] : {std::pair<std::size_t, std::size_t>{3, 5},
+                          {101, 300}, {7, 1000}}) {
+        const auto a = make_matrix<RealType>(m * n, 3);
+        const auto x = make_matrix<RealType>(n, 4);
+
+        std::vector<RealType> expected(m, RealType{1});
+        gemv(m, n, a.data(), n, x.data(), expected.data());
+        std::vector<RealType> expected_out(m);
+        for (std::size_t i = 0; i < m; ++i) {
+          expected_out[i] = expected[i] * 2 + static_cast<RealType>(i);
+        }
+
+        std::vector<RealType> y(m, RealType{1});
+        std::vector<RealType> out(m);
+        gemv<Policy{}>(m, n, a.data(), n, x.data(), y.data(),
+            [&](std::size_t i, RealType v) {
+              out[i] += v * 2 + static_cast<RealType>(i);
+              return v;
+            });
+        expect(y == expected);
+        expect(out == expected_out);
+      }
+    } | policies;
+  } | std::tuple<float, double>{};
+
+  "ger"_test = [&]<std::floating_point RealType> {
+    should("match the naive outer product") = [&]<class Policy> {
+      constexpr std::size_t m = 13;
+      constexpr std::size_t n = 29;
+      const auto x = make_matrix<RealType>(m, 6);
+      const auto y = make_matrix<RealType>(n, 7);
+
+      auto expected = make_matrix<RealType>(m * n, 8);
+      auto a = expected;
+      for (std::size_t i = 0; i < m; ++i) {
+        for (std::size_t j = 0; j < n; ++j) {
+          expected[i * n + j] += x[i] * y[j];
+        }
+      }
+
+      ger<Policy{}>(m, n, x.data(), y.data(), a.data(), n);
+      expect(a == expected);
+    } | policies;
+  } | std::tuple<float, double>{};
+
+  "mixed precision"_test = [&]<ami::half_precision Storage> {
+    // Small integers are exact in 16 bits, so the products must match the
+    // float kernels on the widened operands exactly.
+    const auto narrow = [](const std::vector<float>& values) {
+      std::vector<Storage> result;
+      for (const auto v : values) {
+        result.emplace_back(v);
+      }
+      return result;
+    };
+
+    should("gemv and gemv_t") = [&]<class Policy> {
+      for (auto [m, n] : {std::pair<std::size_t, std::size_t>{3, 5},
+                          {101, 300}, {7, 1000}, {1000, 20}}) {
+        const auto a = make_matrix<float>(m * n, 3);
+        const auto a16 = narrow(a);
+        const auto x = make_matrix<float>(n, 4);
+        const auto xt = make_matrix<float>(m, 5);
+
+        std::vector<float> expected(m, 1.0f);
+        gemv(m, n, a.data(), n, x.data(), expected.data());
+        std::vector<float> y(m, 1.0f);
+        gemv<Policy{}>(m, n, a16.data(), n, x.data(), y.data());
+        expect(y == expected);
+
+        std::vector<float> expected_t(n, 1.0f);
+        gemv_t(m, n, a.data(), n, xt.data(), expected_t.data());
+        std::vector<float> yt(n, 1.0f);
+        gemv_t<Policy{}>(m, n, a16.data(), n, xt.data(), yt.data());
+        expect(yt == expected_t);
+      }
+    } | policies;
+
+    should("gemm") = [&]<class Policy> {
+      std::apply([&](auto... size) {
+        ([&](auto m, auto n, auto k) {
+          const auto a = make_matrix<float>(m * k, 1);
+          const auto b = make_matrix<float>(k * n, 2);
+          const auto a16 = narrow(a);
+          const auto b16 = narrow(b);
+
+          std::vector<float> expected(m * n, 1.0f);
+          gemm(m, n, k, row_major(a.data(), k), row_major(b.data(), n),
+              row_major(expected.data(), n));
+
+          std::vector<float> c(m * n, 1.0f);
+          gemm<Policy{}>(m, n, k, row_major(a16.data(), k),
+              row_major(b.data(), n), row_major(c.data(), n));
+          expect(c == expected);
+
+          std::vector<float> c16(m * n, 1.0f);
+          gemm<Policy{}>(m, n, k, row_major(a16.data(), k),
+              col_major(b16.data(), k), row_major(c16.data(), n));
+          // b16 read column major is B^T; recompute the reference.
+          std::vector<float> expected_t(m * n, 1.0f);
+          for (std::size_t i = 0; i < m; ++i) {
+            for (std::size_t j = 0; j < n; ++j) {
+              for (std::size_t p = 0; p < k; ++p) {
+                expected_t[i * n + j] += a[i * k + p] * b[j * k + p];
+              }
+            }
+          }
+          expect(c16 == expected_t);
+        }(size[0], size[1], size[2]), ...);
+      }, sizes);
+    } | policies;
+  } | std::tuple<ami::bfloat16, ami::float16>{};
+}
@@ -0,0 +1,88 @@
+#include "ami/kernel/quantized.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <execution>
+#include <random>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+
+#include <boost/ut.hpp>
+
+std::vector<std::uint8_t> make_u8(std::size_t size, std::mt19937& engine) {
+  std::uniform_int_distribution<int> dist{0, 255};
+  std::vector<std::uint8_t> result(size);
+  for (auto& x : result) {
+    x = static_cast<std::uint8_t>(dist(engine));
+  }
+  return result;
+}
+
+std::vector<std::int8_t> make_s8(std::size_t size, std::mt19937& engine) {
+  std::uniform_int_distribution<int> dist{-128, 127};
+  std::vector<std::int8_t> result(size);
+  for (auto& x : result) {
+    x = static_cast<std::int8_t>(dist(engine));
+  }
+  return result;
+}
+
+int main() {
+  using namespace boost::ut;
+  using namespace ami::kernel;
+
+  using isa_targets = std::tuple<
+      std::integral_constant<isa, isa::sse2>,
+      std::integral_constant<isa, isa::avx2>,
+      std::integral_constant<isa, isa::avx512>>;
+
+  constexpr std::size_t sizes[] = {0, 1, 31, 32, 33, 64, 127, 128, 129, 1000};
+
+  "constant evaluation"_test = [] {
+    static_assert([] {
+      constexpr std::uint8_t x[] = {255, 1, 2};
+      constexpr std::int8_t y[] = {-128, 127, -3};
+      return dot(3, x, y) == -255 * 128 + 127 - 6;
+    }());
+  };
+
+  "dot"_test = [&]<class Isa> {
+    if constexpr (is_available_v<Isa::value>) {
+      std::mt19937 engine{42};
+      for (auto n : sizes) {
+        const auto x = make_u8(n, engine);
+        const auto y = make_s8(n, engine);
+        expect(eq(dot<Isa::value>(n, x.data(), y.data()),
+            dot<isa::scalar>(n, x.data(), y.data()))) << n;
+      }
+
+      // Every pair at the extremes: no partial sum may saturate.
+      std::vector<std::uint8_t> x(1000, 255);
+      std::vector<std::int8_t> y(1000, -128);
+      expect(eq(dot<Isa::value>(x.size(), x.data(), y.data()),
+          -255 * 128 * 1000));
+      y.assign(1000, 127);
+      expect(eq(dot<Isa::value>(x.size(), x.data(), y.data()),
+          255 * 127 * 1000));
+    }
+  } | isa_targets{};
+
+  "gemv"_test = []<class Policy> {
+    std::mt19937 engine{7};
+    for (std::size_t m : {1, 5, 64, 65, 200}) {
+      for (std::size_t n : {1, 33, 300}) {
+        const auto lda = n + 3;
+        const auto a = make_s8(m * lda, engine);
+        const auto x = make_u8(n, engine);
+        std::vector<std::int32_t> y(m, 10);
+        gemv<Policy{}>(m, n, a.data(), lda, x.data(), y.data());
+        for (std::size_t i = 0; i < m; ++i) {
+          expect(eq(y[i], 10 + dot<isa::scalar>(n, x.data(),
+              a.data() + i * lda)));
+        }
+      }
+    }
+  } | std::tuple<std::execution::sequenced_policy,
+                 std::execution::parallel_policy>{};
+}
@@ -0,0 +1,86 @@
+#include "ami/kernel/simd.hpp"
+
+#include <cmath>
+#include <concepts>
+#include <cstddef>
+#include <limits>
+#include <random>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+
+#include <boost/ut.hpp>
+
+template <std::floating_point RealType>
+std::vector<RealType> make_vector(std::size_t size, std::mt19937& engine) {
+  std::uniform_real_distribution<RealType> dist{RealType{-1}, RealType{1}};
+  std::vector<RealType> result(size);
+  for (auto& v : result) {
+    v = dist(engine);
+  }
+  return result;
+}
+
+int main() {
+  using namespace boost::ut;
+  using namespace ami::kernel;
+
+  using isa_targets = std::tuple<
+      std::integral_constant<isa, isa::sse2>,
+      std::integral_constant<isa, isa::avx2>,
+      std::integral_constant<isa, isa::avx512>>;
+
+  constexpr std::size_t sizes[] = {0, 1, 3, 15, 16, 17, 64, 1000, 1027};
+
+  "constant evaluation"_test = [] {
+    constexpr float x[] = {1.0f, 2.0f, 3.0f};
+    static_assert(dot(3, x, x) == 14.0f);
+  };
+
+  "dot"_test = [&]<std::floating_point RealType> {
+    should("agree with the scalar path") = [&]<class Isa> {
+      if constexpr (is_available_v<Isa::value>) {
+        std::mt19937 engine{42};
+        for (auto n : sizes) {
+          const auto x = make_vector<RealType>(n, engine);
+          const auto y = make_vector<RealType>(n, engine);
+
+          RealType magnitude{};
+          for (std::size_t i = 0; i < n; ++i) {
+            magnitude += std::abs(x[i] * y[i]);
+          }
+
+          const auto expected = dot<isa::scalar>(n, x.data(), y.data());
+          const auto actual = dot<Isa::value>(n, x.data(), y.data());
+          expect(le(std::abs(actual - expected),
+              std::numeric_limits<RealType>::epsilon() *
+              static_cast<RealType>(n + 1) * magnitude));
+        }
+      }
+    } | isa_targets{};
+  } | std::tuple<float, double>{};
+
+  "axpy"_test = [&]<std::floating_point RealType> {
+    should("agree with the scalar path") = [&]<class Isa> {
+      if constexpr (is_available_v<Isa::value>) {
+        std::mt19937 engine{42};
+        for (auto n : sizes) {
+          const auto x = make_vector<RealType>(n, engine);
+          const auto y = make_vector<RealType>(n, engine);
+          constexpr auto alpha = RealType{0.75};
+
+          auto expected = y;
+          auto actual = y;
+          axpy<isa::scalar>(n, alpha, x.data(), expected.data());
+          axpy<Isa::value>(n, alpha, x.data(), actual.data());
+
+          for (std::size_t i = 0; i < n; ++i) {
+            expect(le(std::abs(actual[i] - expected[i]),
+                std::numeric_limits<RealType>::epsilon() *
+                (std::abs(alpha * x[i]) + std::abs(y[i]))));
+          }
+        }
+      }
+    } | isa_targets{};
+  } | std::tuple<float, double>{};
+}
@@ -0,0 +1,178 @@
+#include "ami/kernel/sparse.hpp"
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <execution>
+#include <random>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include <boost/ut.hpp>
+
+// An m x n matrix, dense and in CSR, with about density of it nonzero.
+template <class T>
+struct sparse_matrix {
+  std::size_t m{};
+  std::size_t n{};
+  std::vector<T> dense{};
+  std::vector<std::uint32_t> offsets{};
+  std::vector<std::uint32_t> indices{};
+  std::vector<T> values{};
+};
+
+template <class T>
+sparse_matrix<T> make_sparse(std::size_t m, std::size_t n, double density,
+                             std::mt19937& engine) {
+  std::bernoulli_distribution keep{density};
+  std::uniform_real_distribution<T> dist{-1, 1};
+  sparse_matrix<T> result{m, n, std::vector<T>(m * n)};
+  for (std::size_t i = 0; i < m; ++i) {
+    result.offsets.push_back(static_cast<std::uint32_t>(result.values.size()));
+    for (std::size_t j = 0; j < n; ++j) {
+      if (keep(engine)) {
+        const auto w = dist(engine);
+        result.dense[i * n + j] = w;
+        result.indices.push_back(static_cast<std::uint32_t>(j));
+        result.values.push_back(w);
+      }
+    }
+  }
+  result.offsets.push_back(static_cast<std::uint32_t>(result.values.size()));
+
+  return result;
+}
+
+template <class T>
+std::vector<T> make_vector(std::size_t size, std::mt19937& engine) {
+  std::uniform_real_distribution<T> dist{-1, 1};
+  std::vector<T> result(size);
+  for (auto& x : result) {
+    x = dist(engine);
+  }
+  return result;
+}
+
+template <class T>
+bool close(T actual, T expected) {
+  return std::abs(actual - expected) <= T{1e-4} * (1 + std::abs(expected));
+}
+
+int main() {
+  using namespace boost::ut;
+  using namespace ami::kernel;
+
+  using policies = std::tuple<std::execution::sequenced_policy,
+                              std::execution::parallel_policy>;
+
+  constexpr std::pair<std::size_t, std::size_t> shapes[] = {
+      {1, 1}, {3, 7}, {64, 33}, {65, 130}, {200, 17}};
+
+  "spmv"_test = [&]<class Policy> {
+    std::mt19937 engine{42};
+    for (const auto& [m, n] : shapes) {
+      for (const auto density : {0.0, 0.1, 0.5, 1.0}) {
+        const auto a = make_sparse<float>(m, n, density, engine);
+        const auto x = make_vector<float>(n, engine);
+        std::vector<float> y(m, 1.0f);
+        spmv<Policy{}>(m, a.offsets.data(), a.indices.data(),
+            a.values.data(), x.data(), y.data());
+        for (std::size_t i = 0; i < m; ++i) {
+          auto expected = 1.0f;
+          for (std::size_t j = 0; j < n; ++j) {
+            expected += a.dense[i * n + j] * x[j];
+          }
+          expect(close(y[i], expected)) << m << n << density << i;
+        }
+      }
+    }
+  } | policies{};
+
+  "spmv epilogue"_test = [] {
+    std::mt19937 engine{3};
+    const auto a = make_sparse<double>(70, 20, 0.3, engine);
+    const auto x = make_vector<double>(20, engine);
+    std::vector<double> plain(70);
+    spmv(70, a.offsets.data(), a.indices.data(), a.values.data(), x.data(),
+        plain.data());
+    std::vector<double> y(70);
+    spmv<std::execution::par>(70, a.offsets.data(), a.indices.data(),
+        a.values.data(), x.data(), y.data(), [](std::size_t i, double z) {
+          return z * 2 + static_cast<double>(i);
+        });
+    for (std::size_t i = 0; i < y.size(); ++i) {
+      expect(eq(y[i], plain[i] * 2 + static_cast<double>(i)));
+    }
+  };
+
+  "gemv_sparse"_test = [&]<class Policy> {
+    std::mt19937 engine{5};
+    for (const auto& [m, n] : shapes) {
+      for (const std::size_t nnz : {0, 1, 3, 9}) {
+        const auto a = make_vector<double>(m * (n + 2), engine);
+        std::uniform_int_distribution<std::uint32_t> column{
+            0, static_cast<std::uint32_t>(n - 1)};
+        std::vector<std::uint32_t> indices(nnz);
+        for (auto& j : indices) {
+          j = column(engine);
+        }
+        const auto values = make_vector<double>(nnz, engine);
+        std::vector<double> y(m, 1.0);
+        gemv_sparse<Policy{}>(m, a.data(), n + 2, nnz, indices.data(),
+            values.data(), y.data());
+        for (std::size_t i = 0; i < m; ++i) {
+          // Repeated indices add up.
+          auto expected = 1.0;
+          for (std::size_t k = 0; k < nnz; ++k) {
+            expected += a[i * (n + 2) + indices[k]] * values[k];
+          }
+          expect(close(y[i], expected)) << m << n << nnz << i;
+        }
+      }
+    }
+  } | policies{};
+
+  "spmv_t"_test = [&]<class Policy> {
+    std::mt19937 engine{7};
+    for (const auto& [m, n] : shapes) {
+      for (const auto density : {0.0, 0.1, 0.5, 1.0}) {
+        const auto a = make_sparse<float>(m, n, density, engine);
+        const auto x = make_vector<float>(m, engine);
+        std::vector<float> y(n, 1.0f);
+        spmv_t<Policy{}>(m, n, a.offsets.data(), a.indices.data(),
+            a.values.data(), x.data(), y.data());
+        for (std::size_t j = 0; j < n; ++j) {
+          auto expected = 1.0f;
+          for (std::size_t i = 0; i < m; ++i) {
+            expected += a.dense[i * n + j] * x[i];
+          }
+          expect(close(y[j], expected)) << m << n << density << j;
+        }
+      }
+    }
+  } | policies{};
+
+  "sddmm"_test = [&]<class Policy> {
+    std::mt19937 engine{11};
+    for (const auto& [m, n] : shapes) {
+      for (std::size_t k : {1, 5}) {
+        const auto a = make_sparse<float>(m, n, 0.3, engine);
+        const auto x = make_vector<float>(k * m, engine);
+        const auto y = make_vector<float>(k * n, engine);
+        auto values = a.values;
+        sddmm<Policy{}>(k, m, a.offsets.data(), a.indices.data(), x.data(),
+            m, y.data(), n, values.data());
+        for (std::size_t i = 0; i < m; ++i) {
+          for (auto p = a.offsets[i]; p < a.offsets[i + 1]; ++p) {
+            auto expected = a.values[p];
+            for (std::size_t b = 0; b < k; ++b) {
+              expected += x[b * m + i] * y[b * n + a.indices[p]];
+            }
+            expect(close(values[p], expected)) << m << n << k << p;
+          }
+        }
+      }
+    }
+  } | policies{};
+}
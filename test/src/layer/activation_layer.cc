@@ -1,13 +1,18 @@
 #include "ami/layer/activation_layer.hpp"
 
 #include <array>
+#include <cmath>
 #include <execution>
+#include <limits>
 #include <tuple>
 #include <type_traits>
 #include <utility>
 
 #include "boost/ut.hpp"
 
+#include "ami/activation/relu.hpp"
+#include "ami/activation/sigmoid.hpp"
+
 struct func {
   template <std::floating_point RealType>
   static constexpr RealType f(RealType src) { return src; }
@@ -43,7 +48,9 @@ int main() {
       activation_layer_t<float, 1, func>, activation_layer_t<float, 2, func>,
       activation_layer_t<double, 1, func>, activation_layer_t<double, 2, func>>;
 
-  constexpr std::tuple policies{seq, par, par_unseq, unseq};
+  constexpr std::tuple policies{
+      seq, par, par_unseq, unseq, ami::execution::adaptive,
+      ami::execution::pool};
 
   "forward"_test = [&]<class Layer>() {
     using layer_t = std::remove_cvref_t<Layer>;
@@ -54,6 +61,61 @@ int main() {
     } | policies;
   } | test_target_t{};
 
+  "batch"_test = [&]<class Layer>() {
+    using layer_t = std::remove_cvref_t<Layer>;
+    using real_type = typename layer_t::real_type;
+    using function_type = typename layer_t::function_type;
+    static_assert(ami::batch_activation_function<function_type, real_type>);
+
+    typename layer_t::input_type input{};
+    typename layer_t::delta_type delta{};
+    for (std::size_t i = 0; i < input.size(); ++i) {
+      input[i] = static_cast<real_type>(i % 13) - 6;
+      delta[i] = static_cast<real_type>(i % 7) - 3;
+    }
+
+    should("match the scalar function on each policy") = [&]<class Policy>() {
+      const auto forward = layer_t::template forward<Policy{}>(input);
+      const auto backward = layer_t::template backward<Policy{}>(
+          input, delta);
+      // a few ulp apart where the kernels contract to fused multiply-add
+      constexpr auto eps =
+          16 * std::numeric_limits<real_type>::epsilon();
+      bool close = true;
+      for (std::size_t i = 0; i < input.size(); ++i) {
+        close = close &&
+            std::abs(forward[i] - function_type::f(input[i])) <= eps &&
+            std::abs(backward[i] - function_type::df(input[i]) * delta[i]) <=
+                eps * (std::abs(delta[i]) + 1);
+      }
+      expect(close);
+    } | policies;
+  } | std::tuple<activation_layer_t<float, 3000, relu>,
+                 activation_layer_t<double, 17, relu>,
+                 activation_layer_t<float, 37,
+                     sigmoid<precision::fast>>>{};
+
+  "backward_output"_test = [&]<class Layer>() {
+    using layer_t = std::remove_cvref_t<Layer>;
+    using real_type = typename layer_t::real_type;
+    static_assert(layer_t::backward_from_output);
+    static_assert(!activation_layer_t<real_type, 3, func>::backward_from_output);
+
+    typename layer_t::input_type input{};
+    typename layer_t::delta_type delta{};
+    for (std::size_t i = 0; i < input.size(); ++i) {
+      input[i] = static_cast<real_type>(i % 5) - 2;
+      delta[i] = static_cast<real_type>(i % 3) + 1;
+    }
+
+    should("match backward from the input") = [&]<class Policy>() {
+      const auto output = layer_t::template forward<Policy{}>(input);
+      expect(layer_t::template backward_output<Policy{}>(output, delta) ==
+          layer_t::template backward<Policy{}>(input, delta));
+    } | policies;
+  } | std::tuple<activation_layer_t<float, 9, relu>,
+                 activation_layer_t<double, 2000, sigmoid<>>>{};
+
   "backward"_test = [&]<class Layer>() {
     using layer_t = std::remove_cvref_t<Layer>;
     typename layer_t::input_type input{};
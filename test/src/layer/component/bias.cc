@@ -46,7 +46,9 @@ int main() {
   } | target_t{};
 
   using namespace std::execution;
-  constexpr std::tuple policies{seq, par, par_unseq, unseq};
+  constexpr std::tuple policies{
+      seq, par, par_unseq, unseq, ami::execution::adaptive,
+      ami::execution::pool};
 
   "calc_gradient"_test = [&]<class Bias>(Bias src) {
     using real_t = typename Bias::real_type;
@@ -66,4 +68,17 @@ int main() {
       expect(eq(src.value(), real_t{1}));
     } | policies;
   } | target_t{};
+
+  "view"_test = [&]<class Bias>(Bias) {
+    using real_t = typename Bias::real_type;
+    using view_t = bias<real_t, real_t&>;
+
+    real_t value{1};
+    view_t view{value};
+    expect(eq(view.value(), real_t{1}));
+
+    typename view_t::template optimizer_type<optimizer_t> optimizers{};
+    view.update(optimizers, real_t{1});
+    expect(eq(value, real_t{2}));
+  } | target_t{};
 }
@@ -5,6 +5,7 @@
 #include <cstddef>
 #include <execution>
 #include <tuple>
+#include <span>
 #include <type_traits>
 #include <vector>
 #include <utility>
@@ -97,7 +98,9 @@ int main() {
     }();
   } | test_targets{};
 
-  constexpr std::tuple policies{seq, par, par_unseq, unseq};
+  constexpr std::tuple policies{
+      seq, par, par_unseq, unseq, ami::execution::adaptive,
+      ami::execution::pool};
 
   "forward"_test = [&]<class Node>(Node&& src) {
     should("same result on each execution policy") = [&]<class Policy> {
@@ -173,4 +176,30 @@ int main() {
     } | policies ;
   }| test_targets{};
 
+  "view"_test = [&]<class Node> {
+    using node_t = std::remove_cvref_t<Node>;
+    using real_t = typename node_t::real_type;
+    using view_t = node<real_t, node_t::size,
+                        std::span<real_t, node_t::size>>;
+
+    static_assert(std::same_as<typename view_t::value_type,
+                               typename node_t::value_type>);
+
+    std::array<real_t, node_t::size> buffer{};
+    buffer.front() = real_t{0.5};
+    view_t view{std::span{buffer}};
+
+    std::array<real_t, node_t::size> input{};
+    input.fill(real_t{2});
+    expect(eq(view.forward(input), real_t{1}));
+
+    std::array<real_t, node_t::size> gradient{};
+    gradient.fill(real_t{1});
+    typename view_t::template optimizer_type<optimizer_t> optimizers{};
+    view.update(optimizers, gradient);
+
+    expect(eq(buffer.front(), real_t{1.5}));
+    expect(eq(buffer.back(), node_t::size > 1 ? real_t{1} : real_t{1.5}));
+    expect(view.value() == buffer);
+  } | test_targets{};
 }
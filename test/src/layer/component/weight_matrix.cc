@@ -0,0 +1,63 @@
+#include "ami/layer/component/weight_matrix.hpp"
+
+#include <concepts>
+#include <cstdint>
+#include <span>
+#include <tuple>
+
+#include <boost/ut.hpp>
+
+int main() {
+  using namespace boost::ut;
+  using namespace ami;
+
+  "leading_dimension"_test = [] {
+    static_assert(weight_matrix<float, 2, 3>::leading_dimension == 3);
+    static_assert(
+        weight_matrix<float, 2, 3, row_padding::cache_line>::
+            leading_dimension == 16);
+    static_assert(
+        weight_matrix<double, 2, 9, row_padding::cache_line>::
+            leading_dimension == 16);
+    static_assert(
+        weight_matrix<double, 2, 8, row_padding::cache_line>::
+            leading_dimension == 8);
+  };
+
+  using target_t = std::tuple<
+      weight_matrix<float, 3, 5>,
+      weight_matrix<float, 3, 5, row_padding::cache_line>,
+      weight_matrix<double, 3, 5>,
+      weight_matrix<double, 3, 5, row_padding::cache_line>>;
+
+  "alignment"_test = []<class Matrix> {
+    Matrix matrix{};
+    expect(eq(reinterpret_cast<std::uintptr_t>(matrix.data()) %
+        Matrix::alignment, std::uintptr_t{}));
+
+    if constexpr (Matrix::leading_dimension != Matrix::cols) {
+      for (std::size_t i = 0; i < Matrix::rows; ++i) {
+        expect(eq(reinterpret_cast<std::uintptr_t>(matrix.row(i).data()) %
+            Matrix::alignment, std::uintptr_t{}));
+      }
+    }
+  } | target_t{};
+
+  "row"_test = []<class Matrix> {
+    using real_t = typename Matrix::real_type;
+    Matrix matrix{};
+
+    for (std::size_t i = 0; i < Matrix::rows; ++i) {
+      auto row = matrix.row(i);
+      static_assert(decltype(row)::extent == Matrix::cols);
+      row.back() = static_cast<real_t>(i + 1);
+    }
+
+    const auto& cmatrix = matrix;
+    for (std::size_t i = 0; i < Matrix::rows; ++i) {
+      expect(eq(cmatrix.span()[i * Matrix::leading_dimension +
+          Matrix::cols - 1], static_cast<real_t>(i + 1)));
+      expect(eq(cmatrix.row(i).data(), matrix.row(i).data()));
+    }
+  } | target_t{};
+}
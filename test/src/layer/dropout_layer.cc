@@ -1,5 +1,7 @@
 #include "ami/layer/dropout_layer.hpp"
 
+#include <cstddef>
+#include <cstdint>
 #include <random>
 #include <tuple>
 #include <utility>
@@ -33,7 +35,9 @@ int main() {
       dropout_layer_t<float, 1, 0.5>, dropout_layer_t<float, 2, 0.5>,
       dropout_layer_t<double, 1, 0.5>, dropout_layer_t<double, 2, 0.5>>;
 
-  constexpr std::tuple policies{seq, par, par_unseq, unseq};
+  constexpr std::tuple policies{
+      seq, par, par_unseq, unseq, ami::execution::adaptive,
+      ami::execution::pool};
 
   std::default_random_engine engine{std::random_device{}()};
 
@@ -47,15 +51,53 @@ int main() {
     } | policies;
   } | test_target_t{};
 
+  "make_mask"_test = [&] {
+    using layer_t = dropout_layer_t<float, 1000, 0.25>;
+
+    should("be the same on each policy") = [&]<class Policy>() {
+      utility::philox philox{42};
+      utility::philox reference{42};
+      const auto mask = layer_t::make_mask<Policy{}>(philox);
+      expect(mask == layer_t::make_mask(reference));
+      expect(mask != layer_t::make_mask<Policy{}>(philox));
+    } | policies;
+
+    should("keep units at the rate") = [] {
+      utility::philox philox{1};
+      std::size_t kept{};
+      for (int i = 0; i < 100; ++i) {
+        kept += layer_t::make_mask<par>(philox).count();
+      }
+      expect(kept > 24000 and kept < 26000);
+    };
+
+    should("leave the bits past the size clear") = [] {
+      utility::philox philox{3};
+      for (int i = 0; i < 10; ++i) {
+        expect(eq(layer_t::make_mask(philox).words().back() >> (1000 % 64),
+            std::uint64_t{}));
+      }
+    };
+  };
+
   "backward"_test = [&]<class Layer>() {
     using layer_t = std::remove_cvref_t<Layer>;
-    typename layer_t::forward_type output{};
-    typename layer_t::delta_type delta{};
+    using real_type = typename layer_t::real_type;
 
-    should("same result on each policy") = [&]<class Policy>() {
-      [[maybe_unused]] auto result =
-          layer_t::template backward<Policy{}>(output, delta);
+    should("apply the mask of forward") = [&]<class Policy>() {
+      utility::philox philox{5};
+      const auto mask = layer_t::make_mask(philox);
+      typename layer_t::input_type input{};
+      typename layer_t::delta_type delta{};
+      delta.fill(real_type{1});
+
+      const auto output = layer_t::template forward<Policy{}>(input, mask);
+      const auto result =
+          layer_t::template backward<Policy{}>(mask, delta);
+      for (std::size_t i = 0; i < layer_t::output_size; ++i) {
+        expect(eq(output[i], real_type{}));
+        expect(eq(result[i], mask[i] ? real_type{2} : real_type{}));
+      }
     } | policies;
   } | test_target_t{};
-
 }
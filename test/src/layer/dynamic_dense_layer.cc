@@ -0,0 +1,191 @@
+#include "ami/layer/dynamic_dense_layer.hpp"
+
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <execution>
+#include <limits>
+#include <memory>
+#include <span>
+#include <tuple>
+#include <vector>
+
+#include <boost/ut.hpp>
+
+#include "ami/layer/dense_layer.hpp"
+#include "ami/utility/aligned_allocator.hpp"
+
+constexpr auto optimizer = [](auto& x, auto y) {
+  x += y;
+};
+
+using optimizer_t = std::remove_cvref_t<decltype(optimizer)>;
+
+// A static layer and a dynamic one of the same shape and parameters.
+template <std::floating_point RealType, std::size_t InputSize,
+          std::size_t OutputSize, ami::row_padding Padding>
+auto make_test_layers() {
+  using static_t = ami::dense_layer_t<RealType, InputSize, OutputSize, Padding>;
+  auto fixed = std::make_unique<static_t>();
+  ami::dynamic_dense_layer<RealType, Padding> dynamic{InputSize, OutputSize};
+  for (std::size_t i = 0; i < OutputSize; ++i) {
+    for (std::size_t j = 0; j < InputSize; ++j) {
+      const auto w = static_cast<RealType>(static_cast<int>((i * 7 + j) % 11)
+          - 5) / 4;
+      fixed->weights(i)[j] = w;
+      dynamic.weights(i)[j] = w;
+    }
+    fixed->biases()[i] = static_cast<RealType>(i);
+    dynamic.biases()[i] = static_cast<RealType>(i);
+  }
+  return std::pair{std::move(fixed), std::move(dynamic)};
+}
+
+template <class T, std::size_t N>
+bool close(std::span<const T> actual, const std::array<T, N>& expected) {
+  bool result = actual.size() >= N;
+  for (std::size_t i = 0; result && i < N; ++i) {
+    result = std::abs(actual[i] - expected[i]) <=
+        64 * std::numeric_limits<T>::epsilon() * (std::abs(expected[i]) + 1);
+  }
+  return result;
+}
+
+template <std::floating_point RealType, std::size_t InputSize,
+          std::size_t OutputSize, ami::row_padding Padding,
+          ami::execution_policy auto P>
+void check() {
+  using namespace boost::ut;
+  auto [fixed, dynamic] =
+      make_test_layers<RealType, InputSize, OutputSize, Padding>();
+  using static_t = std::remove_cvref_t<decltype(*fixed)>;
+
+  expect(eq(dynamic.input_size(), InputSize));
+  expect(eq(dynamic.output_size(), OutputSize));
+  expect(eq(dynamic.leading_dimension(), static_t::leading_dimension));
+  expect(eq(dynamic.parameter_size(), static_t::parameter_size));
+  expect(eq(reinterpret_cast<std::uintptr_t>(dynamic.weights().data()) % 64,
+      std::uintptr_t{}));
+
+  constexpr std::size_t batch = 3;
+  std::vector<typename static_t::input_type> input(batch);
+  std::vector<typename static_t::delta_type> delta(batch);
+  std::vector<RealType> flat_input, flat_delta;
+  for (std::size_t b = 0; b < batch; ++b) {
+    for (std::size_t j = 0; j < InputSize; ++j) {
+      input[b][j] = static_cast<RealType>(b + 1) / static_cast<RealType>(j + 2);
+      flat_input.push_back(input[b][j]);
+    }
+    for (std::size_t i = 0; i < OutputSize; ++i) {
+      delta[b][i] = static_cast<RealType>(i % 3) - static_cast<RealType>(b);
+      flat_delta.push_back(delta[b][i]);
+    }
+  }
+
+  should("forward") = [&] {
+    const auto actual = dynamic.template forward<P>(
+        std::span{flat_input}.first(InputSize));
+    expect(eq(actual.size(), OutputSize));
+    expect(close<RealType>(actual, fixed->template forward<P>(input[0])));
+
+    const auto scaled = [](std::size_t, RealType y) { return 2 * y; };
+    std::vector<RealType> result(OutputSize);
+    dynamic.template forward<P>(
+        std::span{flat_input}.first(InputSize), result, scaled);
+    auto expected = fixed->template forward<P>(input[0]);
+    for (auto& y : expected) {
+      y *= 2;
+    }
+    expect(close<RealType>(result, expected));
+  };
+
+  should("forward batch") = [&] {
+    const auto actual = dynamic.template forward<P>(flat_input);
+    expect(eq(actual.size(), batch * OutputSize));
+    for (std::size_t b = 0; b < batch; ++b) {
+      expect(close<RealType>(std::span{actual}.subspan(b * OutputSize),
+          fixed->template forward<P>(input[b]))) << b;
+    }
+  };
+
+  should("backward") = [&] {
+    const auto actual = dynamic.template backward<P>(flat_delta);
+    expect(eq(actual.size(), batch * InputSize));
+    for (std::size_t b = 0; b < batch; ++b) {
+      expect(close<RealType>(std::span{actual}.subspan(b * InputSize),
+          fixed->template backward<P>(delta[b]))) << b;
+    }
+  };
+
+  should("calc_gradient and update") = [&] {
+    auto gradient = dynamic.make_gradient();
+    dynamic.template calc_gradient<P>(flat_input, flat_delta, gradient);
+    auto expected = std::make_unique<typename static_t::gradient_type>();
+    static_t::template calc_gradient<P>(
+        std::span<const typename static_t::input_type>{input},
+        std::span<const typename static_t::delta_type>{delta}, *expected);
+    for (std::size_t i = 0; i < OutputSize; ++i) {
+      expect(close<RealType>(
+          std::span{gradient.first}.subspan(i * InputSize),
+          expected->first[i])) << i;
+    }
+    expect(close<RealType>(gradient.second, expected->second));
+
+    auto single = dynamic.make_gradient();
+    dynamic.template calc_gradient<P>(std::span{flat_input}.first(InputSize),
+        std::span{flat_delta}.first(OutputSize), single);
+    expect(eq(single.second[0], flat_delta[0]));
+
+    auto optimizers = dynamic.template make_optimizer<optimizer_t>();
+    dynamic.template update<P>(optimizers, gradient);
+    auto fixed_optimizers = std::make_unique<
+        typename static_t::template optimizer_type<optimizer_t>>();
+    fixed->template update<P>(*fixed_optimizers, *expected);
+    for (std::size_t i = 0; i < OutputSize; ++i) {
+      const auto row = fixed->weights(i);
+      std::array<RealType, InputSize> w{};
+      std::ranges::copy(row, w.begin());
+      expect(close<RealType>(dynamic.weights(i), w)) << i;
+    }
+    std::array<RealType, OutputSize> b{};
+    std::ranges::copy(fixed->biases(), b.begin());
+    expect(close<RealType>(dynamic.biases(), b));
+  };
+}
+
+int main() {
+  using namespace boost::ut;
+  using ami::row_padding;
+
+  "aligned_allocator"_test = [] {
+    std::vector<double, ami::utility::aligned_allocator<double>> v(3);
+    for (int i = 0; i < 4; ++i) {
+      v.push_back(1);
+      expect(eq(reinterpret_cast<std::uintptr_t>(v.data()) % 64,
+          std::uintptr_t{}));
+    }
+    expect(ami::utility::aligned_allocator<float>{} ==
+        ami::utility::aligned_allocator<double>{});
+  };
+
+  "dynamic_dense_layer"_test = []<class RealType>(RealType) {
+    check<RealType, 5, 3, row_padding::none, std::execution::seq>();
+    check<RealType, 5, 3, row_padding::cache_line, std::execution::seq>();
+    check<RealType, 70, 40, row_padding::none, std::execution::par>();
+    check<RealType, 33, 130, row_padding::cache_line,
+          std::execution::par_unseq>();
+    check<RealType, 33, 130, row_padding::none, ami::execution::adaptive>();
+  } | std::tuple<float, double>{};
+
+  "heap storage"_test = [] {
+    // 128 MiB of weights, which no stack would hold.
+    ami::dynamic_dense_layer<double> layer{4096, 4096};
+    std::ranges::fill(layer.biases(), 1.0);
+    layer.weights(4095)[4095] = 2;
+    std::vector<double> input(4096, 0);
+    input[4095] = 1;
+    const auto output = layer.forward(input);
+    expect(eq(output[0], 1.0) and eq(output[4095], 3.0));
+  };
+}
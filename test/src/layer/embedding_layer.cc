@@ -0,0 +1,307 @@
+#include "ami/layer/embedding_layer.hpp"
+
+#include <array>
+#include <cmath>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <execution>
+#include <filesystem>
+#include <fstream>
+#include <limits>
+#include <memory>
+#include <span>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+
+#include <boost/ut.hpp>
+
+#include "ami/concepts/layer.hpp"
+#include "ami/layer/dense_layer.hpp"
+#include "ami/model/sequential.hpp"
+#include "ami/optimizer/adam.hpp"
+#include "ami/optimizer/fused_adam.hpp"
+#include "ami/utility/mapped_file.hpp"
+
+constexpr auto optimizer = [](auto& x, auto y) {
+  x += y;
+};
+
+using optimizer_t = std::remove_cvref_t<decltype(optimizer)>;
+
+// Row r holds r * 10 + d, so every lookup is recognisable.
+template <class Layer>
+Layer make_test_layer(std::size_t vocabulary_size) {
+  using real_t = typename Layer::real_type;
+  Layer layer{vocabulary_size};
+  for (std::size_t r = 0; r < vocabulary_size; ++r) {
+    for (std::size_t d = 0; d < Layer::dimension; ++d) {
+      layer.row(r)[d] = static_cast<real_t>(r * 10 + d);
+    }
+  }
+  return layer;
+}
+
+template <class Layer>
+auto make_test_batch() {
+  using real_t = typename Layer::real_type;
+  // Row 2 is looked up three times, twice by one sample.
+  std::vector<typename Layer::input_type> input{{2, 0, 5}, {7, 2, 2}};
+  std::vector<typename Layer::delta_type> delta(input.size());
+  for (std::size_t b = 0; b < delta.size(); ++b) {
+    for (std::size_t i = 0; i < Layer::output_size; ++i) {
+      delta[b][i] = static_cast<real_t>(i + b) - 4;
+    }
+  }
+  return std::pair{std::move(input), std::move(delta)};
+}
+
+// The table a dense update with every delta scattered into its row would
+// give.
+template <class Layer>
+auto scatter(const Layer& layer,
+             const std::vector<typename Layer::input_type>& input,
+             const std::vector<typename Layer::delta_type>& delta) {
+  std::vector<typename Layer::real_type> result(
+      layer.vocabulary_size() * Layer::dimension);
+  for (std::size_t b = 0; b < input.size(); ++b) {
+    for (std::size_t k = 0; k < Layer::input_size; ++k) {
+      for (std::size_t d = 0; d < Layer::dimension; ++d) {
+        result[input[b][k] * Layer::dimension + d] +=
+            delta[b][k * Layer::dimension + d];
+      }
+    }
+  }
+  return result;
+}
+
+int main() {
+  using namespace boost::ut;
+  using namespace ami;
+  using namespace std::execution;
+
+  constexpr std::tuple policies{
+      seq, par, par_unseq, unseq, ami::execution::adaptive,
+      ami::execution::pool};
+
+  using target_t = std::tuple<embedding_layer_t<float, 3, 4>,
+                              embedding_layer_t<double, 3, 4>,
+                              embedding_layer_t<float, 3, 33>>;
+
+  "type check"_test = [] {
+    using layer_t = embedding_layer_t<float, 3, 4>;
+    static_assert(trainable_layer<layer_t>);
+    static_assert(layer_t::input_size == 3);
+    static_assert(layer_t::output_size == 12);
+    static_assert(std::same_as<
+        layer_t::input_type, std::array<std::uint32_t, 3>>);
+    static_assert(std::same_as<layer_t::forward_type, std::array<float, 12>>);
+    static_assert(std::same_as<
+        layer_t::optimizer_type<optimizer_t>, std::vector<optimizer_t>>);
+    static_assert(std::same_as<layer_t::optimizer_type<fused_adam<>>,
+        fused_adam_t<float, std::dynamic_extent>>);
+  };
+
+  "forward"_test = [&]<class Layer> {
+    using layer_t = std::remove_cvref_t<Layer>;
+    const auto layer = make_test_layer<layer_t>(9);
+    const auto [input, delta] = make_test_batch<layer_t>();
+
+    should("gather the rows") = [&]<class Policy> {
+      for (const auto& x : input) {
+        const auto result = layer.template forward<Policy{}>(x);
+        for (std::size_t k = 0; k < layer_t::input_size; ++k) {
+          for (std::size_t d = 0; d < layer_t::dimension; ++d) {
+            expect(eq(result[k * layer_t::dimension + d],
+                layer.row(x[k])[d]));
+          }
+        }
+      }
+    } | policies;
+
+    should("same result as per sample forward") = [&]<class Policy> {
+      std::vector<typename layer_t::forward_type> result(input.size());
+      layer.template forward<Policy{}>(std::span{input}, std::span{result});
+      for (std::size_t b = 0; b < input.size(); ++b) {
+        expect(result[b] == layer.forward(input[b]));
+      }
+    } | policies;
+  } | target_t{};
+
+  "view"_test = [] {
+    using layer_t = embedding_layer_t<float, 3, 4>;
+    const auto owned = make_test_layer<layer_t>(9);
+    const auto [input, delta] = make_test_batch<layer_t>();
+
+    const auto path = std::filesystem::temp_directory_path() /
+        "ami_embedding_layer_test.bin";
+    {
+      std::ofstream file{path, std::ios::binary};
+      const auto table = owned.table();
+      file.write(reinterpret_cast<const char*>(table.data()),
+          static_cast<std::streamsize>(table.size_bytes()));
+    }
+    {
+      const utility::mapped_file file{path};
+      const layer_t mapped{std::span{
+          reinterpret_cast<const float*>(file.data()),
+          file.size() / sizeof(float)}};
+      expect(eq(mapped.vocabulary_size(), owned.vocabulary_size()));
+      for (const auto& x : input) {
+        expect(mapped.forward(x) == owned.forward(x));
+      }
+    }
+    std::filesystem::remove(path);
+  };
+
+  "calc_gradient"_test = [&]<class Layer> {
+    using layer_t = std::remove_cvref_t<Layer>;
+    const auto [input, delta] = make_test_batch<layer_t>();
+
+    typename layer_t::gradient_type expected{};
+    for (std::size_t b = 0; b < input.size(); ++b) {
+      layer_t::calc_gradient(input[b], delta[b], expected);
+    }
+    expect(expected.rows == std::vector<std::uint32_t>{2, 0, 5, 7, 2, 2});
+    expect(eq(expected.values.size(), 2 * layer_t::output_size));
+    for (std::size_t b = 0; b < input.size(); ++b) {
+      for (std::size_t i = 0; i < layer_t::output_size; ++i) {
+        expect(eq(expected.values[b * layer_t::output_size + i],
+            delta[b][i]));
+      }
+    }
+
+    should("same result as accumulated per sample gradient") =
+        [&]<class Policy> {
+      typename layer_t::gradient_type result{};
+      layer_t::template calc_gradient<Policy{}>(
+          std::span{input}, std::span{delta}, result);
+      expect(result == expected);
+    } | policies;
+  } | target_t{};
+
+  "update"_test = [&]<class Layer> {
+    using layer_t = std::remove_cvref_t<Layer>;
+    using real_t = typename layer_t::real_type;
+    const auto [input, delta] = make_test_batch<layer_t>();
+    typename layer_t::gradient_type gradient{};
+    layer_t::calc_gradient(std::span{input}, std::span{delta}, gradient);
+    const auto original = make_test_layer<layer_t>(9);
+    const auto scattered = scatter(original, input, delta);
+
+    should("add the summed deltas to the rows seen") = [&]<class Policy> {
+      auto layer = original;
+      auto optimizers = layer.template make_optimizer<optimizer_t>();
+      expect(eq(optimizers.size(), 9 * layer_t::dimension));
+      layer.template update<Policy{}>(optimizers, gradient);
+      const auto table = layer.table();
+      for (std::size_t i = 0; i < table.size(); ++i) {
+        expect(eq(table[i], original.table()[i] + scattered[i]));
+      }
+    } | policies;
+
+    should("step each row seen once") = [&]<class Policy> {
+      auto layer = original;
+      auto optimizers = layer.template make_optimizer<adam_t<real_t>>();
+      layer.template update<Policy{}>(optimizers, gradient);
+
+      std::vector<adam_t<real_t>> reference(scattered.size());
+      constexpr std::array<std::size_t, 4> seen{0, 2, 5, 7};
+      auto expected = original;
+      for (const auto r : seen) {
+        for (std::size_t d = 0; d < layer_t::dimension; ++d) {
+          const auto i = r * layer_t::dimension + d;
+          reference[i](expected.table()[i], scattered[i]);
+        }
+      }
+      expect(std::ranges::equal(layer.table(), expected.table()));
+    } | policies;
+
+    should("step fused adam lazily") = [&]<class Policy> {
+      // Rows 0 and 5 only in the first step, 7 only in the second, 2 in
+      // both; the other rows never.
+      typename layer_t::gradient_type first{};
+      layer_t::calc_gradient(input[0], delta[0], first);
+      typename layer_t::gradient_type second{};
+      layer_t::calc_gradient(input[1], delta[1], second);
+
+      auto layer = original;
+      auto optimizer = layer.template make_optimizer<fused_adam<>>();
+      layer.template update<Policy{}>(optimizer, first);
+      const auto after_first = layer;
+      layer.template update<Policy{}>(optimizer, second);
+
+      // Full steps over the whole table with the scattered gradients.
+      auto dense = original;
+      fused_adam_t<real_t, std::dynamic_extent> reference{
+          9 * layer_t::dimension};
+      const auto dense_first = scatter(original,
+          std::vector{input[0]}, std::vector{delta[0]});
+      const auto dense_second = scatter(original,
+          std::vector{input[1]}, std::vector{delta[1]});
+      reference(dense.table(), std::span<const real_t>{dense_first});
+      reference(dense.table(), std::span<const real_t>{dense_second});
+
+      constexpr auto eps = std::numeric_limits<real_t>::epsilon();
+      for (std::size_t r = 0; r < 9; ++r) {
+        for (std::size_t d = 0; d < layer_t::dimension; ++d) {
+          const auto actual = layer.row(r)[d];
+          if (r == 0 || r == 5) {
+            // Left alone while its moments would still move it.
+            expect(eq(actual, after_first.row(r)[d]));
+            if (dense_first[r * layer_t::dimension + d] != 0) {
+              expect(actual != dense.row(r)[d]);
+            }
+          } else {
+            expect(le(std::abs(actual - dense.row(r)[d]),
+                16 * eps * std::abs(dense.row(r)[d]) + eps));
+          }
+        }
+      }
+    } | policies;
+  } | target_t{};
+
+  "sequential"_test = [] {
+    using model_t = sequential_t<float, 3, embedding_layer<4>,
+        dense_layer<2>>;
+    using embedding_t = embedding_layer_t<float, 3, 4>;
+    static_assert(std::same_as<
+        std::tuple_element_t<0, model_t::layers_type>, embedding_t>);
+    static_assert(std::same_as<
+        model_t::input_type, std::array<std::uint32_t, 3>>);
+
+    auto model = std::make_unique<model_t>();
+    auto& [embedding, dense] = model->layers();
+    embedding = make_test_layer<embedding_t>(9);
+    for (std::size_t i = 0; i < 2; ++i) {
+      for (std::size_t j = 0; j < 12; ++j) {
+        dense.weights(i)[j] = static_cast<float>(i + j) / 8;
+      }
+    }
+
+    const model_t::input_type input{4, 1, 4};
+    const auto hidden = embedding.forward(input);
+    expect(model->forward(input) == dense.forward(hidden));
+
+    const model_t::delta_type delta{1, -2};
+    model_t::gradient_type gradient{};
+    model->backward(delta, gradient);
+    const auto& rows = std::get<0>(gradient);
+    expect(rows.rows == std::vector<std::uint32_t>{4, 1, 4});
+    const auto expected = dense.backward(delta);
+    expect(std::ranges::equal(rows.values, expected));
+
+    auto optimizers = std::make_unique<
+        model_t::optimizer_type<optimizer_t>>();
+    std::get<0>(*optimizers) = embedding.make_optimizer<optimizer_t>();
+    const auto before = embedding;
+    model->update(*optimizers, gradient);
+    for (std::size_t d = 0; d < 4; ++d) {
+      expect(eq(embedding.row(4)[d],
+          before.row(4)[d] + expected[d] + expected[8 + d]));
+      expect(eq(embedding.row(1)[d], before.row(1)[d] + expected[4 + d]));
+      expect(eq(embedding.row(0)[d], before.row(0)[d]));
+    }
+  };
+}
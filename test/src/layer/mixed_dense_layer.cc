@@ -0,0 +1,317 @@
+#include "ami/layer/mixed_dense_layer.hpp"
+
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <execution>
+#include <limits>
+#include <memory>
+#include <span>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <boost/ut.hpp>
+
+#include "ami/activation/tanh.hpp"
+#include "ami/layer/activation_layer.hpp"
+#include "ami/layer/dense_layer.hpp"
+#include "ami/model/parameters.hpp"
+#include "ami/model/sequential.hpp"
+#include "ami/optimizer/fused_adam.hpp"
+#include "ami/optimizer/loss_scaler.hpp"
+#include "ami/utility/half_precision.hpp"
+
+constexpr auto optimizer = [](auto& x, auto y) {
+  x += y;
+};
+
+using optimizer_t = std::remove_cvref_t<decltype(optimizer)>;
+
+// Small integers are exact in 16 bits, so the mixed layer must match a
+// dense layer with the same weights bit for bit.
+template <class Layer>
+auto make_test_value() {
+  using layer_t = std::remove_cvref_t<Layer>;
+  using real_t = typename layer_t::real_type;
+  auto value = std::make_unique<typename layer_t::value_type>();
+  for (std::size_t i = 0; i < layer_t::output_size; ++i) {
+    for (std::size_t j = 0; j < layer_t::input_size; ++j) {
+      value->first[i][j] = static_cast<real_t>((i * 7 + j * 3) % 5) - 2;
+    }
+    value->second[i] = static_cast<real_t>(i % 3);
+  }
+  return value;
+}
+
+template <class Layer>
+auto make_test_batch(std::size_t batch_size) {
+  using layer_t = std::remove_cvref_t<Layer>;
+  using real_t = typename layer_t::real_type;
+  std::vector<typename layer_t::input_type> input(batch_size);
+  std::vector<typename layer_t::delta_type> delta(batch_size);
+  for (std::size_t b = 0; b < batch_size; ++b) {
+    for (std::size_t j = 0; j < layer_t::input_size; ++j) {
+      input[b][j] = static_cast<real_t>((b + j) % 4) - 1;
+    }
+    for (std::size_t i = 0; i < layer_t::output_size; ++i) {
+      delta[b][i] = static_cast<real_t>((i + 2 * b) % 3) - 1;
+    }
+  }
+  return std::pair{std::move(input), std::move(delta)};
+}
+
+template <class Storage, ami::row_padding Padding, std::size_t InputSize,
+          std::size_t OutputSize, ami::execution_policy auto P>
+void check() {
+  using namespace boost::ut;
+  using mixed_t = ami::mixed_dense_layer_t<float, InputSize, OutputSize,
+      Storage, Padding>;
+  using dense_t = ami::dense_layer_t<float, InputSize, OutputSize, Padding>;
+
+  const auto value = make_test_value<mixed_t>();
+  const auto mixed = std::make_unique<mixed_t>(*value);
+  const auto dense = std::make_unique<dense_t>(*value);
+  const auto [input, delta] = make_test_batch<mixed_t>(5);
+
+  should("forward") = [&] {
+    expect(mixed->template forward<P>(input[1]) ==
+        dense->template forward<P>(input[1]));
+
+    const auto twice = [](std::size_t, float y) { return 2 * y; };
+    typename mixed_t::forward_type actual{}, expected{};
+    mixed->template forward<P>(input[2], actual, twice);
+    dense->template forward<P>(input[2], expected, twice);
+    expect(actual == expected);
+  };
+
+  should("forward batch") = [&] {
+    std::vector<typename mixed_t::forward_type> expected(input.size());
+    dense->template forward<P>(
+        std::span<const typename dense_t::input_type>{input},
+        std::span{expected});
+
+    std::vector<typename mixed_t::forward_type> actual(input.size());
+    mixed->template forward<P>(
+        std::span<const typename mixed_t::input_type>{input},
+        std::span{actual});
+    expect(actual == expected);
+
+    // The same batch stored in 16 bits.
+    std::vector<typename mixed_t::storage_input_type> stored(input.size());
+    for (std::size_t b = 0; b < input.size(); ++b) {
+      ami::kernel::convert(InputSize, input[b].data(), stored[b].data());
+    }
+    std::vector<typename mixed_t::forward_type> from_stored(input.size());
+    mixed->template forward<P>(
+        std::span<const typename mixed_t::storage_input_type>{stored},
+        std::span{from_stored});
+    expect(from_stored == expected);
+
+    auto gradient = std::make_unique<typename mixed_t::gradient_type>();
+    auto expected_gradient =
+        std::make_unique<typename mixed_t::gradient_type>();
+    mixed_t::template calc_gradient<P>(
+        std::span<const typename mixed_t::storage_input_type>{stored},
+        std::span<const typename mixed_t::delta_type>{delta}, *gradient);
+    dense_t::template calc_gradient<P>(
+        std::span<const typename dense_t::input_type>{input},
+        std::span<const typename dense_t::delta_type>{delta},
+        *expected_gradient);
+    expect(*gradient == *expected_gradient);
+  };
+
+  should("backward") = [&] {
+    expect(mixed->template backward<P>(delta[0]) ==
+        dense->template backward<P>(delta[0]));
+
+    std::vector<typename mixed_t::backward_type> expected(delta.size());
+    dense->template backward<P>(
+        std::span<const typename dense_t::delta_type>{delta},
+        std::span{expected});
+    std::vector<typename mixed_t::backward_type> actual(delta.size());
+    mixed->template backward<P>(
+        std::span<const typename mixed_t::delta_type>{delta},
+        std::span{actual});
+    expect(actual == expected);
+  };
+
+  should("node_view") = [&] {
+    for (std::size_t i = 0; i < OutputSize; i += 7) {
+      expect(eq(mixed->node_view(i).template forward<P>(input[0]),
+          dense->forward(input[0])[i] - dense->biases()[i])) << i;
+    }
+  };
+}
+
+int main() {
+  using namespace boost::ut;
+  using ami::bfloat16;
+  using ami::float16;
+  using ami::row_padding;
+
+  "type_check"_test = [] {
+    using mixed_t = ami::mixed_dense_layer_t<float, 5, 3>;
+    using dense_t = ami::dense_layer_t<float, 5, 3>;
+    static_assert(std::same_as<mixed_t::storage_type, bfloat16>);
+    static_assert(std::same_as<mixed_t::gradient_type,
+        dense_t::gradient_type>);
+    static_assert(std::same_as<mixed_t::optimizer_type<optimizer_t>,
+        dense_t::optimizer_type<optimizer_t>>);
+    static_assert(ami::trainable_layer<mixed_t>);
+    static_assert(ami::detail::dense_parameters<mixed_t>);
+    static_assert(sizeof(ami::mixed_dense_layer_t<float, 64, 64>::working_type)
+        == sizeof(ami::weight_matrix<float, 64, 64>) / 2);
+  };
+
+  "mixed_dense_layer"_test = [] {
+    check<bfloat16, row_padding::none, 5, 3, std::execution::seq>();
+    check<float16, row_padding::none, 5, 3, std::execution::seq>();
+    check<bfloat16, row_padding::cache_line, 33, 70, std::execution::par>();
+    check<float16, row_padding::none, 300, 40, ami::execution::adaptive>();
+    check<bfloat16, row_padding::none, 70, 300, std::execution::par_unseq>();
+  };
+
+  "master weights"_test = [] {
+    using layer_t = ami::mixed_dense_layer_t<float, 4, 2>;
+    layer_t layer{};
+    for (std::size_t i = 0; i < 2; ++i) {
+      std::ranges::fill(layer.weights(i), 1.0f);
+    }
+    layer.synchronize();
+    expect(eq(static_cast<float>(layer.working_weights()[0]), 1.0f));
+
+    // Each step is far below a bfloat16 ulp at 1 (2^-7), so a 16 bit
+    // weight would never move; the master copy accumulates them.
+    typename layer_t::gradient_type gradient{};
+    for (auto& row : gradient.first) {
+      row.fill(1e-4f);
+    }
+    typename layer_t::optimizer_type<optimizer_t> optimizers{};
+    for (int step = 0; step < 100; ++step) {
+      layer.update(optimizers, gradient);
+    }
+    expect(std::abs(layer.weights(0)[0] - 1.01f) < 1e-5f);
+    expect(eq(static_cast<float>(layer.working_weights()[0]),
+        static_cast<float>(bfloat16{layer.weights(0)[0]})));
+    expect(eq(static_cast<float>(layer.working_weights()[0]),
+        1.0f + 0x1p-7f));
+  };
+
+  "fused_adam"_test = [] {
+    using mixed_t = ami::mixed_dense_layer_t<float, 6, 4>;
+    using dense_t = ami::dense_layer_t<float, 6, 4>;
+    const auto value = make_test_value<mixed_t>();
+    mixed_t mixed{*value};
+    dense_t dense{*value};
+    const auto [input, delta] = make_test_batch<mixed_t>(1);
+
+    typename mixed_t::gradient_type gradient{};
+    mixed_t::calc_gradient(input[0], delta[0], gradient);
+    typename mixed_t::optimizer_type<ami::fused_adam<>> adam{};
+    typename dense_t::optimizer_type<ami::fused_adam<>> dense_adam{};
+    mixed.update(adam, gradient);
+    dense.update(dense_adam, gradient);
+    expect(mixed.value() == dense.value());
+  };
+
+  "loss scaling"_test = [] {
+    using layer_t = ami::mixed_dense_layer_t<float, 6, 4, float16>;
+    const auto value = make_test_value<layer_t>();
+    const auto [input, delta] = make_test_batch<layer_t>(3);
+
+    layer_t reference{*value};
+    typename layer_t::gradient_type reference_gradient{};
+    layer_t::calc_gradient(std::span{input}, std::span{delta},
+        reference_gradient);
+    auto reference_adam = layer_t::optimizer_type<ami::fused_adam<>>{};
+    reference.update(reference_adam, reference_gradient);
+
+    should("update as an unscaled step") = [&] {
+      layer_t layer{*value};
+      ami::loss_scaler<float, 2> scaler{1024.0f};
+      auto scaled = delta;
+      for (auto& d : scaled) {
+        for (auto& x : d) {
+          x *= scaler.scale();
+        }
+      }
+      typename layer_t::gradient_type gradient{};
+      layer_t::calc_gradient(std::span{input}, std::span{scaled}, gradient);
+
+      const auto finite = scaler.unscale(gradient);
+      expect(finite);
+      expect(gradient == reference_gradient);
+      auto adam = layer_t::optimizer_type<ami::fused_adam<>>{};
+      layer.update(adam, gradient);
+      scaler.update(finite);
+      expect(layer.value() == reference.value());
+    };
+
+    should("skip a step that overflows") = [&] {
+      layer_t layer{*value};
+      ami::loss_scaler<float, 2> scaler{
+          std::numeric_limits<float>::max()};
+      auto scaled = delta;
+      for (auto& d : scaled) {
+        for (auto& x : d) {
+          x *= scaler.scale();
+        }
+      }
+      typename layer_t::gradient_type gradient{};
+      layer_t::calc_gradient(std::span{input}, std::span{scaled}, gradient);
+
+      const auto finite = scaler.unscale(gradient);
+      expect(!finite);
+      scaler.update(finite);
+      expect(eq(scaler.scale(), std::numeric_limits<float>::max() / 2));
+      expect(layer.value() == layer_t{*value}.value());
+    };
+  };
+
+  "sequential"_test = [] {
+    using model_t = ami::sequential_t<float, 8, ami::mixed_dense_layer<16>,
+        ami::activation_layer<ami::tanh<>>, ami::mixed_dense_layer<2, float16>>;
+    using reference_t = ami::sequential_t<float, 8, ami::dense_layer<16>,
+        ami::activation_layer<ami::tanh<>>, ami::dense_layer<2>>;
+    static_assert(ami::parameter_size<model_t> ==
+        ami::parameter_size<reference_t>);
+
+    model_t model{};
+    reference_t reference{};
+    auto& [first, activation, second] = model.layers();
+    auto& [reference_first, reference_activation, reference_second] =
+        reference.layers();
+    for (std::size_t i = 0; i < 16; ++i) {
+      for (std::size_t j = 0; j < 8; ++j) {
+        first.weights(i)[j] = static_cast<float>((i + j) % 3) - 1;
+        reference_first.weights(i)[j] = first.weights(i)[j];
+      }
+    }
+    for (std::size_t i = 0; i < 2; ++i) {
+      for (std::size_t j = 0; j < 16; ++j) {
+        second.weights(i)[j] = static_cast<float>((i * 3 + j) % 4) / 4;
+        reference_second.weights(i)[j] = second.weights(i)[j];
+      }
+    }
+    first.synchronize();
+    second.synchronize();
+
+    std::array<float, 8> input{};
+    for (std::size_t j = 0; j < 8; ++j) {
+      input[j] = static_cast<float>(j) / 8 - 0.5f;
+    }
+    expect(model.forward(input) == reference.forward(input));
+
+    typename model_t::gradient_type gradient{};
+    typename reference_t::gradient_type reference_gradient{};
+    model.backward({1.0f, -1.0f}, gradient);
+    reference.backward({1.0f, -1.0f}, reference_gradient);
+    expect(gradient == reference_gradient);
+
+    auto optimizers = model_t::optimizer_type<ami::fused_adam<>>{};
+    model.update(optimizers, gradient);
+    expect(first.weights(0)[0] != -1.0f);
+  };
+}
@@ -0,0 +1,194 @@
+#include "ami/layer/quantized_dense_layer.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <execution>
+#include <memory>
+#include <random>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+
+#include <boost/ut.hpp>
+
+#include "ami/activation/relu.hpp"
+#include "ami/layer/dense_layer.hpp"
+#include "ami/utility/quantization.hpp"
+
+template <class Layer>
+auto make_random_value(std::mt19937& engine) {
+  using layer_t = std::remove_cvref_t<Layer>;
+  using real_t = typename layer_t::real_type;
+  std::uniform_real_distribution<real_t> dist{-1, 1};
+  auto value = std::make_unique<typename layer_t::value_type>();
+  for (auto& row : value->first) {
+    for (auto& w : row) {
+      w = dist(engine);
+    }
+  }
+  for (auto& b : value->second) {
+    b = dist(engine);
+  }
+  return value;
+}
+
+template <class Input>
+std::vector<Input> make_samples(std::size_t size, std::mt19937& engine) {
+  using real_t = typename Input::value_type;
+  std::uniform_real_distribution<real_t> dist{-0.5, 2};
+  std::vector<Input> result(size);
+  for (auto& sample : result) {
+    for (auto& x : sample) {
+      x = dist(engine);
+    }
+  }
+  return result;
+}
+
+int main() {
+  using namespace boost::ut;
+
+  "type_check"_test = [] {
+    using layer_t = ami::quantized_dense_layer_t<float, 10, 3>;
+    using dense_t = ami::dense_layer_t<float, 10, 3>;
+    static_assert(std::same_as<layer_t::value_type, dense_t::value_type>);
+    static_assert(std::same_as<layer_t::input_type, dense_t::input_type>);
+    static_assert(std::same_as<layer_t::forward_type, dense_t::forward_type>);
+    static_assert(std::same_as<layer_t::quantized_input_type,
+        std::array<std::uint8_t, 10>>);
+    static_assert(layer_t::leading_dimension == 64);
+
+    // A quarter of the weight memory of float.
+    using large_t = ami::quantized_dense_layer_t<float, 256, 256>;
+    static_assert(sizeof(large_t) * 3 <
+        sizeof(ami::dense_layer_t<float, 256, 256>));
+  };
+
+  "forward"_test = []<class RealType> {
+    using layer_t = ami::quantized_dense_layer_t<RealType, 300, 40>;
+    using dense_t = ami::dense_layer_t<RealType, 300, 40>;
+    using input_t = typename layer_t::input_type;
+
+    std::mt19937 engine{42};
+    const auto value = make_random_value<layer_t>(engine);
+    const auto samples = make_samples<input_t>(16, engine);
+    ami::range_calibrator<RealType> calibrator;
+    for (const auto& sample : samples) {
+      calibrator.observe(sample);
+    }
+    const auto input_q = calibrator.make_quantization();
+    const auto layer = std::make_unique<layer_t>(*value, input_q);
+    const auto dense = std::make_unique<dense_t>(*value);
+
+    should("be exact on the dequantized operands") = [&] {
+      const auto dequantized = std::make_unique<dense_t>(layer->value());
+      for (const auto& x : samples) {
+        const auto q = layer->quantize(x);
+        input_t x_dq{};
+        for (std::size_t j = 0; j < x.size(); ++j) {
+          x_dq[j] = input_q.dequantize(q[j]);
+        }
+        const auto expected = dequantized->forward(x_dq);
+        const auto actual = layer->forward(x);
+        for (std::size_t i = 0; i < actual.size(); ++i) {
+          expect(le(std::abs(actual[i] - expected[i]),
+              RealType{1e-4} * (1 + std::abs(expected[i]))));
+        }
+      }
+    };
+
+    should("stay within the rounding of its operands") = [&] {
+      RealType worst{};
+      RealType largest{};
+      for (const auto& x : samples) {
+        const auto expected = dense->forward(x);
+        const auto actual = layer->forward(x);
+        for (std::size_t i = 0; i < actual.size(); ++i) {
+          // Each product is off by at most half a step of either operand.
+          RealType bound{};
+          const auto sw = layer->weight_quantization(i).scale;
+          for (std::size_t j = 0; j < x.size(); ++j) {
+            bound += std::abs(x[j]) * sw / 2 +
+                (std::abs(value->first[i][j]) + sw / 2) * input_q.scale / 2;
+          }
+          expect(le(std::abs(actual[i] - expected[i]), bound));
+          worst = std::max(worst, std::abs(actual[i] - expected[i]));
+          largest = std::max(largest, std::abs(expected[i]));
+        }
+      }
+      // The errors of the products mostly cancel.
+      expect(lt(worst, largest / 50));
+    };
+
+    should("fuse the activation and the quantization of the output") = [&] {
+      const auto output_q = ami::quantization<RealType>::template
+          from_range<std::uint8_t>(RealType{0}, RealType{8});
+      const auto relu = [](std::size_t, RealType z) {
+        return ami::relu::f(z);
+      };
+      for (const auto& x : samples) {
+        typename layer_t::quantized_forward_type fused{};
+        layer->forward(x, fused, output_q, relu);
+
+        typename layer_t::forward_type activated{};
+        layer->forward(x, activated, relu);
+        typename layer_t::quantized_forward_type fused_q{};
+        layer->forward(layer->quantize(x), fused_q, output_q, relu);
+        for (std::size_t i = 0; i < fused.size(); ++i) {
+          expect(eq(fused[i],
+              output_q.template quantize<std::uint8_t>(activated[i])));
+          expect(eq(fused_q[i], fused[i]));
+        }
+      }
+    };
+
+    should("not depend on the policy") = [&] {
+      std::vector<typename layer_t::forward_type> batch(samples.size());
+      layer->template forward<std::execution::par>(
+          std::span{samples}, std::span{batch});
+      for (std::size_t b = 0; b < samples.size(); ++b) {
+        const auto expected = layer->forward(samples[b]);
+        expect(batch[b] == expected);
+        expect(layer->template forward<std::execution::par>(samples[b]) ==
+            expected);
+      }
+    };
+
+    should("quantize a layer in place") = [&] {
+      const auto assigned = std::make_unique<layer_t>();
+      assigned->assign(*dense, input_q);
+      for (std::size_t i = 0; i < layer_t::output_size; ++i) {
+        expect(std::ranges::equal(assigned->weights(i), layer->weights(i)));
+        expect(eq(assigned->weight_quantization(i).scale,
+            layer->weight_quantization(i).scale));
+        expect(eq(assigned->weight_quantization(i).zero_point,
+            layer->weight_quantization(i).zero_point));
+      }
+      expect(std::ranges::equal(assigned->biases(), layer->biases()));
+      expect(assigned->forward(samples.front()) ==
+          layer->forward(samples.front()));
+    };
+  } | std::tuple<float, double>{};
+
+  "per row quantization"_test = [] {
+    // Rows of very different magnitude each keep their own resolution.
+    using layer_t = ami::quantized_dense_layer_t<float, 4, 2>;
+    const layer_t::value_type value{
+        {{{0.001f, -0.002f, 0.003f, 0.0f}, {100.0f, -50.0f, 25.0f, 0.0f}}},
+        {0.5f, -1.0f}};
+    const layer_t layer{value,
+        ami::quantization<float>::from_range<std::uint8_t>(0.0f, 4.0f)};
+    const auto dequantized = layer.value();
+    for (std::size_t i = 0; i < 2; ++i) {
+      for (std::size_t j = 0; j < 4; ++j) {
+        expect(le(std::abs(dequantized.first[i][j] - value.first[i][j]),
+            layer.weight_quantization(i).scale / 2 * 1.001f));
+      }
+      expect(eq(dequantized.second[i], value.second[i]));
+    }
+    expect(lt(layer.weight_quantization(0).scale, 1e-4f));
+  };
+}
@@ -0,0 +1,317 @@
+#include "ami/layer/sparse_dense_layer.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <execution>
+#include <memory>
+#include <random>
+#include <span>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+
+#include <boost/ut.hpp>
+
+#include "ami/activation/relu.hpp"
+#include "ami/layer/activation_layer.hpp"
+#include "ami/layer/dense_layer.hpp"
+#include "ami/model/sequential.hpp"
+#include "ami/optimizer/fused_adam.hpp"
+
+constexpr auto optimizer = [](auto& x, auto y) {
+  x += y;
+};
+
+using optimizer_t = std::remove_cvref_t<decltype(optimizer)>;
+
+template <class Layer>
+void fill(Layer& layer, std::mt19937& engine) {
+  using real_t = typename Layer::real_type;
+  std::uniform_real_distribution<real_t> dist{-1, 1};
+  for (std::size_t i = 0; i < Layer::output_size; ++i) {
+    for (auto& w : layer.weights(i)) {
+      w = dist(engine);
+    }
+  }
+  for (auto& b : layer.biases()) {
+    b = dist(engine);
+  }
+}
+
+template <class T>
+std::vector<T> make_samples(std::size_t size, std::mt19937& engine) {
+  using real_t = typename T::value_type;
+  std::uniform_real_distribution<real_t> dist{-1, 1};
+  std::vector<T> result(size);
+  for (auto& sample : result) {
+    for (auto& x : sample) {
+      x = dist(engine);
+    }
+  }
+  return result;
+}
+
+template <class T, std::size_t N>
+bool close(const std::array<T, N>& actual, const std::array<T, N>& expected) {
+  return std::ranges::equal(actual, expected, [](T a, T e) {
+        return std::abs(a - e) <= T{1e-4} * (1 + std::abs(e));
+      });
+}
+
+int main() {
+  using namespace boost::ut;
+
+  "type_check"_test = [] {
+    using layer_t = ami::sparse_dense_layer_t<float, 10, 3, 7>;
+    using dense_t = ami::dense_layer_t<float, 10, 3>;
+    static_assert(std::same_as<layer_t::value_type, dense_t::value_type>);
+    static_assert(std::same_as<layer_t::input_type, dense_t::input_type>);
+    static_assert(std::same_as<layer_t::forward_type, dense_t::forward_type>);
+    static_assert(std::same_as<layer_t::gradient_type,
+        std::pair<std::array<float, 7>, std::array<float, 3>>>);
+    static_assert(layer_t::parameter_size == 10);
+    static_assert(std::same_as<
+        layer_t::optimizer_type<ami::fused_adam<>>,
+        ami::fused_adam_t<float, 10>>);
+
+    // Memory follows the nonzeros: at 10% density about a fifth of dense.
+    using large_t = ami::sparse_dense_layer_t<float, 256, 256, 6554>;
+    static_assert(sizeof(large_t) * 4 <
+        sizeof(ami::dense_layer_t<float, 256, 256>));
+  };
+
+  "default"_test = [] {
+    const ami::sparse_dense_layer_t<double, 4, 3, 6> layer{};
+    const auto value = layer.value();
+    for (std::size_t i = 0; i < 3; ++i) {
+      expect(std::ranges::all_of(value.first[i], [](auto w) {
+            return w == 0;
+          }));
+    }
+    expect(eq(layer.columns(0).size(), 4ul));
+    expect(eq(layer.columns(1).size(), 2ul));
+    expect(eq(layer.columns(2).size(), 0ul));
+    expect(eq(layer.columns(1)[1], 1u));
+  };
+
+  "prune"_test = [] {
+    using dense_t = ami::dense_layer_t<float, 50, 20>;
+    constexpr std::size_t nonzeros = 100;
+    std::mt19937 engine{42};
+    const auto dense = std::make_unique<dense_t>();
+    fill(*dense, engine);
+    const auto sparse = ami::prune<nonzeros>(*dense);
+
+    // The kept weights are the largest, in their places, columns ascending.
+    float smallest_kept = 2;
+    float largest_dropped = 0;
+    std::size_t kept = 0;
+    const auto value = sparse.value();
+    for (std::size_t i = 0; i < dense_t::output_size; ++i) {
+      const auto columns = sparse.columns(i);
+      expect(std::ranges::is_sorted(columns));
+      kept += columns.size();
+      for (std::size_t j = 0; j < dense_t::input_size; ++j) {
+        const auto w = dense->weights(i)[j];
+        if (std::ranges::find(columns, j) != columns.end()) {
+          expect(eq(value.first[i][j], w));
+          smallest_kept = std::min(smallest_kept, std::abs(w));
+        } else {
+          expect(eq(value.first[i][j], 0.0f));
+          largest_dropped = std::max(largest_dropped, std::abs(w));
+        }
+      }
+    }
+    expect(eq(kept, nonzeros));
+    expect(ge(smallest_kept, largest_dropped));
+    expect(std::ranges::equal(sparse.biases(), dense->biases()));
+
+    // Of equal weights the first in row order are kept.
+    typename dense_t::value_type equal{};
+    for (auto& row : equal.first) {
+      row.fill(0.5f);
+    }
+    const ami::sparse_dense_layer_t<float, 50, 20, 75> ties{equal};
+    expect(eq(ties.columns(0).size(), 50ul));
+    expect(eq(ties.columns(1).size(), 25ul));
+    expect(eq(ties.columns(2).size(), 0ul));
+  };
+
+  // Every pass agrees with a dense layer holding the pruned weights.
+  "passes"_test = []<class RealType> {
+    using dense_t = ami::dense_layer_t<RealType, 130, 70>;
+    using layer_t = ami::sparse_dense_layer_t<RealType, 130, 70, 1500>;
+    using input_t = typename layer_t::input_type;
+    using delta_t = typename layer_t::delta_type;
+
+    std::mt19937 engine{7};
+    const auto original = std::make_unique<dense_t>();
+    fill(*original, engine);
+    const auto layer = std::make_unique<layer_t>();
+    layer->assign(*original);
+    const auto dense = std::make_unique<dense_t>(layer->value());
+    const auto input = make_samples<input_t>(9, engine);
+    const auto delta = make_samples<delta_t>(9, engine);
+
+    should("forward") = [&] {
+      for (const auto& x : input) {
+        const auto expected = dense->forward(x);
+        expect(close(layer->forward(x), expected));
+        expect(layer->template forward<std::execution::par>(x) ==
+            layer->forward(x));
+
+        typename layer_t::forward_type fused{};
+        layer->forward(x, fused, [](std::size_t, RealType z) {
+              return ami::relu::f(z);
+            });
+        for (std::size_t i = 0; i < fused.size(); ++i) {
+          expect(eq(fused[i], ami::relu::f(layer->forward(x)[i])));
+        }
+      }
+      std::vector<typename layer_t::forward_type> batch(input.size());
+      layer->template forward<std::execution::par>(
+          std::span{input}, std::span{batch});
+      for (std::size_t b = 0; b < input.size(); ++b) {
+        expect(batch[b] == layer->forward(input[b]));
+      }
+    };
+
+    should("backward") = [&] {
+      for (const auto& d : delta) {
+        const auto expected = dense->backward(d);
+        expect(close(layer->backward(d), expected));
+        expect(close(layer->template backward<std::execution::par>(d),
+            expected));
+      }
+      std::vector<typename layer_t::backward_type> batch(delta.size());
+      layer->template backward<std::execution::par>(
+          std::span{delta}, std::span{batch});
+      for (std::size_t b = 0; b < delta.size(); ++b) {
+        expect(batch[b] == layer->backward(delta[b]));
+      }
+    };
+
+    // Only the gradient at the nonzeros is formed.
+    should("calc_gradient") = [&] {
+      const auto check = [&](const typename layer_t::gradient_type& actual,
+                             const typename dense_t::gradient_type& expected) {
+        std::size_t p = 0;
+        for (std::size_t i = 0; i < layer_t::output_size; ++i) {
+          for (const auto j : layer->columns(i)) {
+            const auto e = expected.first[i][j];
+            expect(le(std::abs(actual.first[p++] - e),
+                RealType{1e-4} * (1 + std::abs(e))));
+          }
+        }
+        expect(close(actual.second, expected.second));
+      };
+
+      auto expected = std::make_unique<typename dense_t::gradient_type>();
+      auto gradient = std::make_unique<typename layer_t::gradient_type>();
+      auto batch = std::make_unique<typename layer_t::gradient_type>();
+      for (std::size_t b = 0; b < input.size(); ++b) {
+        dense_t::calc_gradient(input[b], delta[b], *expected);
+        layer->template calc_gradient<std::execution::par>(
+            input[b], delta[b], *gradient);
+      }
+      layer->template calc_gradient<std::execution::par>(
+          std::span{input}, std::span{delta}, *batch);
+      check(*gradient, *expected);
+      check(*batch, *expected);
+    };
+
+    should("update") = [&] {
+      auto gradient = std::make_unique<typename layer_t::gradient_type>();
+      layer->calc_gradient(input.front(), delta.front(), *gradient);
+
+      auto updated = std::make_unique<layer_t>(*layer);
+      auto state = std::make_unique<
+          typename layer_t::template optimizer_type<optimizer_t>>();
+      updated->template update<std::execution::par>(*state, *gradient);
+      for (std::size_t p = 0; p < layer_t::nonzeros; ++p) {
+        expect(eq(updated->values()[p],
+            layer->values()[p] + gradient->first[p]));
+      }
+      for (std::size_t i = 0; i < layer_t::output_size; ++i) {
+        expect(eq(updated->biases()[i],
+            layer->biases()[i] + gradient->second[i]));
+      }
+
+      // Adam on the nonzeros moves them as it moves the same weights of
+      // the dense layer; the pruned weights, with no gradient, stay zero.
+      auto dense_gradient =
+          std::make_unique<typename dense_t::gradient_type>();
+      dense_t::calc_gradient(input.front(), delta.front(), *dense_gradient);
+      for (std::size_t i = 0; i < layer_t::output_size; ++i) {
+        auto masked = typename dense_t::node_type::value_type{};
+        for (const auto j : layer->columns(i)) {
+          masked[j] = dense_gradient->first[i][j];
+        }
+        dense_gradient->first[i] = masked;
+      }
+      auto adam = std::make_unique<layer_t>(*layer);
+      auto adam_dense = std::make_unique<dense_t>(layer->value());
+      auto adam_state = std::make_unique<typename layer_t::template
+          optimizer_type<ami::fused_adam<>>>();
+      auto adam_dense_state = std::make_unique<typename dense_t::template
+          optimizer_type<ami::fused_adam<>>>();
+      for (int step = 0; step < 3; ++step) {
+        adam->update(*adam_state, *gradient);
+        adam_dense->update(*adam_dense_state, *dense_gradient);
+      }
+      const auto expected = adam_dense->value();
+      const auto actual = adam->value();
+      for (std::size_t i = 0; i < layer_t::output_size; ++i) {
+        expect(close(actual.first[i], expected.first[i]));
+      }
+      expect(close(actual.second, expected.second));
+    };
+  } | std::tuple<float, double>{};
+
+  "sequential"_test = [] {
+    using sparse_model_t = ami::sequential_t<float, 40,
+        ami::sparse_dense_layer<30, 200>, ami::activation_layer<ami::relu>,
+        ami::dense_layer<5>>;
+    using dense_model_t = ami::sequential_t<float, 40,
+        ami::dense_layer<30>, ami::activation_layer<ami::relu>,
+        ami::dense_layer<5>>;
+
+    std::mt19937 engine{3};
+    auto sparse = std::make_unique<sparse_model_t>();
+    auto dense = std::make_unique<dense_model_t>();
+    fill(std::get<0>(dense->layers()), engine);
+    fill(std::get<2>(dense->layers()), engine);
+    std::get<0>(sparse->layers()).assign(std::get<0>(dense->layers()));
+    std::get<0>(dense->layers()) = typename std::tuple_element_t<0,
+        dense_model_t::layers_type>{std::get<0>(sparse->layers()).value()};
+    std::get<2>(sparse->layers()) = std::get<2>(dense->layers());
+
+    const auto input = make_samples<sparse_model_t::input_type>(4, engine);
+    const auto delta = make_samples<sparse_model_t::delta_type>(4, engine);
+    auto sparse_gradient = std::make_unique<sparse_model_t::gradient_type>();
+    auto dense_gradient = std::make_unique<dense_model_t::gradient_type>();
+    for (std::size_t b = 0; b < input.size(); ++b) {
+      expect(close(sparse->forward(input[b]), dense->forward(input[b])));
+      expect(close(sparse->backward(delta[b], *sparse_gradient),
+          dense->backward(delta[b], *dense_gradient)));
+    }
+
+    const auto& layer = std::get<0>(sparse->layers());
+    std::size_t p = 0;
+    for (std::size_t i = 0; i < 30; ++i) {
+      for (const auto j : layer.columns(i)) {
+        const auto e = std::get<0>(*dense_gradient).first[i][j];
+        expect(le(std::abs(std::get<0>(*sparse_gradient).first[p++] - e),
+            1e-4f * (1 + std::abs(e))));
+      }
+    }
+    expect(close(std::get<0>(*sparse_gradient).second,
+        std::get<0>(*dense_gradient).second));
+
+    typename sparse_model_t::optimizer_type<ami::fused_adam<>> state{};
+    sparse->update(state, *sparse_gradient);
+  };
+}
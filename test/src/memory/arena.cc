@@ -0,0 +1,174 @@
+#include "ami/memory/arena.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+#include <span>
+#include <type_traits>
+#include <vector>
+
+#include <boost/ut.hpp>
+
+#include "ami/layer/dynamic_dense_layer.hpp"
+
+namespace {
+  std::atomic<std::size_t> allocations{};
+}
+
+// Counts every heap allocation of the test so a training step can be shown
+// to make none.
+void* operator new(std::size_t size) {
+  ++allocations;
+  if (void* p = std::malloc(size == 0 ? 1 : size)) {
+    return p;
+  }
+  throw std::bad_alloc{};
+}
+
+void* operator new(std::size_t size, std::align_val_t align) {
+  ++allocations;
+  const auto alignment = static_cast<std::size_t>(align);
+  if (void* p = std::aligned_alloc(
+          alignment, (size + alignment - 1) / alignment * alignment)) {
+    return p;
+  }
+  throw std::bad_alloc{};
+}
+
+void operator delete(void* p) noexcept { std::free(p); }
+
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+
+void operator delete(void* p, std::align_val_t) noexcept { std::free(p); }
+
+void operator delete(void* p, std::size_t, std::align_val_t) noexcept {
+  std::free(p);
+}
+
+bool aligned(const void* p, std::size_t alignment = 64) {
+  return reinterpret_cast<std::uintptr_t>(p) % alignment == 0;
+}
+
+int main() {
+  using namespace boost::ut;
+  using ami::memory::arena;
+  using ami::memory::arena_allocator;
+
+  "allocate"_test = [] {
+    arena a{1024};
+    expect(eq(a.block_count(), std::size_t{}));
+
+    auto* p = a.allocate(3);
+    auto* q = a.allocate(5);
+    expect(aligned(p) and aligned(q));
+    expect(eq(static_cast<std::byte*>(q) - static_cast<std::byte*>(p), 64));
+    expect(aligned(a.allocate(8, 256), 256));
+    expect(eq(a.block_count(), std::size_t{1}));
+
+    const auto values = a.allocate<double>(4);
+    expect(eq(values.size(), std::size_t{4}));
+    expect(eq(values[3], 0.0));
+  };
+
+  "blocks"_test = [] {
+    arena a{1024};
+    (void)a.allocate(1000);
+    (void)a.allocate(1000);
+    expect(eq(a.block_count(), std::size_t{2}));
+
+    // Larger than a block.
+    auto* large = a.allocate(4096);
+    expect(aligned(large));
+    expect(eq(a.block_count(), std::size_t{3}));
+    const auto capacity = a.capacity();
+    expect(capacity >= std::size_t{6144});
+
+    a.reset();
+    expect(eq(a.block_count(), std::size_t{1}));
+    expect(eq(a.capacity(), capacity));
+
+    // The merged block holds the whole pass again.
+    auto* first = a.allocate(1000);
+    (void)a.allocate(1000);
+    (void)a.allocate(4096);
+    expect(eq(a.block_count(), std::size_t{1}));
+    a.reset();
+    expect(a.allocate(1) == first);
+  };
+
+  "mark and rewind"_test = [] {
+    arena a{1024};
+    (void)a.allocate(100);
+    const auto m = a.mark();
+    auto* p = a.allocate(100);
+    (void)a.allocate(2000);
+    a.rewind(m);
+    expect(a.allocate(100) == p);
+  };
+
+  "huge pages"_test = [] {
+    arena a{1 << 20, ami::memory::page_size::huge};
+    const auto values = a.allocate<float>(1 << 20);
+    values[(1 << 20) - 1] = 1;
+    expect(aligned(values.data()));
+    expect(eq(a.capacity() % arena::huge_page_size, std::size_t{}));
+  };
+
+  "arena_allocator"_test = [] {
+    arena a{};
+    arena_allocator<float> allocator{a};
+    std::vector<float, arena_allocator<float>> v(10, 1.0f, allocator);
+    std::vector<double, arena_allocator<double>> w(10, allocator);
+    expect(aligned(v.data()) and aligned(w.data()));
+    expect(allocator == w.get_allocator());
+
+    arena b{};
+    expect(allocator != arena_allocator<float>{b});
+  };
+
+  "training step"_test = [] {
+    using allocator_t = arena_allocator<float>;
+    using layer_t =
+        ami::dynamic_dense_layer<float, ami::row_padding::none, allocator_t>;
+    constexpr std::size_t batch = 32, input_size = 96, output_size = 64;
+    constexpr auto optimizer = [](float& x, float g) { x -= g / 16; };
+
+    arena parameters{};
+    arena activations{};
+    const allocator_t allocator{parameters};
+    layer_t layer{input_size, output_size, allocator};
+    auto gradient = layer.make_gradient();
+    auto optimizers =
+        layer.make_optimizer<std::remove_cvref_t<decltype(optimizer)>>();
+    expect(layer.get_allocator() == allocator);
+    expect(eq(parameters.block_count(), std::size_t{1}));
+
+    const auto step = [&] {
+      activations.reset();
+      const auto input = activations.allocate<float>(batch * input_size);
+      const auto output = activations.allocate<float>(batch * output_size);
+      const auto delta = activations.allocate<float>(batch * input_size);
+      for (std::size_t i = 0; i < input.size(); ++i) {
+        input[i] = static_cast<float>(i % 7) / 7;
+      }
+      layer.forward(input, output);
+      layer.backward(output, delta);
+      std::ranges::fill(gradient.first, 0.0f);
+      std::ranges::fill(gradient.second, 0.0f);
+      layer.calc_gradient(input, output, gradient);
+      layer.update(optimizers, gradient);
+      return output[0];
+    };
+
+    (void)step();
+    const auto before = allocations.load();
+    const auto result = step();
+    const auto after = allocations.load();
+    expect(eq(after - before, std::size_t{})) << "allocations in a warm step";
+    expect(eq(activations.block_count(), std::size_t{1}));
+    expect(result == result);
+  };
+}
@@ -0,0 +1,71 @@
+#include "ami/memory/scratch.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <execution>
+#include <numeric>
+#include <thread>
+#include <vector>
+
+#include <boost/ut.hpp>
+
+#include "ami/utility/parallel_algorithm.hpp"
+
+int main() {
+  using namespace boost::ut;
+  using ami::memory::scratch;
+  using ami::memory::thread_scratch;
+
+  "scope"_test = [] {
+    const auto* first = [] {
+      scratch workspace{};
+      return workspace.allocate<float>(16).data();
+    }();
+    scratch workspace{};
+    const auto values = workspace.allocate<float>(16);
+    expect(values.data() == first);
+    expect(eq(reinterpret_cast<std::uintptr_t>(values.data()) % 64,
+        std::uintptr_t{}));
+  };
+
+  "nested"_test = [] {
+    scratch outer{};
+    const auto a = outer.allocate<double>(8);
+    const double* b = nullptr;
+    {
+      scratch inner{};
+      b = inner.allocate<double>(8).data();
+      expect(b != a.data());
+    }
+    expect(outer.allocate<double>(8).data() == b);
+  };
+
+  "per thread"_test = [] {
+    const auto* main_arena = &thread_scratch();
+    const ami::memory::arena* other_arena = nullptr;
+    std::thread{[&] { other_arena = &thread_scratch(); }}.join();
+    expect(main_arena != other_arena);
+  };
+
+  "parallel"_test = [] {
+    std::vector<int> sums(64);
+    std::vector<std::size_t> indices(sums.size());
+    std::iota(indices.begin(), indices.end(), std::size_t{});
+    ami::utility::for_each<std::execution::par>(indices,
+        [&](std::size_t i) {
+          scratch workspace{};
+          const auto values = workspace.allocate<int>(i + 1);
+          for (std::size_t j = 0; j <= i; ++j) {
+            values[j] = static_cast<int>(j);
+          }
+          int sum{};
+          for (const auto v : values) {
+            sum += v;
+          }
+          sums[i] = sum;
+        });
+    for (std::size_t i = 0; i < sums.size(); ++i) {
+      expect(eq(sums[i], static_cast<int>(i * (i + 1) / 2))) << i;
+    }
+  };
+}
@@ -0,0 +1,228 @@
+#include "ami/model/checkpoint.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <tuple>
+
+#include <boost/ut.hpp>
+
+#include "ami/activation/relu.hpp"
+#include "ami/layer/activation_layer.hpp"
+#include "ami/layer/dense_layer.hpp"
+#include "ami/layer/dropout_layer.hpp"
+#include "ami/model/sequential.hpp"
+#include "ami/optimizer/adam.hpp"
+#include "ami/optimizer/fused_adam.hpp"
+
+template <std::floating_point RealType>
+using model_t = ami::sequential_t<RealType, 4, ami::dense_layer<3>,
+    ami::activation_layer<ami::relu>, ami::dropout_layer<0.5>,
+    ami::dense_layer<2, ami::row_padding::cache_line>>;
+
+template <class Model>
+void fill(Model& model) {
+  std::size_t n{};
+  std::apply([&](auto&... layer) {
+    const auto fill_layer = [&](auto& l) {
+      if constexpr (requires { l.biases(); }) {
+        for (std::size_t i = 0; i < l.output_size; ++i) {
+          for (auto& w : l.weights(i)) {
+            w = static_cast<typename Model::real_type>(++n) / 4;
+          }
+        }
+        for (auto& b : l.biases()) {
+          b = -static_cast<typename Model::real_type>(++n);
+        }
+      }
+    };
+    (fill_layer(layer), ...);
+  }, model.layers());
+}
+
+template <class Model, class... Optimizer>
+void save(const std::filesystem::path& path, const Model& model,
+          const Optimizer&... optimizer) {
+  std::ofstream os{path, std::ios::binary};
+  ami::save_checkpoint(os, model, optimizer...);
+}
+
+int main() {
+  using namespace boost::ut;
+
+  const auto path =
+      std::filesystem::temp_directory_path() / "ami_checkpoint_test.bin";
+
+  "layout"_test = [&] {
+    model_t<float> model{};
+    fill(model);
+    save(path, model);
+
+    const ami::checkpoint source{path};
+    expect(eq(source.depth(), std::size_t{4}));
+    expect(eq(source.header().real_size, std::uint32_t{4}));
+    expect(eq(source.header().file_size, std::filesystem::file_size(path)));
+    expect(!source.has_state());
+
+    constexpr std::array<std::size_t, 4> parameters{15, 0, 0, 8};
+    for (std::size_t i = 0; i < source.depth(); ++i) {
+      const auto& layer = source.layers()[i];
+      expect(eq(layer.parameter_size, parameters[i])) << i;
+      expect(eq(layer.parameter_offset % 64, std::uint64_t{})) << i;
+      expect(eq(layer.state_size, std::uint64_t{})) << i;
+    }
+    expect(eq(source.layers()[0].input_size, std::uint64_t{4}));
+    expect(eq(source.layers()[3].output_size, std::uint64_t{2}));
+
+    const auto dense = source.parameters<float>(3);
+    expect(eq(dense[0], 4.0f) and eq(dense[5], 5.25f));
+    expect(eq(dense[6], -22.0f) and eq(dense[7], -23.0f));
+  };
+
+  "round trip"_test = []<class RealType>(RealType) {
+    const auto path = std::filesystem::temp_directory_path() /
+        "ami_checkpoint_round_trip.bin";
+    model_t<RealType> model{};
+    fill(model);
+    save(path, model);
+
+    model_t<RealType> loaded{};
+    ami::load_checkpoint(ami::checkpoint{path}, loaded);
+    const auto& [a0, a1, a2, a3] = model.layers();
+    const auto& [b0, b1, b2, b3] = loaded.layers();
+    expect(a0.value() == b0.value());
+    expect(a3.value() == b3.value());
+  } | std::tuple<float, double>{};
+
+  "optimizer state"_test = [&] {
+    using model_type = model_t<double>;
+    model_type model{};
+    fill(model);
+
+    const auto run = [](auto& model, auto& optimizer) {
+      typename model_type::gradient_type gradient{};
+      model.forward({1, 2, 3, 4});
+      model.backward({1, -1}, gradient);
+      model.update(optimizer, gradient);
+    };
+
+    const auto check = [&]<class Optimizer>(Optimizer) {
+      using optimizer_type =
+          typename model_type::template optimizer_type<Optimizer>;
+      auto model0 = model;
+      optimizer_type optimizer0{};
+      run(model0, optimizer0);
+      save(path, model0, optimizer0);
+
+      model_type model1{};
+      optimizer_type optimizer1{};
+      const ami::checkpoint source{path};
+      expect(source.has_state());
+      ami::load_checkpoint(source, model1, optimizer1);
+
+      run(model0, optimizer0);
+      run(model1, optimizer1);
+      expect(std::get<0>(model0.layers()).value() ==
+          std::get<0>(model1.layers()).value());
+      expect(std::get<3>(model0.layers()).value() ==
+          std::get<3>(model1.layers()).value());
+    };
+    check(ami::adam_t<double>{});
+    check(ami::fused_adam<>{});
+  };
+
+  "mismatch"_test = [&] {
+    model_t<float> model{};
+    save(path, model);
+    const ami::checkpoint source{path};
+
+    model_t<double> wrong_type{};
+    expect(throws<ami::checkpoint_error>(
+        [&] { ami::load_checkpoint(source, wrong_type); }));
+
+    ami::sequential_t<float, 4, ami::dense_layer<2>> wrong_depth{};
+    expect(throws<ami::checkpoint_error>(
+        [&] { ami::load_checkpoint(source, wrong_depth); }));
+
+    ami::sequential_t<float, 5, ami::dense_layer<3>,
+        ami::activation_layer<ami::relu>, ami::dropout_layer<0.5>,
+        ami::dense_layer<2>> wrong_shape{};
+    expect(throws<ami::checkpoint_error>(
+        [&] { ami::load_checkpoint(source, wrong_shape); }));
+
+    model_t<float>::optimizer_type<ami::fused_adam<>> optimizer{};
+    expect(throws<ami::checkpoint_error>(
+        [&] { ami::load_checkpoint(source, model, optimizer); }));
+  };
+
+  "failed load"_test = [&] {
+    using model_type = model_t<double>;
+    using adam_type = model_type::optimizer_type<ami::adam_t<double>>;
+    using fused_type = model_type::optimizer_type<ami::fused_adam<>>;
+    model_type target{};
+    fill(target);
+    fused_type optimizer{};
+    typename model_type::gradient_type gradient{};
+    target.forward({1, 2, 3, 4});
+    target.backward({1, -1}, gradient);
+    target.update(optimizer, gradient);
+    const auto model0 = target;
+    const auto optimizer0 = optimizer;
+
+    const auto unchanged = [&] {
+      return std::get<0>(target.layers()).value() ==
+                 std::get<0>(model0.layers()).value() &&
+             std::get<3>(target.layers()).value() ==
+                 std::get<3>(model0.layers()).value() &&
+             std::ranges::equal(std::get<0>(optimizer).m(),
+                 std::get<0>(optimizer0).m()) &&
+             std::ranges::equal(std::get<3>(optimizer).v(),
+                 std::get<3>(optimizer0).v());
+    };
+
+    should("leave the model alone without optimizer state") = [&] {
+      save(path, model_type{});
+      const ami::checkpoint source{path};
+      expect(throws<ami::checkpoint_error>(
+          [&] { ami::load_checkpoint(source, target, optimizer); }));
+      expect(unchanged());
+    };
+
+    should("leave both alone on an optimizer mismatch") = [&] {
+      save(path, model_type{}, adam_type{});
+      const ami::checkpoint source{path};
+      expect(source.has_state());
+      expect(throws<ami::checkpoint_error>(
+          [&] { ami::load_checkpoint(source, target, optimizer); }));
+      expect(unchanged());
+    };
+  };
+
+  "corrupt"_test = [&] {
+    std::ofstream{path, std::ios::binary} << "not a checkpoint, but long "
+        "enough to hold a header of sixty four bytes..................";
+    expect(throws<ami::checkpoint_error>([&] { ami::checkpoint{path}; }));
+
+    model_t<float> model{};
+    save(path, model);
+    std::filesystem::resize_file(path, 200);
+    expect(throws<ami::checkpoint_error>([&] { ami::checkpoint{path}; }));
+
+    // A real size of no floating point type.
+    save(path, model);
+    {
+      std::fstream file{path,
+          std::ios::binary | std::ios::in | std::ios::out};
+      const std::uint32_t real_size = 0x80000000;
+      file.seekp(offsetof(ami::checkpoint_header, real_size));
+      file.write(reinterpret_cast<const char*>(&real_size),
+          sizeof(real_size));
+    }
+    expect(throws<ami::checkpoint_error>([&] { ami::checkpoint{path}; }));
+  };
+
+  std::filesystem::remove(path);
+}
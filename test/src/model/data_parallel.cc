@@ -0,0 +1,160 @@
+#include "ami/model/data_parallel.hpp"
+
+#include <array>
+#include <cstddef>
+#include <execution>
+#include <random>
+#include <span>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+
+#include <boost/ut.hpp>
+
+#include "ami/layer/activation_layer.hpp"
+#include "ami/layer/dense_layer.hpp"
+#include "ami/layer/dropout_layer.hpp"
+#include "ami/model/sequential.hpp"
+
+struct func {
+  template <std::floating_point RealType>
+  static constexpr RealType f(RealType src) { return 2 * src; }
+
+  template <std::floating_point RealType>
+  static constexpr RealType df(RealType) { return 2; }
+};
+
+// Small integers keep every sum exact, so the reduction order is invisible.
+template <std::floating_point RealType>
+using model_t = ami::sequential_t<RealType, 6, ami::dense_layer<5>,
+    ami::activation_layer<func>, ami::dropout_layer<0.5>,
+    ami::dense_layer<3>>;
+
+template <class Model>
+auto make_test_model() {
+  Model model{};
+  auto& [dense1, activation, dropout, dense2] = model.layers();
+  const auto fill = [](auto& layer) {
+    using real_t = typename std::remove_cvref_t<decltype(layer)>::real_type;
+    auto weights = layer.weights();
+    for (std::size_t i = 0; i < weights.size(); ++i) {
+      weights[i] = static_cast<real_t>(i % 3) - 1;
+    }
+  };
+  fill(dense1);
+  fill(dense2);
+  return model;
+}
+
+template <class Model>
+auto make_test_batch(std::size_t batch_size) {
+  using real_t = typename Model::real_type;
+  std::vector<typename Model::input_type> input(batch_size);
+  for (std::size_t b = 0; b < batch_size; ++b) {
+    for (std::size_t j = 0; j < Model::input_size; ++j) {
+      input[b][j] = static_cast<real_t>((b + j) % 5) - 2;
+    }
+  }
+  return input;
+}
+
+int main() {
+  using namespace ami;
+  using namespace boost::ut;
+  using namespace std::execution;
+
+  constexpr std::tuple policies{
+      seq, par, par_unseq, ami::execution::adaptive, ami::execution::pool};
+
+  const auto loss_gradient = [](std::size_t i, const auto& output) {
+    auto delta = output;
+    delta[i % delta.size()] -= 1;
+    return delta;
+  };
+
+  "calc_gradient"_test = [&]<class RealType>() {
+    using model = model_t<RealType>;
+    const auto target = make_test_model<model>();
+    const auto input = make_test_batch<model>(37);
+
+    typename model::gradient_type expected{};
+    auto reference = target;
+    for (std::size_t i = 0; i < input.size(); ++i) {
+      reference.backward(
+          loss_gradient(i, reference.forward(input[i])), expected);
+    }
+
+    should("match the sequential sum for any worker count") =
+        [&]<class Policy>() {
+          for (std::size_t workers : {1, 2, 3, 8, 64}) {
+            data_parallel<model> trainer{workers};
+            expect(trainer.workers() == workers);
+            expect(trainer.template calc_gradient<Policy{}>(
+                target, std::span{input}, loss_gradient) == expected);
+            // The buffers are reset on every call.
+            expect(trainer.template calc_gradient<Policy{}>(
+                target, std::span{input}, loss_gradient) == expected);
+          }
+        } | policies;
+  } | std::pair<float, double>{};
+
+  "engines"_test = [&]<class RealType>() {
+    using model = model_t<RealType>;
+    const auto target = make_test_model<model>();
+    const auto input = make_test_batch<model>(10);
+    constexpr std::size_t workers = 4;
+
+    should("give every worker its own engine") = [&]<class Policy>() {
+      typename model::gradient_type expected{};
+      auto reference = target;
+      for (std::size_t w = 0; w < workers; ++w) {
+        std::mt19937 engine{static_cast<unsigned>(w)};
+        for (auto i = input.size() * w / workers;
+             i < input.size() * (w + 1) / workers; ++i) {
+          reference.backward(loss_gradient(i,
+              reference.forward(input[i], engine)), expected);
+        }
+      }
+
+      std::array<std::mt19937, workers> engines{};
+      for (std::size_t w = 0; w < workers; ++w) {
+        engines[w].seed(static_cast<unsigned>(w));
+      }
+      data_parallel<model> trainer{workers};
+      expect(trainer.template calc_gradient<Policy{}>(target,
+          std::span{input}, loss_gradient, std::span<std::mt19937>{engines}) ==
+          expected);
+    } | policies;
+
+    should("reject fewer engines than workers") = [&] {
+      data_parallel<model> trainer{workers};
+      std::array<std::mt19937, workers - 1> engines{};
+      expect(throws<std::invalid_argument>([&] {
+            trainer.calc_gradient(target, std::span{input}, loss_gradient,
+                std::span<std::mt19937>{engines});
+          }));
+      expect(throws<std::invalid_argument>([&] {
+            trainer.calc_gradient(target, std::span{input}, loss_gradient,
+                std::span<std::mt19937>{});
+          }));
+    };
+  } | std::pair<float, double>{};
+
+  "chunking"_test = [&] {
+    using model = sequential_t<float, 300, dense_layer<20>>;
+    model target{};
+    const auto input = make_test_batch<model>(9);
+
+    typename model::gradient_type expected{};
+    auto reference = target;
+    for (std::size_t i = 0; i < input.size(); ++i) {
+      reference.backward(
+          loss_gradient(i, reference.forward(input[i])), expected);
+    }
+
+    data_parallel<model> trainer{5};
+    expect(trainer.template calc_gradient<par>(
+        target, std::span{input}, loss_gradient) == expected);
+  };
+}
@@ -0,0 +1,156 @@
+#include "ami/model/frozen.hpp"
+
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <ios>
+#include <limits>
+#include <sstream>
+#include <string>
+#include <tuple>
+#include <type_traits>
+
+#include <boost/ut.hpp>
+
+#include "ami/activation/relu.hpp"
+#include "ami/activation/tanh.hpp"
+#include "ami/layer/activation_layer.hpp"
+#include "ami/layer/dense_layer.hpp"
+#include "ami/layer/dropout_layer.hpp"
+#include "ami/model/sequential.hpp"
+
+template <std::floating_point RealType>
+using model_t = ami::sequential_t<RealType, 4, ami::dense_layer<3>,
+    ami::activation_layer<ami::relu>, ami::dropout_layer<0.5>,
+    ami::dense_layer<2>, ami::activation_layer<ami::tanh<>>>;
+
+// Large enough that the layers are not unrolled.
+template <std::floating_point RealType>
+using wide_t = ami::sequential_t<RealType, 40, ami::dense_layer<30>,
+    ami::activation_layer<ami::relu>, ami::dense_layer<5>>;
+
+template <class Model>
+constexpr auto make_parameters() {
+  using real_t = typename Model::real_type;
+  std::array<real_t, ami::parameter_size<Model>> result{};
+  for (std::size_t i = 0; i < result.size(); ++i) {
+    result[i] = static_cast<real_t>(static_cast<int>(i % 7) - 3) / 8;
+  }
+  return result;
+}
+
+template <class Model, class Parameters>
+Model make_model(const Parameters& p) {
+  Model model{};
+  std::size_t offset{};
+  std::apply([&](auto&... layer) {
+    const auto fill = [&](auto& l) {
+      if constexpr (requires { l.biases(); }) {
+        for (std::size_t i = 0; i < l.output_size; ++i) {
+          for (auto& w : l.weights(i)) {
+            w = p[offset++];
+          }
+        }
+        for (auto& b : l.biases()) {
+          b = p[offset++];
+        }
+      }
+    };
+    (fill(layer), ...);
+  }, model.layers());
+  return model;
+}
+
+template <class Input>
+constexpr Input make_input() {
+  Input result{};
+  for (std::size_t i = 0; i < result.size(); ++i) {
+    result[i] = static_cast<typename Input::value_type>(i + 1) / 4;
+  }
+  return result;
+}
+
+template <std::floating_point RealType>
+constexpr auto model_parameters = make_parameters<model_t<RealType>>();
+
+constexpr auto wide_parameters = make_parameters<wide_t<double>>();
+
+int main() {
+  using namespace boost::ut;
+
+  "parameter_size"_test = [] {
+    static_assert(ami::parameter_size<model_t<float>> == 3 * 5 + 2 * 4);
+    static_assert(ami::parameter_size<wide_t<double>> == 30 * 41 + 5 * 31);
+
+    using frozen_t = ami::frozen<model_t<float>, model_parameters<float>>;
+    static_assert(frozen_t::parameter_size == 23);
+    static_assert(frozen_t::depth == 5);
+    static_assert(frozen_t::input_size == 4);
+    static_assert(frozen_t::output_size == 2);
+    static_assert(std::same_as<
+        frozen_t::forward_type, std::array<float, 2>>);
+  };
+
+  "parameters"_test = [] {
+    const auto model = make_model<model_t<double>>(model_parameters<double>);
+    expect(ami::parameters(model) == model_parameters<double>);
+  };
+
+  "forward"_test = []<class RealType>(RealType) {
+    constexpr auto& p = model_parameters<RealType>;
+    using model_type = model_t<RealType>;
+    using frozen_t = ami::frozen<model_type, model_parameters<RealType>>;
+
+    auto model = make_model<model_type>(p);
+    const auto input = make_input<typename model_type::input_type>();
+    const auto expected = model.forward(input);
+    const auto actual = frozen_t::forward(input);
+    for (std::size_t i = 0; i < expected.size(); ++i) {
+      expect(std::abs(actual[i] - expected[i]) <=
+          8 * std::numeric_limits<RealType>::epsilon()) << i;
+    }
+  } | std::tuple<float, double>{};
+
+  "forward rolled"_test = [] {
+    using frozen_t = ami::frozen<wide_t<double>, wide_parameters>;
+
+    auto model = make_model<wide_t<double>>(wide_parameters);
+    const auto input = make_input<wide_t<double>::input_type>();
+    const auto expected = model.forward(input);
+    const auto actual = frozen_t::forward(input);
+    for (std::size_t i = 0; i < expected.size(); ++i) {
+      expect(std::abs(actual[i] - expected[i]) <= 1e-12) << i;
+    }
+  };
+
+  "constexpr"_test = [] {
+    using frozen_t = ami::frozen<model_t<double>, model_parameters<double>>;
+    constexpr auto output =
+        frozen_t::forward(make_input<frozen_t::input_type>());
+    static_assert(output[0] != 0 || output[1] != 0);
+    // Constant evaluation folds std::tanh itself, which may differ from the
+    // library in the last place.
+    const auto actual = frozen_t::forward(make_input<frozen_t::input_type>());
+    for (std::size_t i = 0; i < output.size(); ++i) {
+      expect(std::abs(actual[i] - output[i]) <=
+          2 * std::numeric_limits<double>::epsilon()) << i;
+    }
+  };
+
+  "write_parameters"_test = [] {
+    using model_type = ami::sequential_t<float, 2, ami::dense_layer<1>>;
+    model_type model{};
+    auto& dense = std::get<0>(model.layers());
+    dense.weights(0)[0] = 0.5f;
+    dense.weights(0)[1] = -3.0f;
+    dense.biases()[0] = 0.1f;
+
+    std::ostringstream os;
+    ami::write_parameters(os, model, "weights");
+    expect(eq(os.str(), std::string{
+        "inline constexpr std::array<float, 3> weights{\n"
+        "    0x1p-1f, -0x1.8p+1f, 0x1.99999ap-4f};\n"}));
+    expect(eq(os.flags() & std::ios_base::floatfield,
+        std::ios_base::fmtflags{}));
+  };
+}
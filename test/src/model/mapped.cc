@@ -0,0 +1,92 @@
+#include "ami/model/mapped.hpp"
+
+#include <cmath>
+#include <cstddef>
+#include <execution>
+#include <filesystem>
+#include <fstream>
+#include <limits>
+#include <tuple>
+
+#include <boost/ut.hpp>
+
+#include "ami/activation/relu.hpp"
+#include "ami/activation/tanh.hpp"
+#include "ami/layer/activation_layer.hpp"
+#include "ami/layer/dense_layer.hpp"
+#include "ami/layer/dropout_layer.hpp"
+#include "ami/model/checkpoint.hpp"
+#include "ami/model/sequential.hpp"
+
+template <std::floating_point RealType>
+using model_t = ami::sequential_t<RealType, 6, ami::dense_layer<5>,
+    ami::activation_layer<ami::relu>, ami::dropout_layer<0.5>,
+    ami::dense_layer<3, ami::row_padding::cache_line>,
+    ami::activation_layer<ami::tanh<>>>;
+
+template <class Model>
+void fill(Model& model) {
+  using real_t = typename Model::real_type;
+  std::size_t n{};
+  std::apply([&](auto&... layer) {
+    const auto fill_layer = [&](auto& l) {
+      if constexpr (requires { l.biases(); }) {
+        for (std::size_t i = 0; i < l.output_size; ++i) {
+          for (auto& w : l.weights(i)) {
+            w = static_cast<real_t>(static_cast<int>(++n % 9) - 4) / 8;
+          }
+        }
+        for (auto& b : l.biases()) {
+          b = static_cast<real_t>(static_cast<int>(++n % 5) - 2) / 4;
+        }
+      }
+    };
+    (fill_layer(layer), ...);
+  }, model.layers());
+}
+
+int main() {
+  using namespace boost::ut;
+
+  const auto path =
+      std::filesystem::temp_directory_path() / "ami_mapped_test.bin";
+
+  "forward"_test = [&]<class RealType>(RealType) {
+    model_t<RealType> model{};
+    fill(model);
+    {
+      std::ofstream os{path, std::ios::binary};
+      ami::save_checkpoint(os, model);
+    }
+
+    const ami::checkpoint source{path};
+    const ami::mapped<model_t<RealType>> inference{source};
+    const typename model_t<RealType>::input_type input{
+        1, -2, 0.5, 3, -1, 0.25};
+    const auto expected = model.forward(input);
+    const auto actual = inference.forward(input);
+    const auto parallel = inference.template forward<std::execution::par>(
+        input);
+    for (std::size_t i = 0; i < expected.size(); ++i) {
+      const auto tolerance = 8 * std::numeric_limits<RealType>::epsilon();
+      expect(std::abs(actual[i] - expected[i]) <= tolerance) << i;
+      expect(std::abs(parallel[i] - expected[i]) <= tolerance) << i;
+    }
+  } | std::tuple<float, double>{};
+
+  "mismatch"_test = [&] {
+    model_t<float> model{};
+    {
+      std::ofstream os{path, std::ios::binary};
+      ami::save_checkpoint(os, model);
+    }
+    const ami::checkpoint source{path};
+    expect(throws<ami::checkpoint_error>(
+        [&] { ami::mapped<model_t<double>>{source}; }));
+    expect(throws<ami::checkpoint_error>([&] {
+      ami::mapped<ami::sequential_t<float, 6, ami::dense_layer<5>>>{source};
+    }));
+  };
+
+  std::filesystem::remove(path);
+}
@@ -0,0 +1,196 @@
+#include "ami/model/quantized.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <execution>
+#include <memory>
+#include <random>
+#include <span>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+
+#include <boost/ut.hpp>
+
+#include "ami/activation/relu.hpp"
+#include "ami/activation/tanh.hpp"
+#include "ami/layer/activation_layer.hpp"
+#include "ami/layer/dense_layer.hpp"
+#include "ami/layer/dropout_layer.hpp"
+#include "ami/layer/mixed_dense_layer.hpp"
+#include "ami/model/sequential.hpp"
+#include "ami/utility/quantization.hpp"
+
+// Dense layers hand each other uint8 outputs all the way through.
+template <std::floating_point RealType>
+using chained_t = ami::sequential_t<RealType, 64, ami::dense_layer<48>,
+    ami::activation_layer<ami::relu>, ami::dense_layer<32>,
+    ami::activation_layer<ami::tanh<>>, ami::dense_layer<10>>;
+
+// Dropout between the layers keeps the activations real.
+template <std::floating_point RealType>
+using dropout_t = ami::sequential_t<RealType, 64, ami::dense_layer<48>,
+    ami::activation_layer<ami::relu>, ami::dropout_layer<0.5>,
+    ami::dense_layer<10>>;
+
+// Weights scaled by the fan in, as a trained model would have them.
+template <class Model>
+auto make_model(std::mt19937& engine) {
+  auto model = std::make_unique<Model>();
+  std::apply([&](auto&... layer) {
+    const auto fill = [&](auto& l) {
+      if constexpr (requires { l.biases(); }) {
+        using real_t = typename std::remove_cvref_t<decltype(l)>::real_type;
+        const auto bound = 2 / std::sqrt(static_cast<real_t>(l.input_size));
+        std::uniform_real_distribution<real_t> dist{-bound, bound};
+        for (std::size_t i = 0; i < l.output_size; ++i) {
+          for (auto& w : l.weights(i)) {
+            w = dist(engine);
+          }
+        }
+        for (auto& b : l.biases()) {
+          b = dist(engine) / 4;
+        }
+      }
+    };
+    (fill(layer), ...);
+  }, model->layers());
+  return model;
+}
+
+template <class Input>
+std::vector<Input> make_samples(std::size_t size, std::mt19937& engine) {
+  using real_t = typename Input::value_type;
+  std::normal_distribution<real_t> dist{0, 1};
+  std::vector<Input> result(size);
+  for (auto& sample : result) {
+    for (auto& x : sample) {
+      x = dist(engine);
+    }
+  }
+  return result;
+}
+
+// Root mean square error of the quantized model over samples, relative to
+// the root mean square output of the float model.
+template <class Model, class Quantized, class Samples>
+auto relative_error(Model& model, const Quantized& quantized,
+                    const Samples& samples) {
+  using real_t = typename Model::real_type;
+  real_t error{};
+  real_t norm{};
+  for (const auto& x : samples) {
+    const auto expected = model.forward(x);
+    const auto actual = quantized.forward(x);
+    for (std::size_t i = 0; i < expected.size(); ++i) {
+      error += (actual[i] - expected[i]) * (actual[i] - expected[i]);
+      norm += expected[i] * expected[i];
+    }
+  }
+  return std::sqrt(error / norm);
+}
+
+int main() {
+  using namespace boost::ut;
+
+  "type_check"_test = [] {
+    using quantized_t = ami::quantized<chained_t<float>>;
+    static_assert(quantized_t::depth == 5);
+    static_assert(quantized_t::input_size == 64);
+    static_assert(quantized_t::output_size == 10);
+    static_assert(std::same_as<std::tuple_element_t<0,
+        quantized_t::layers_type>,
+        ami::quantized_dense_layer_t<float, 64, 48>>);
+    static_assert(std::same_as<std::tuple_element_t<1,
+        quantized_t::layers_type>,
+        ami::activation_layer_t<float, 48, ami::relu>>);
+    static_assert(std::same_as<
+        quantized_t::forward_type, std::array<float, 10>>);
+  };
+
+  "accuracy"_test = []<class RealType> {
+    std::mt19937 engine{42};
+    const auto calibration = make_samples<
+        typename chained_t<RealType>::input_type>(64, engine);
+    const auto test = make_samples<
+        typename chained_t<RealType>::input_type>(64, engine);
+
+    should("follow the float model") = [&] {
+      auto model = make_model<chained_t<RealType>>(engine);
+      const auto quantized = std::make_unique<
+          ami::quantized<chained_t<RealType>>>(*model, calibration);
+      // Three layers of 8 bit rounding, about 1%.
+      expect(lt(relative_error(*model, *quantized, test), RealType{0.03}));
+    };
+
+    should("treat dropout as the identity") = [&] {
+      auto model = make_model<dropout_t<RealType>>(engine);
+      const auto quantized = std::make_unique<
+          ami::quantized<dropout_t<RealType>>>(*model, calibration);
+      expect(lt(relative_error(*model, *quantized, test), RealType{0.03}));
+    };
+  } | std::tuple<float, double>{};
+
+  "calibration"_test = [] {
+    std::mt19937 engine{7};
+    auto model = make_model<chained_t<float>>(engine);
+    const auto samples = make_samples<chained_t<float>::input_type>(
+        16, engine);
+    const ami::quantized<chained_t<float>> quantized{*model, samples};
+    const auto& layers = quantized.layers();
+
+    // Each dense layer takes the range of its inputs in the float model.
+    std::array<ami::range_calibrator<float>, 3> calibrators{};
+    for (const auto& x : samples) {
+      const auto& [d0, a0, d1, a1, d2] = model->layers();
+      const auto h0 = a0.forward(d0.forward(x));
+      const auto h1 = a1.forward(d1.forward(h0));
+      calibrators[0].observe(x);
+      calibrators[1].observe(h0);
+      calibrators[2].observe(h1);
+    }
+    const auto check = [&](const auto& layer, std::size_t i) {
+      const auto expected = calibrators[i].make_quantization();
+      expect(eq(layer.input_quantization().scale, expected.scale)) << i;
+      expect(eq(layer.input_quantization().zero_point, expected.zero_point))
+          << i;
+    };
+    check(std::get<0>(layers), 0);
+    check(std::get<2>(layers), 1);
+    check(std::get<4>(layers), 2);
+
+    // The layers pass each other uint8 outputs, the activations applied
+    // as they are quantized.
+    const auto& [q0, a0, q1, a1, q2] = layers;
+    for (const auto& x : samples) {
+      std::array<std::uint8_t, 48> h0{};
+      q0.forward(x, h0, q1.input_quantization(), [](std::size_t, float z) {
+            return ami::relu::f(z);
+          });
+      std::array<std::uint8_t, 32> h1{};
+      q1.forward(h0, h1, q2.input_quantization(), [](std::size_t, float z) {
+            return ami::tanh<>::f(z);
+          });
+      std::array<float, 10> y{};
+      q2.forward(h1, y);
+      expect(quantized.forward(x) == y);
+      expect(quantized.forward<std::execution::par>(x) == y);
+    }
+  };
+
+  "mixed_dense_layer"_test = [] {
+    using model_t = ami::sequential_t<float, 64,
+        ami::mixed_dense_layer<32>, ami::activation_layer<ami::relu>,
+        ami::dense_layer<10>>;
+    std::mt19937 engine{11};
+    auto model = make_model<model_t>(engine);
+    std::get<0>(model->layers()).synchronize();
+    const auto samples = make_samples<model_t::input_type>(32, engine);
+    const ami::quantized<model_t> quantized{*model, samples};
+    // The master weights are quantized; forward reads bfloat16 weights.
+    expect(lt(relative_error(*model, quantized, samples), 0.03f));
+  };
+}
@@ -0,0 +1,385 @@
+#include "ami/model/sequential.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <concepts>
+#include <cstddef>
+#include <execution>
+#include <limits>
+#include <random>
+#include <ranges>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include <boost/ut.hpp>
+
+#include "ami/activation/gelu.hpp"
+#include "ami/activation/relu.hpp"
+#include "ami/activation/sigmoid.hpp"
+#include "ami/activation/tanh.hpp"
+#include "ami/layer/activation_layer.hpp"
+#include "ami/layer/dense_layer.hpp"
+#include "ami/layer/dropout_layer.hpp"
+#include "ami/optimizer/fused_adam.hpp"
+
+constexpr auto optimizer = [](auto& x, auto y) {
+  x += y;
+};
+
+using optimizer_t = std::remove_cvref_t<decltype(optimizer)>;
+
+struct func {
+  template <std::floating_point RealType>
+  static constexpr RealType f(RealType src) { return 2 * src; }
+
+  template <std::floating_point RealType>
+  static constexpr RealType df(RealType) { return 2; }
+};
+
+template <std::floating_point RealType>
+using model_t = ami::sequential_t<RealType, 4, ami::dense_layer<3>,
+    ami::activation_layer<func>, ami::dropout_layer<0.5>,
+    ami::dense_layer<2>>;
+
+template <std::floating_point RealType, class F = func>
+using mlp_t = ami::sequential_t<RealType, 5, ami::dense_layer<4>,
+    ami::activation_layer<F>, ami::dense_layer<3>,
+    ami::activation_layer<F>>;
+
+template <std::floating_point RealType>
+consteval void type_check() {
+  using model = model_t<RealType>;
+  using dense1_t = ami::dense_layer_t<RealType, 4, 3>;
+  using dense2_t = ami::dense_layer_t<RealType, 3, 2>;
+  static_assert(std::same_as<model, ami::sequential<dense1_t,
+      ami::activation_layer_t<RealType, 3, func>,
+      ami::dropout_layer_t<RealType, 3, 0.5>, dense2_t>>);
+  static_assert(std::same_as<typename model::real_type, RealType>);
+  static_assert(std::same_as<
+      typename model::input_type, std::array<RealType, 4>>);
+  static_assert(std::same_as<
+      typename model::forward_type, std::array<RealType, 2>>);
+  static_assert(std::same_as<
+      typename model::backward_type, std::array<RealType, 4>>);
+  static_assert(std::same_as<typename model::gradient_type,
+      std::tuple<typename dense1_t::gradient_type, std::tuple<>, std::tuple<>,
+                 typename dense2_t::gradient_type>>);
+  static_assert(model::depth == 4);
+  static_assert(model::input_size == 4);
+  static_assert(model::output_size == 2);
+}
+
+template <class Layer>
+constexpr auto make_test_layer() {
+  using layer_t = std::remove_cvref_t<Layer>;
+  using real_t = typename layer_t::real_type;
+  typename layer_t::value_type value{};
+  for (std::size_t i = 0; i < layer_t::output_size; ++i) {
+    for (std::size_t j = 0; j < layer_t::input_size; ++j) {
+      value.first[i][j] = static_cast<real_t>(i + 1) - static_cast<real_t>(j);
+    }
+    value.second[i] = static_cast<real_t>(i);
+  }
+  return layer_t{value};
+}
+
+// Whether two values, arrays or gradients agree to a few ulp. Compilers
+// may contract the multiply-adds of the activation kernels differently in
+// each instantiation, so a model and layers chained by hand can differ in
+// the last bits on FMA targets.
+template <class T>
+bool near(const T& a, const T& b) {
+  if constexpr (std::floating_point<T>) {
+    constexpr auto eps = std::numeric_limits<T>::epsilon();
+    return std::abs(a - b) <=
+        8 * eps * std::max(std::abs(a), std::abs(b)) + eps;
+  } else if constexpr (std::ranges::range<T>) {
+    return std::ranges::equal(a, b, [](const auto& x, const auto& y) {
+          return near(x, y);
+        });
+  } else {
+    return [&]<std::size_t... I>(std::index_sequence<I...>) {
+      return (near(std::get<I>(a), std::get<I>(b)) && ...);
+    }(std::make_index_sequence<std::tuple_size_v<T>>{});
+  }
+}
+
+template <class Model>
+constexpr auto make_test_model() {
+  using layers_t = typename Model::layers_type;
+  return Model{
+      make_test_layer<std::tuple_element_t<0, layers_t>>(),
+      std::tuple_element_t<1, layers_t>{}, std::tuple_element_t<2, layers_t>{},
+      make_test_layer<std::tuple_element_t<3, layers_t>>()};
+}
+
+int main() {
+  using namespace ami;
+  using namespace boost::ut;
+  using namespace std::execution;
+
+  "type_check"_test = []<class RealType>() {
+    type_check<RealType>();
+  } | std::pair<float, double>{};
+
+  constexpr std::tuple policies{
+      seq, par, par_unseq, unseq, ami::execution::adaptive,
+      ami::execution::pool};
+
+  "forward"_test = [&]<class RealType>() {
+    using model = model_t<RealType>;
+    using layers_t = typename model::layers_type;
+    const typename model::input_type input{1, -2, 3, -4};
+
+    auto target = make_test_model<model>();
+    const auto& [dense1, activation, dropout, dense2] = target.layers();
+    const auto expected = dense2.forward(
+        std::tuple_element_t<1, layers_t>::forward(dense1.forward(input)));
+
+    should("skip dropout on inference") = [&]<class Policy>() {
+      expect(target.template forward<Policy{}>(input) == expected);
+    } | policies;
+
+    should("draw the same mask on each policy") = [&]<class Policy>() {
+      ami::utility::philox engine{42};
+      ami::utility::philox reference_engine{42};
+      auto reference = make_test_model<model>();
+      expect(target.template forward<Policy{}>(input, engine) ==
+          reference.forward(input, reference_engine));
+    } | policies;
+
+    should("apply dropout on training") = [&]<class Policy>() {
+      std::mt19937 engine{42};
+      std::mt19937 reference_engine{42};
+      const auto expected = dense2.forward(
+          std::tuple_element_t<2, layers_t>::forward(
+              std::tuple_element_t<1, layers_t>::forward(
+                  dense1.forward(input)),
+              reference_engine));
+      expect(target.template forward<Policy{}>(input, engine) == expected);
+    } | policies;
+  } | std::pair<float, double>{};
+
+  "backward"_test = [&]<class RealType>() {
+    using model = model_t<RealType>;
+    using layers_t = typename model::layers_type;
+    using dense1_t = std::tuple_element_t<0, layers_t>;
+    using activation_t = std::tuple_element_t<1, layers_t>;
+    using dropout_t = std::tuple_element_t<2, layers_t>;
+    using dense2_t = std::tuple_element_t<3, layers_t>;
+    const typename model::input_type input{1, -2, 3, -4};
+    const typename model::delta_type delta{1, -1};
+
+    should("match the layers chained by hand") = [&]<class Policy>() {
+      auto target = make_test_model<model>();
+      const auto& [dense1, activation, dropout, dense2] = target.layers();
+
+      std::mt19937 engine{7};
+      std::mt19937 reference_engine{7};
+      target.template forward<Policy{}>(input, engine);
+
+      const auto x1 = dense1.forward(input);
+      const auto x2 = activation_t::forward(x1);
+      const auto mask = dropout_t::make_mask(reference_engine);
+      const auto x3 = dropout_t::forward(x2, mask);
+
+      typename dense2_t::gradient_type expected2{};
+      dense2_t::calc_gradient(x3, delta, expected2);
+      const auto d3 = dense2.backward(delta);
+      const auto d2 = dropout_t::backward(mask, d3);
+      const auto d1 = activation_t::backward(x1, d2);
+      typename dense1_t::gradient_type expected1{};
+      dense1_t::calc_gradient(input, d1, expected1);
+      const auto expected = dense1.backward(d1);
+
+      typename model::gradient_type gradient{};
+      expect(target.template backward<Policy{}>(delta, gradient) == expected);
+      expect(std::get<0>(gradient) == expected1);
+      expect(std::get<3>(gradient) == expected2);
+    } | policies;
+  } | std::pair<float, double>{};
+
+  "fusion"_test = [&]<class Model>() {
+    using model = std::remove_cvref_t<Model>;
+    using RealType = typename model::real_type;
+    using layers_t = typename model::layers_type;
+    using dense1_t = std::tuple_element_t<0, layers_t>;
+    using activation1_t = std::tuple_element_t<1, layers_t>;
+    using dense2_t = std::tuple_element_t<2, layers_t>;
+    using activation2_t = std::tuple_element_t<3, layers_t>;
+    const typename model::input_type input{1, -2, 3, -4, 5};
+    const typename model::delta_type delta{1, -1, 2};
+
+    static_assert(ami::detail::fused_length<layers_t, 0>() == 2);
+    static_assert(ami::detail::fused_length<layers_t, 1>() == 1);
+    static_assert(ami::detail::fused_length<layers_t, 2>() == 2);
+    static_assert(ami::detail::fused_length<
+        typename model_t<RealType>::layers_type, 0>() == 3);
+
+    should("match the unfused layers") = [&]<class Policy>() {
+      model target{make_test_layer<dense1_t>(), activation1_t{},
+                   make_test_layer<dense2_t>(), activation2_t{}};
+      const auto& dense1 = std::get<0>(target.layers());
+      const auto& dense2 = std::get<2>(target.layers());
+
+      const auto x1 = dense1.forward(input);
+      const auto x2 = activation1_t::forward(x1);
+      const auto x3 = dense2.forward(x2);
+      expect(target.template forward<Policy{}>(input) ==
+          activation2_t::forward(x3));
+
+      const auto d3 = activation2_t::backward(x3, delta);
+      const auto d1 = activation1_t::backward(x1, dense2.backward(d3));
+      typename model::gradient_type expected{};
+      dense2_t::calc_gradient(x2, d3, std::get<2>(expected));
+      dense1_t::calc_gradient(input, d1, std::get<0>(expected));
+
+      typename model::gradient_type gradient{};
+      expect(target.template backward<Policy{}>(delta, gradient) ==
+          dense1.backward(d1));
+      expect(gradient == expected);
+    } | policies;
+  } | std::tuple<mlp_t<float>, mlp_t<double>, mlp_t<float, ami::relu>,
+                 mlp_t<double, ami::sigmoid<>>,
+                 mlp_t<double, ami::gelu<ami::precision::fast>>>{};
+
+  "in place"_test = [&]<class RealType>() {
+    using model = ami::sequential_t<RealType, 3,
+        ami::activation_layer<ami::relu>, ami::dense_layer<2>,
+        ami::activation_layer<ami::tanh<>>>;
+    using layers_t = typename model::layers_type;
+    using activation1_t = std::tuple_element_t<0, layers_t>;
+    using dense_t = std::tuple_element_t<1, layers_t>;
+    using activation2_t = std::tuple_element_t<2, layers_t>;
+    const typename model::input_type input{1, -2, 3};
+    const typename model::delta_type delta{1, -1};
+
+    // the input and the dense output, no slot for either activation
+    static_assert(std::tuple_size_v<
+        decltype(typename model::arena_type{}.activations)> == 2);
+    static_assert(std::tuple_size_v<decltype(
+        typename mlp_t<RealType, ami::relu>::arena_type{}.activations)> == 3);
+    static_assert(std::tuple_size_v<decltype(
+        typename mlp_t<RealType>::arena_type{}.activations)> == 5);
+
+    should("match the layers chained by hand") = [&]<class Policy>() {
+      model target{activation1_t{}, make_test_layer<dense_t>(),
+                   activation2_t{}};
+      const auto& dense = std::get<1>(target.layers());
+
+      const auto x1 = activation1_t::forward(input);
+      const auto x2 = dense.forward(x1);
+      expect(near(target.template forward<Policy{}>(input),
+          activation2_t::forward(x2)));
+
+      const auto d2 = activation2_t::backward(x2, delta);
+      typename model::gradient_type expected{};
+      dense_t::calc_gradient(x1, d2, std::get<1>(expected));
+
+      typename model::gradient_type gradient{};
+      expect(near(target.template backward<Policy{}>(delta, gradient),
+          activation1_t::backward(input, dense.backward(d2))));
+      expect(near(gradient, expected));
+    } | policies;
+  } | std::pair<float, double>{};
+
+  "stacked in place"_test = [&]<class RealType>() {
+    using activations_t = ami::sequential_t<RealType, 2,
+        ami::activation_layer<ami::sigmoid<>>,
+        ami::activation_layer<ami::tanh<>>>;
+    using model = ami::sequential_t<RealType, 3, ami::dense_layer<2>,
+        ami::activation_layer<ami::sigmoid<>>,
+        ami::activation_layer<ami::tanh<>>>;
+    using layers_t = typename model::layers_type;
+    using dense_t = std::tuple_element_t<0, layers_t>;
+    using sigmoid_t = std::tuple_element_t<1, layers_t>;
+    using tanh_t = std::tuple_element_t<2, layers_t>;
+    const typename model::input_type input{1, -2, 3};
+    const typename model::delta_type delta{1, -1};
+
+    // tanh must not overwrite the output sigmoid back propagates from
+    static_assert(std::tuple_size_v<
+        decltype(typename activations_t::arena_type{}.activations)> == 2);
+    static_assert(std::tuple_size_v<
+        decltype(typename model::arena_type{}.activations)> == 3);
+
+    should("match the activations chained by hand") = [&]<class Policy>() {
+      activations_t target{};
+      const typename activations_t::input_type x{0.5, -1};
+      const auto y1 = sigmoid_t::forward(x);
+      const auto y2 = tanh_t::forward(y1);
+      expect(near(target.template forward<Policy{}>(x), y2));
+
+      typename activations_t::gradient_type gradient{};
+      expect(near(target.template backward<Policy{}>(delta, gradient),
+          sigmoid_t::backward_output(y1, tanh_t::backward_output(y2, delta))));
+    } | policies;
+
+    should("match the layers chained by hand") = [&]<class Policy>() {
+      model target{make_test_layer<dense_t>(), sigmoid_t{}, tanh_t{}};
+      const auto& dense = std::get<0>(target.layers());
+
+      const auto y1 = sigmoid_t::forward(dense.forward(input));
+      const auto y2 = tanh_t::forward(y1);
+      expect(near(target.template forward<Policy{}>(input), y2));
+
+      const auto d1 =
+          sigmoid_t::backward_output(y1, tanh_t::backward_output(y2, delta));
+      typename model::gradient_type expected{};
+      dense_t::calc_gradient(input, d1, std::get<0>(expected));
+
+      typename model::gradient_type gradient{};
+      expect(near(target.template backward<Policy{}>(delta, gradient),
+          dense.backward(d1)));
+      expect(near(gradient, expected));
+    } | policies;
+  } | std::pair<float, double>{};
+
+  "update"_test = [&]<class RealType>() {
+    using model = model_t<RealType>;
+    using layers_t = typename model::layers_type;
+    const typename model::input_type input{1, -2, 3, -4};
+    const typename model::delta_type delta{1, -1};
+
+    should("update every trainable layer") = [&]<class Policy>() {
+      auto target = make_test_model<model>();
+      typename model::gradient_type gradient{};
+      target.template forward<Policy{}>(input);
+      target.template backward<Policy{}>(delta, gradient);
+
+      auto dense1 = std::get<0>(target.layers());
+      auto dense2 = std::get<3>(target.layers());
+      typename std::tuple_element_t<0, layers_t>::template
+          optimizer_type<optimizer_t> optimizer1{};
+      typename std::tuple_element_t<3, layers_t>::template
+          optimizer_type<optimizer_t> optimizer2{};
+      dense1.update(optimizer1, std::get<0>(gradient));
+      dense2.update(optimizer2, std::get<3>(gradient));
+
+      typename model::template optimizer_type<optimizer_t> optimizer{};
+      target.template update<Policy{}>(optimizer, gradient);
+      expect(std::get<0>(target.layers()).value() == dense1.value());
+      expect(std::get<3>(target.layers()).value() == dense2.value());
+    } | policies;
+
+    should("accept a buffer optimizer") = [&]<class Policy>() {
+      auto target = make_test_model<model>();
+      typename model::gradient_type gradient{};
+      target.template forward<Policy{}>(input);
+      target.template backward<Policy{}>(delta, gradient);
+
+      auto dense1 = std::get<0>(target.layers());
+      typename std::tuple_element_t<0, layers_t>::template
+          optimizer_type<fused_adam<>> optimizer1{};
+      dense1.update(optimizer1, std::get<0>(gradient));
+
+      typename model::template optimizer_type<fused_adam<>> optimizer{};
+      static_assert(std::same_as<std::tuple_element_t<1,
+          std::remove_cvref_t<decltype(optimizer)>>, std::tuple<>>);
+      target.template update<Policy{}>(optimizer, gradient);
+      expect(std::get<0>(target.layers()).value() == dense1.value());
+    } | policies;
+  } | std::pair<float, double>{};
+}
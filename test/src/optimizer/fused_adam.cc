@@ -0,0 +1,184 @@
+#include "ami/optimizer/fused_adam.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <concepts>
+#include <cstddef>
+#include <execution>
+#include <limits>
+#include <span>
+#include <tuple>
+
+#include <boost/ut.hpp>
+
+#include "ami/concepts/optimizer.hpp"
+#include "ami/optimizer/adam.hpp"
+
+int main() {
+  using namespace boost::ut;
+  using namespace ami;
+  using namespace std::execution;
+
+  constexpr std::tuple policies{
+      seq, par, par_unseq, unseq, ami::execution::adaptive,
+      ami::execution::pool};
+
+  "concept"_test = [] {
+    static_assert(buffer_optimizer<fused_adam_t<float, 3>>);
+    static_assert(buffer_optimizer<fused_adam_t<double, 3>>);
+    static_assert(buffer_optimizer_family<fused_adam<>>);
+    static_assert(!optimizer<fused_adam_t<float, 3>>);
+    static_assert(!buffer_optimizer<adam_t<float>>);
+    static_assert(lazy_optimizer<fused_adam_t<float, 3>>);
+    static_assert(lazy_optimizer<fused_adam_t<double, 3>>);
+  };
+
+  "fused_adam"_test = [&]<std::floating_point RealType> {
+    constexpr std::size_t first_size = 5000;
+    constexpr std::size_t second_size = 37;
+    constexpr auto size = first_size + second_size;
+    using optimizer_t = fused_adam_t<RealType, size>;
+    using tensor_t = typename optimizer_t::tensor_type;
+
+    should("match per scalar adam over several tensors") =
+        [&]<class Policy> {
+          std::array<RealType, first_size> first{};
+          std::array<RealType, second_size> second{};
+          std::array<RealType, size> gradient{};
+          for (std::size_t i = 0; i < size; ++i) {
+            gradient[i] = static_cast<RealType>(i % 7) - RealType{3};
+          }
+
+          std::array<RealType, size> expected{};
+          std::array<adam_t<RealType>, size> reference{};
+          optimizer_t target{};
+          for (std::size_t step = 0; step < 3; ++step) {
+            for (std::size_t i = 0; i < size; ++i) {
+              reference[i](expected[i], gradient[i]);
+            }
+            const std::array tensors{
+                tensor_t{first, std::span{gradient}.first(first_size)},
+                tensor_t{second, std::span{gradient}.last(second_size)}};
+            target.template operator()<Policy{}>(tensors);
+          }
+
+          constexpr auto eps = std::numeric_limits<RealType>::epsilon();
+          for (std::size_t i = 0; i < size; ++i) {
+            const auto actual =
+                (i < first_size) ? first[i] : second[i - first_size];
+            expect(le(std::abs(actual - expected[i]),
+                16 * eps * std::abs(expected[i])));
+          }
+        } | policies;
+  } | std::tuple<float, double>{};
+
+  "lazy step"_test = []<std::floating_point RealType> {
+    constexpr std::size_t size = 40;
+    using optimizer_t = fused_adam_t<RealType, size>;
+    using update_t = typename optimizer_t::lazy_update_type;
+
+    std::array<RealType, size> gradient{};
+    for (std::size_t i = 0; i < size; ++i) {
+      gradient[i] = static_cast<RealType>(i % 7) - RealType{3};
+    }
+
+    should("match a full step when every parameter is touched") = [&] {
+      std::array<RealType, size> expected{};
+      std::array<RealType, size> actual{};
+      optimizer_t reference{};
+      optimizer_t target{};
+      for (std::size_t step = 0; step < 3; ++step) {
+        reference(std::span{expected}, std::span<const RealType, size>{
+            gradient});
+        // A run and single parameters.
+        target.step([&](const update_t& update) {
+              update(0, std::span{actual}.first(size - 5),
+                  std::span{gradient}.first(size - 5));
+              for (auto i = size - 5; i < size; ++i) {
+                update(i, actual[i], gradient[i]);
+              }
+            });
+      }
+      // Exact, as the kernel's scalar tail fuses like its vector body.
+      expect(actual == expected);
+      expect(std::ranges::equal(target.m(), reference.m()));
+      expect(std::ranges::equal(target.v(), reference.v()));
+    };
+
+    should("leave untouched parameters and moments alone") = [&] {
+      std::array<RealType, size> weight{};
+      optimizer_t target{};
+      target(std::span{weight}, std::span<const RealType, size>{gradient});
+      const auto first = weight;
+      std::array<RealType, size> m{};
+      std::array<RealType, size> v{};
+      std::ranges::copy(target.m(), m.begin());
+      std::ranges::copy(target.v(), v.begin());
+
+      target.step([&](const update_t& update) {
+            update(3, weight[3], gradient[3]);
+          });
+      for (std::size_t i = 0; i < size; ++i) {
+        if (i != 3) {
+          expect(eq(weight[i], first[i]));
+          expect(eq(target.m()[i], m[i]));
+          expect(eq(target.v()[i], v[i]));
+        }
+      }
+
+      // The step count is global: a step touching nothing still counts,
+      // and the fourth step corrects by beta^4.
+      target.step([](const update_t&) {});
+      constexpr RealType beta1{0.9};
+      constexpr RealType beta2{0.999};
+      const auto m3 = target.m()[3] * beta1 + (1 - beta1) * gradient[3];
+      const auto v3 = target.v()[3] * beta2 +
+          (1 - beta2) * gradient[3] * gradient[3];
+      const auto b1 = beta1 * beta1 * beta1 * beta1;
+      const auto b2 = beta2 * beta2 * beta2 * beta2;
+      auto expected = weight[3];
+      expected -= RealType{0.001} * (m3 / (1 - b1)) /
+          (std::sqrt(v3 / (1 - b2)) + RealType{1e-7});
+      target.step([&](const update_t& update) {
+            update(3, weight[3], gradient[3]);
+          });
+      expect(le(std::abs(weight[3] - expected),
+          16 * std::numeric_limits<RealType>::epsilon() *
+              std::abs(expected)));
+    };
+  } | std::tuple<float, double>{};
+
+  "dynamic extent"_test = [&]<std::floating_point RealType> {
+    constexpr std::size_t size = 1000;
+    using optimizer_t = fused_adam_t<RealType, std::dynamic_extent>;
+    static_assert(lazy_optimizer<optimizer_t>);
+    static_assert(optimizer_t::size == std::dynamic_extent);
+
+    std::array<RealType, size> gradient{};
+    for (std::size_t i = 0; i < size; ++i) {
+      gradient[i] = static_cast<RealType>(i % 7) - RealType{3};
+    }
+
+    should("match a fixed size buffer") = [&]<class Policy> {
+      std::array<RealType, size> expected{};
+      std::array<RealType, size> actual{};
+      fused_adam_t<RealType, size> reference{};
+      optimizer_t target{size};
+      expect(eq(target.m().size(), size));
+      for (std::size_t step = 0; step < 3; ++step) {
+        reference.template operator()<Policy{}>(
+            std::span{expected}, std::span<const RealType, size>{gradient});
+        target.template operator()<Policy{}>(
+            std::span{actual}, std::span<const RealType>{gradient});
+      }
+      expect(actual == expected);
+      expect(std::ranges::equal(target.v(), reference.v()));
+    } | policies;
+  } | std::tuple<float, double>{};
+
+  "memory"_test = [] {
+    static_assert(sizeof(fused_adam_t<float, 1024>) <
+        sizeof(adam_t<float>) * 1024 / 2 + 128);
+  };
+}
@@ -0,0 +1,64 @@
+#include "ami/optimizer/loss_scaler.hpp"
+
+#include <array>
+#include <limits>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include <boost/ut.hpp>
+
+int main() {
+  using namespace boost::ut;
+
+  "unscale"_test = [] {
+    ami::loss_scaler<float> scaler{8.0f};
+    expect(eq(scaler.scale(), 8.0f));
+
+    // A model gradient: a dense layer's pair, a stateless layer's empty
+    // tuple and a plain vector.
+    std::tuple<std::pair<std::array<std::array<float, 3>, 2>,
+                         std::array<float, 2>>,
+               std::tuple<>, std::vector<float>>
+        gradient{{{{{8, 16, 24}, {-8, 0, 4}}}, {2, 4}}, {}, {32, 64}};
+    expect(scaler.unscale(gradient));
+    const auto& [dense, empty, rest] = gradient;
+    expect(dense.first[0] == std::array{1.0f, 2.0f, 3.0f});
+    expect(dense.first[1] == std::array{-1.0f, 0.0f, 0.5f});
+    expect(dense.second == std::array{0.25f, 0.5f});
+    expect(rest == std::vector{4.0f, 8.0f});
+
+    std::array<float, 3> overflow{1, std::numeric_limits<float>::infinity(),
+                                  2};
+    expect(!scaler.unscale(overflow));
+    expect(eq(overflow[2], 0.25f));
+    std::vector<float> nan{std::numeric_limits<float>::quiet_NaN()};
+    expect(!scaler.unscale(nan));
+  };
+
+  "update"_test = [] {
+    ami::loss_scaler<double, 3> scaler{};
+    expect(eq(scaler.scale(), 65536.0));
+
+    scaler.update(false);
+    expect(eq(scaler.scale(), 32768.0));
+
+    scaler.update(true);
+    scaler.update(true);
+    expect(eq(scaler.scale(), 32768.0));
+    scaler.update(true);
+    expect(eq(scaler.scale(), 65536.0));
+
+    // An overflow restarts the count of finite steps.
+    scaler.update(true);
+    scaler.update(true);
+    scaler.update(false);
+    scaler.update(true);
+    scaler.update(true);
+    expect(eq(scaler.scale(), 32768.0));
+
+    ami::loss_scaler<float> small{1.0f};
+    small.update(false);
+    expect(eq(small.scale(), 1.0f));
+  };
+}
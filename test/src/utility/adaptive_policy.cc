@@ -0,0 +1,46 @@
+#include "ami/utility/adaptive_policy.hpp"
+
+#include <cstddef>
+#include <execution>
+#include <tuple>
+#include <type_traits>
+
+#include <boost/ut.hpp>
+
+int main() {
+  using namespace boost::ut;
+  using namespace ami::utility;
+  using namespace std::execution;
+
+  "parallel_threshold"_test = [] {
+    expect(ami::execution::parallel_threshold() > std::size_t{0});
+  };
+
+  "resolve"_test = [] {
+    should("pass concrete policies through") = []<class Policy> {
+      const auto result = resolve<Policy{}>(std::size_t{1},
+          []<ami::execution_policy auto Q> { return Q; });
+      static_assert(std::same_as<std::remove_cvref_t<decltype(result)>,
+          std::remove_cvref_t<Policy>>);
+    } | std::tuple{seq, par, par_unseq, unseq};
+
+    should("pick by work") = [] {
+      ami::execution::set_parallel_threshold(1000);
+
+      expect(resolve<ami::execution::adaptive>(std::size_t{1},
+          []<ami::execution_policy auto Q> {
+            return ami::sequenced_policy<Q>;
+          }));
+      expect(resolve<ami::execution::adaptive>(std::size_t{100},
+          []<ami::execution_policy auto Q> {
+            return ami::unsequenced_policy<Q>;
+          }));
+      expect(resolve<ami::execution::adaptive>(std::size_t{1000},
+          []<ami::execution_policy auto Q> {
+            return std::same_as<std::remove_cvref_t<decltype(Q)>,
+                parallel_policy>;
+          }));
+      expect(eq(ami::execution::parallel_threshold(), std::size_t{1000}));
+    };
+  };
+}
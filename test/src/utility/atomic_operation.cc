@@ -11,7 +11,9 @@ int main() {
   using namespace ami::utility;
   using namespace std::execution;
 
-  constexpr std::tuple policies{seq, par, par_unseq, unseq};
+  constexpr std::tuple policies{
+      seq, par, par_unseq, unseq, ami::execution::adaptive,
+      ami::execution::pool};
 
   "fetch_add"_test = [&]<std::floating_point RealType> {
     should("same result on each execution policy") = [&]<class Policy> {
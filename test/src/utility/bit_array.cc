@@ -0,0 +1,41 @@
+#include "ami/utility/bit_array.hpp"
+
+#include <cstddef>
+
+#include <boost/ut.hpp>
+
+int main() {
+  using namespace boost::ut;
+  using ami::utility::bit_array;
+
+  "size"_test = [] {
+    static_assert(bit_array<1>::word_count == 1);
+    static_assert(bit_array<64>::word_count == 1);
+    static_assert(bit_array<65>::word_count == 2);
+    static_assert(sizeof(bit_array<128>) == 16);
+    static_assert(bit_array<100>::size() == 100);
+  };
+
+  "set"_test = [] {
+    constexpr auto bits = [] {
+      bit_array<130> bits{};
+      bits.set(0, true);
+      bits.set(64, true);
+      bits.set(129, true);
+      bits.set(64, false);
+      return bits;
+    }();
+    static_assert(bits[0] && !bits[64] && bits[129] && !bits[1]);
+    static_assert(bits.count() == 2);
+    expect(eq(bits.words()[2], std::uint64_t{2}));
+  };
+
+  "equality"_test = [] {
+    bit_array<10> a{};
+    bit_array<10> b{};
+    a.set(3, true);
+    expect(a != b);
+    b.set(3, true);
+    expect(a == b);
+  };
+}
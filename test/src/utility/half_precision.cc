@@ -0,0 +1,110 @@
+#include "ami/utility/half_precision.hpp"
+
+#include <bit>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <tuple>
+#include <type_traits>
+
+#include <boost/ut.hpp>
+
+// Every value of T survives widening to float and narrowing back.
+template <class T>
+constexpr bool round_trips() {
+  for (std::uint32_t bits = 0; bits <= 0xffff; ++bits) {
+    const auto value = T::from_bits(static_cast<std::uint16_t>(bits));
+    const float wide = value;
+    if (wide != wide) {
+      if (T{wide} == T{wide}) {
+        return false;
+      }
+    } else if (T{wide}.bits() != bits) {
+      return false;
+    }
+  }
+  return true;
+}
+
+template <class T>
+constexpr std::uint16_t bits_of(float value) {
+  return T{value}.bits();
+}
+
+int main() {
+  using namespace boost::ut;
+  using ami::bfloat16;
+  using ami::float16;
+
+  "traits"_test = [] {
+    static_assert(sizeof(bfloat16) == 2 && sizeof(float16) == 2);
+    static_assert(std::is_trivial_v<bfloat16> && std::is_trivial_v<float16>);
+    static_assert(ami::half_precision<bfloat16>);
+    static_assert(!ami::half_precision<float>);
+    static_assert(ami::real_storage<float16> && ami::real_storage<double>);
+    static_assert(!std::is_convertible_v<float, bfloat16>);
+    static_assert(std::is_convertible_v<bfloat16, float>);
+  };
+
+  "round trip"_test = [] {
+    static_assert(round_trips<bfloat16>());
+    static_assert(round_trips<float16>());
+  };
+
+  // Each case is checked at compile time, which takes the software path,
+  // and at run time, which uses F16C where the target has it.
+  "bfloat16"_test = [] {
+    constexpr float inf = std::numeric_limits<float>::infinity();
+    constexpr std::tuple<float, std::uint16_t> cases[] = {
+        {1.0f, 0x3f80}, {-2.0f, 0xc000}, {0.0f, 0x0000}, {-0.0f, 0x8000},
+        // Ties round to even.
+        {1.0f + 0x1p-8f, 0x3f80}, {1.0f + 0x3p-8f, 0x3f82},
+        {1.0f + 0x1p-8f + 0x1p-20f, 0x3f81},
+        {inf, 0x7f80}, {-inf, 0xff80},
+        {std::numeric_limits<float>::max(), 0x7f80},
+        {std::numeric_limits<float>::denorm_min(), 0x0000}};
+    static_assert(bits_of<bfloat16>(1.0f + 0x3p-8f) == 0x3f82);
+    for (const auto& [value, bits] : cases) {
+      expect(eq(bits_of<bfloat16>(value), bits)) << value;
+    }
+    expect(eq(static_cast<float>(bfloat16::from_bits(0x3f81)),
+        1.0f + 0x1p-7f));
+    expect(eq(static_cast<float>(bfloat16::from_bits(0xff80)), -inf));
+
+    const bfloat16 nan{std::numeric_limits<float>::quiet_NaN()};
+    expect(std::isnan(static_cast<float>(nan)));
+    // A NaN whose payload sits in the dropped bits stays NaN.
+    const bfloat16 low_nan{std::bit_cast<float>(0x7f800001u)};
+    expect(std::isnan(static_cast<float>(low_nan)));
+    static_assert(bits_of<bfloat16>(std::bit_cast<float>(0x7f800001u)) ==
+        0x7fc0);
+  };
+
+  "float16"_test = [] {
+    constexpr float inf = std::numeric_limits<float>::infinity();
+    constexpr std::tuple<float, std::uint16_t> cases[] = {
+        {1.0f, 0x3c00}, {-2.0f, 0xc000}, {0.0f, 0x0000}, {-0.0f, 0x8000},
+        {65504.0f, 0x7bff}, {65519.0f, 0x7bff}, {65520.0f, 0x7c00},
+        {-1e9f, 0xfc00}, {inf, 0x7c00},
+        {0x1p-14f, 0x0400}, {0x1p-24f, 0x0001}, {-0x1p-24f, 0x8001},
+        {0x1p-25f, 0x0000}, {0x3p-26f, 0x0001}, {0x3p-25f, 0x0002},
+        {1.0f + 0x1p-11f, 0x3c00}, {1.0f + 0x3p-11f, 0x3c02},
+        {0.1f, 0x2e66}};
+    static_assert(bits_of<float16>(0x3p-26f) == 0x0001);
+    static_assert(bits_of<float16>(65520.0f) == 0x7c00);
+    static_assert(bits_of<float16>(0.1f) == 0x2e66);
+    static_assert(float{float16::from_bits(0x0001)} == 0x1p-24f);
+    static_assert(float{float16::from_bits(0x7bff)} == 65504.0f);
+    for (const auto& [value, bits] : cases) {
+      expect(eq(bits_of<float16>(value), bits)) << value;
+    }
+    for (const auto bits : {0x3c00, 0x0001, 0x8001, 0x03ff, 0x7bff, 0xfc00}) {
+      const auto value = float16::from_bits(static_cast<std::uint16_t>(bits));
+      expect(eq(bits_of<float16>(value), bits));
+    }
+
+    expect(std::isnan(static_cast<float>(
+        float16{std::numeric_limits<float>::quiet_NaN()})));
+    expect(std::isnan(static_cast<float>(float16::from_bits(0x7e00))));
+  };
+}
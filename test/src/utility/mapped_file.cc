@@ -0,0 +1,58 @@
+#include "ami/utility/mapped_file.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <system_error>
+#include <utility>
+
+#include <boost/ut.hpp>
+
+int main() {
+  using namespace boost::ut;
+  using ami::utility::mapped_file;
+
+  const auto path =
+      std::filesystem::temp_directory_path() / "ami_mapped_file_test.bin";
+
+  "bytes"_test = [&] {
+    const std::string content = "mapped file contents";
+    std::ofstream{path, std::ios::binary} << content;
+
+    const mapped_file file{path};
+    expect(eq(file.size(), content.size()));
+    expect(eq(reinterpret_cast<std::uintptr_t>(file.data()) % 64,
+        std::uintptr_t{}));
+    expect(eq(std::string(reinterpret_cast<const char*>(file.data()),
+        file.size()), content));
+  };
+
+  "empty"_test = [&] {
+    std::ofstream{path, std::ios::binary};
+    const mapped_file file{path};
+    expect(eq(file.size(), std::size_t{}));
+    expect(file.bytes().empty());
+  };
+
+  "move"_test = [&] {
+    std::ofstream{path, std::ios::binary} << "abc";
+    mapped_file file{path};
+    const auto* data = file.data();
+
+    mapped_file other{std::move(file)};
+    expect(other.data() == data);
+    expect(eq(other.size(), std::size_t{3}));
+    expect(file.data() == nullptr);
+    expect(eq(file.size(), std::size_t{}));
+
+    file = std::move(other);
+    expect(file.data() == data);
+  };
+
+  "missing"_test = [&] {
+    std::filesystem::remove(path);
+    expect(throws<std::system_error>([&] { mapped_file{path}; }));
+  };
+}
@@ -1,6 +1,8 @@
 #include "ami/utility/parallel_algorithm.hpp"
 
 #include <array>
+#include <atomic>
+#include <cstddef>
 #include <execution>
 #include <utility>
 #include <tuple>
@@ -12,7 +14,9 @@ int main() {
   using namespace ami::utility;
   using namespace std::execution;
 
-  constexpr std::tuple policies{seq, par, par_unseq, unseq};
+  constexpr std::tuple policies{
+      seq, par, par_unseq, unseq, ami::execution::adaptive,
+      ami::execution::pool};
 
   constexpr std::pair<std::array<int, 1>, std::array<int, 2>>
       test_src{{-1}, {0, 2}};
@@ -48,4 +52,78 @@ int main() {
       }();
     } | policies;
   };
+
+  "adaptive"_test = [&] {
+    should("same result on either side of the threshold") = [&] {
+      std::array<int, 64> src{};
+      for (int i = 0; i < 64; ++i) {
+        src[i] = i;
+      }
+
+      for (const std::size_t threshold : {std::size_t{1}, std::size_t{1000}}) {
+        ami::execution::set_parallel_threshold(threshold);
+
+        std::array<int, 64> out{};
+        transform<ami::execution::adaptive>(src, out.begin(),
+            [](auto i) { return i + 1; });
+        expect(eq(out.front(), 1) and eq(out.back(), 64));
+
+        expect(eq(transform_reduce<ami::execution::adaptive>(
+            src, src, int{0}), 85344));
+      }
+    };
+  };
+
+  "nested"_test = [&] {
+    should("run inner levels inside the parallel region") = [&]<class Policy> {
+      expect(not in_parallel_region());
+
+      constexpr bool parallel = !ami::sequenced_policy<Policy{}> &&
+                                !ami::unsequenced_policy<Policy{}> &&
+                                !ami::adaptive_policy<Policy{}>;
+      std::array<std::array<int, 64>, 16> out{};
+      std::atomic<bool> nested{true};
+      for_each<Policy{}>(out, [&](auto& row) {
+            if (parallel && !in_parallel_region()) {
+              nested = false;
+            }
+            transform<Policy{}>(row, row.begin(), [](int) { return 1; });
+          });
+      expect(nested.load());
+      expect(not in_parallel_region());
+
+      for (const auto& row : out) {
+        for (auto v : row) {
+          expect(eq(v, 1));
+        }
+      }
+    } | policies;
+  };
+
+  "for_each_tile"_test = [&] {
+    should("visit every cell once") = [&]<class Policy> {
+      constexpr std::size_t rows = 37;
+      constexpr std::size_t cols = 53;
+      std::array<std::array<int, cols>, rows> visits{};
+      std::atomic<bool> within{true};
+      for_each_tile<Policy{}>(rows, cols, tile{8, 16},
+          [&](auto row_begin, auto row_end, auto col_begin, auto col_end) {
+            if (row_end - row_begin > 8 || col_end - col_begin > 16) {
+              within = false;
+            }
+            for (auto i = row_begin; i < row_end; ++i) {
+              for (auto j = col_begin; j < col_end; ++j) {
+                ++visits[i][j];
+              }
+            }
+          });
+      expect(within.load());
+
+      for (const auto& row : visits) {
+        for (auto v : row) {
+          expect(eq(v, 1));
+        }
+      }
+    } | policies;
+  };
 }
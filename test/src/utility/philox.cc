@@ -0,0 +1,65 @@
+#include "ami/utility/philox.hpp"
+
+#include <cstdint>
+#include <random>
+
+#include <boost/ut.hpp>
+
+int main() {
+  using namespace boost::ut;
+  using ami::utility::philox;
+
+  "uniform_random_bit_generator"_test = [] {
+    static_assert(std::uniform_random_bit_generator<philox>);
+  };
+
+  // Known answers of Philox4x32-10 from the Random123 distribution.
+  "block"_test = [] {
+    static_assert(philox{}.block(0) == philox::block_type{
+        0x6627e8d5, 0xe169c58d, 0xbc57ac4c, 0x9b00dbd8});
+    expect(philox{~std::uint64_t{}, ~std::uint64_t{}}.block(~std::uint64_t{}) ==
+        philox::block_type{0x408f276d, 0x41c83b0e, 0xa20bc7c6, 0x6d5451fd});
+    expect(philox{0x299f31d0a4093822, 0x0370734413198a2e}.block(
+               0x85a308d3243f6a88) ==
+        philox::block_type{0xd16cfe09, 0x94fdcceb, 0x5001e420, 0x24126ea1});
+  };
+
+  "operator()"_test = [] {
+    should("read the blocks in order") = [] {
+      philox engine{42, 3};
+      for (std::uint64_t n = 0; n < 4; ++n) {
+        for (const auto word : engine.block(n)) {
+          expect(eq(engine(), word));
+        }
+      }
+    };
+
+    should("skip like discard") = [] {
+      for (unsigned long long n = 0; n < 12; ++n) {
+        philox engine{7};
+        philox reference{7};
+        engine();
+        reference();
+        engine.discard(n);
+        for (unsigned long long i = 0; i < n; ++i) {
+          reference();
+        }
+        for (int i = 0; i < 6; ++i) {
+          expect(eq(engine(), reference()));
+        }
+      }
+    };
+  };
+
+  "reserve"_test = [] {
+    philox engine{1};
+    engine();
+    expect(eq(engine.reserve(5), std::uint64_t{1}));
+    expect(eq(engine(), engine.block(6)[0]));
+  };
+
+  "streams"_test = [] {
+    expect(philox{1, 0}.block(0) != philox{1, 1}.block(0));
+    expect(philox{1, 0}.block(0) != philox{2, 0}.block(0));
+  };
+}
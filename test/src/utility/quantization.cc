@@ -0,0 +1,89 @@
+#include "ami/utility/quantization.hpp"
+
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <tuple>
+
+#include <boost/ut.hpp>
+
+int main() {
+  using namespace boost::ut;
+  using ami::quantization;
+
+  "from_range"_test = []<class RealType> {
+    using q_t = quantization<RealType>;
+
+    should("map the range onto the integers") = [] {
+      constexpr auto q = q_t::template from_range<std::uint8_t>(
+          RealType{-1}, RealType{3});
+      expect(eq(q.scale, RealType{4} / 255));
+      expect(eq(q.template quantize<std::uint8_t>(RealType{-1}), 0));
+      expect(eq(q.template quantize<std::uint8_t>(RealType{3}), 255));
+      expect(eq(q.dequantize(q.zero_point), RealType{}));
+    };
+
+    should("keep zero exact") = [] {
+      constexpr auto u = q_t::template from_range<std::uint8_t>(
+          RealType{2}, RealType{5});
+      expect(eq(u.zero_point, 0));
+      expect(eq(u.template quantize<std::uint8_t>(RealType{5}), 255));
+
+      constexpr auto s = q_t::template from_range<std::int8_t>(
+          RealType{-5}, RealType{-2});
+      expect(eq(s.zero_point, 127));
+      expect(eq(s.template quantize<std::int8_t>(RealType{-5}), -128));
+      expect(eq(s.template quantize<std::int8_t>(RealType{}), 127));
+    };
+
+    should("give a unit scale to a point") = [] {
+      constexpr auto q = q_t::template from_range<std::int8_t>(
+          RealType{}, RealType{});
+      expect(eq(q.scale, RealType{1}));
+      expect(eq(q.zero_point, 0));
+    };
+
+    should("round to nearest within half a step") = [] {
+      constexpr auto q = q_t::template from_range<std::int8_t>(
+          RealType{-0.75}, RealType{2});
+      for (int i = -192; i <= 512; ++i) {
+        const auto x = static_cast<RealType>(i) / 256;
+        const auto y = q.dequantize(q.template quantize<std::int8_t>(x));
+        expect(le(std::abs(x - y), q.scale * RealType{0.501})) << x;
+      }
+    };
+
+    should("saturate") = [] {
+      constexpr auto q = q_t::template from_range<std::uint8_t>(
+          RealType{-1}, RealType{1});
+      expect(eq(q.template quantize<std::uint8_t>(RealType{100}), 255));
+      expect(eq(q.template quantize<std::uint8_t>(RealType{-100}), 0));
+      expect(eq(q.template quantize<std::uint8_t>(
+          std::numeric_limits<RealType>::infinity()), 255));
+      expect(eq(q.template quantize<std::uint8_t>(
+          std::numeric_limits<RealType>::quiet_NaN()), 0));
+    };
+  } | std::tuple<float, double>{};
+
+  "range_calibrator"_test = [] {
+    ami::range_calibrator<float> calibrator;
+    expect(calibrator.empty());
+    expect(eq(calibrator.make_quantization().scale, 1.0f));
+
+    calibrator.observe(std::array{0.5f, 2.0f});
+    calibrator.observe(std::array{-1.0f, 1.0f});
+    expect(!calibrator.empty());
+    expect(eq(calibrator.min(), -1.0f));
+    expect(eq(calibrator.max(), 2.0f));
+
+    const auto q = calibrator.make_quantization();
+    const auto expected = quantization<float>::from_range<std::uint8_t>(
+        -1.0f, 2.0f);
+    expect(eq(q.scale, expected.scale));
+    expect(eq(q.zero_point, expected.zero_point));
+    expect(eq(calibrator.make_quantization<std::int8_t>().zero_point,
+        quantization<float>::from_range<std::int8_t>(
+            -1.0f, 2.0f).zero_point));
+  };
+}
@@ -0,0 +1,83 @@
+#include "ami/utility/thread_pool.hpp"
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <vector>
+
+#include <boost/ut.hpp>
+
+#include "ami/utility/parallel_algorithm.hpp"
+
+namespace {
+
+  ami::utility::thread_pool pool{3, ami::utility::affinity::core};
+}
+
+int main() {
+  using namespace boost::ut;
+  using namespace ami::utility;
+
+  "size"_test = [] {
+    expect(eq(pool.size(), std::size_t{3}));
+    expect(eq(thread_pool{0}.size(), std::size_t{0}));
+  };
+
+  "parallel_for"_test = [] {
+    should("visit every index once within the grain") = [] {
+      constexpr std::array<std::size_t, 4> sizes{1, 7, 100, 4097};
+      constexpr std::array<std::size_t, 4> grains{0, 1, 16, 5000};
+
+      for (const auto n : sizes) {
+        for (const auto grain : grains) {
+          std::vector<std::atomic<int>> visits(n);
+          std::atomic<bool> within{true};
+          pool.parallel_for(n, grain, [&](auto begin, auto end) {
+                if (grain != 0 && end - begin > grain) {
+                  within = false;
+                }
+                for (auto i = begin; i < end; ++i) {
+                  ++visits[i];
+                }
+              });
+
+          expect(within.load());
+          for (const auto& v : visits) {
+            expect(eq(v.load(), 1));
+          }
+        }
+      }
+    };
+
+    should("not block when nested") = [] {
+      std::atomic<std::size_t> count{};
+      pool.parallel_for(16, 1, [&](std::size_t, std::size_t) {
+            pool.parallel_for(64, 4, [&](std::size_t begin, std::size_t end) {
+                  count += end - begin;
+                });
+          });
+      expect(eq(count.load(), std::size_t{1024}));
+    };
+
+    should("run on the caller without workers") = [] {
+      thread_pool empty{0};
+      std::size_t count{};
+      empty.parallel_for(100, 10, [&](std::size_t begin, std::size_t end) {
+            count += end - begin;
+          });
+      expect(eq(count, std::size_t{100}));
+    };
+  };
+
+  "pool_policy"_test = [] {
+    constexpr ami::execution::pool_policy policy{&pool, 8};
+
+    std::vector<int> values(1000);
+    for_each<policy>(values, [](int& v) { v = 2; });
+    expect(eq(transform_reduce<policy>(values, values, 0), 4000));
+
+    std::vector<int> result(1000);
+    transform<policy>(values, result.begin(), [](int v) { return v + 1; });
+    expect(eq(result.front(), 3) and eq(result.back(), 3));
+  };
+}